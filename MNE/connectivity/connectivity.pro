@@ -37,6 +37,7 @@ include(../../mne-cpp.pri)
 
 TEMPLATE = lib
 
+QT += concurrent
 QT -= gui
 
 DEFINES += CONNECTIVITY_LIBRARY
@@ -52,6 +52,8 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -91,70 +93,142 @@ ConnectivityMeasures::ConnectivityMeasures()
 
 Network::SPtr ConnectivityMeasures::pearsonsCorrelationCoeff(const MatrixXd& matData, const MatrixX3f& matVert)
 {
-    Network::SPtr finalNetwork = Network::SPtr(new Network("Pearson's Correlation Coefficient"));
+    return createNetwork(calcPearsonsCorrelationCoeffMatrix(matData), matVert, "Pearson's Correlation Coefficient");
+}
 
-    //Create nodes
-    for(int i = 0; i < matData.rows(); ++i) {
-        RowVectorXf rowVert = RowVectorXf::Zero(3);
 
-        if(matVert.rows() != 0 && i < matVert.rows()) {
-            rowVert(0) = matVert.row(i)(0);
-            rowVert(1) = matVert.row(i)(1);
-            rowVert(2) = matVert.row(i)(2);
-        }
+//*************************************************************************************************************
 
-        *finalNetwork << NetworkNode::SPtr(new NetworkNode(i, rowVert));
-    }
+Network::SPtr ConnectivityMeasures::crossCorrelation(const MatrixXd& matData, const MatrixX3f& matVert)
+{
+//    finalNetwork.scale();
+//    matDist /= matDist.maxCoeff();
 
-    //Create edges
-    for(int i = 0; i < matData.rows(); ++i) {
-        for(int j = i; j < matData.rows(); ++j) {
-            double pearsonsCoeff = calcPearsonsCorrelationCoeff(matData.row(i), matData.row(j));
+    return createNetwork(calcCrossCorrelationMatrix(matData), matVert, "Cross Correlation");
+}
 
-            QSharedPointer<NetworkEdge> pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(finalNetwork->getNodes()[i], finalNetwork->getNodes()[j], pearsonsCoeff));
 
-            *finalNetwork->getNodes()[i] << pEdge;
-            *finalNetwork << pEdge;
-        }
+//*************************************************************************************************************
+
+MatrixXd ConnectivityMeasures::calcPearsonsCorrelationCoeffMatrix(const MatrixXd& matData)
+{
+    MatrixXd matCorr = MatrixXd::Zero(matData.rows(), matData.rows());
+
+    if(matData.cols() == 0) {
+        return matCorr;
     }
 
-    return finalNetwork;
+    matCorr.selfadjointView<Lower>().rankUpdate(matData, 1.0/matData.cols());
+    matCorr.triangularView<StrictlyUpper>() = matCorr.transpose();
+
+    return matCorr;
 }
 
 
 //*************************************************************************************************************
 
-Network::SPtr ConnectivityMeasures::crossCorrelation(const MatrixXd& matData, const MatrixX3f& matVert)
+MatrixXd ConnectivityMeasures::calcCrossCorrelationMatrix(const MatrixXd& matData)
 {
-    Network::SPtr finalNetwork  = Network::SPtr(new Network("Cross Correlation"));
+    const int iNumRows = matData.rows();
+    const int N = matData.cols();
+
+    MatrixXd matResult = MatrixXd::Zero(iNumRows, iNumRows);
+
+    if(iNumRows == 0 || N == 0) {
+        return matResult;
+    }
+
+    //Compute the FFT size as the "next power of 2" of the input vector's length (max)
+    int b = ceil(log2(2.0 * N - 1));
+    int fftsize = pow(2,b);
 
-    //Create nodes
-    for(int i = 0; i < matData.rows(); ++i) {
-        RowVectorXf rowVert = RowVectorXf::Zero(3);
+    //The rows are real, so the half spectrum holds all information. Every row is transformed once.
+    Eigen::FFT<double> fft;
+    fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
 
-        if(matVert.rows() != 0 && i < matVert.rows()) {
-            rowVert(0) = matVert.row(i)(0);
-            rowVert(1) = matVert.row(i)(1);
-            rowVert(2) = matVert.row(i)(2);
+    MatrixXcd matSpectra(fftsize/2+1, iNumRows);
+    VectorXd vecInput = VectorXd::Zero(fftsize);
+    VectorXcd vecSpectrum;
+
+    for(int i = 0; i < iNumRows; ++i) {
+        vecInput.head(N) = matData.row(i).transpose();
+        fft.fwd(vecSpectrum, vecInput);
+        matSpectra.col(i) = vecSpectrum;
+    }
+
+    //Split the pairs into chunks of similar size, row i is paired with iNumRows-i rows
+    qint64 iNumPairs = (qint64)iNumRows * (iNumRows + 1) / 2;
+    int nChunks = qMax(1, qMin(iNumRows, 4*QThread::idealThreadCount()));
+    qint64 iPairsPerChunk = (iNumPairs + nChunks - 1) / nChunks;
+
+    QList<CrossCorrelationChunk> chunks;
+    int iFirst = 0;
+    qint64 iPairs = 0;
+    for(int i = 0; i < iNumRows; ++i) {
+        iPairs += iNumRows - i;
+        if(iPairs >= iPairsPerChunk || i == iNumRows - 1) {
+            CrossCorrelationChunk chunk;
+            chunk.pMatSpectra = &matSpectra;
+            chunk.pMatResult = &matResult;
+            chunk.iFftSize = fftsize;
+            chunk.iFirst = iFirst;
+            chunk.iLast = i + 1;
+            chunks.append(chunk);
+
+            iFirst = i + 1;
+            iPairs = 0;
         }
+    }
+
+    QList<bool> results = QtConcurrent::blockingMapped(chunks, &ConnectivityMeasures::calcCrossCorrelationChunk);
 
-        *finalNetwork << NetworkNode::SPtr(new NetworkNode(i, rowVert));
+    if(results.contains(false)) {
+        qDebug() << "ConnectivityMeasures::calcCrossCorrelationMatrix - Could not calculate all pairs!";
     }
 
-    //Create edges
-    for(int i = 0; i < matData.rows(); ++i) {
-        for(int j = i; j < matData.rows(); ++j) {
-            QPair<int,double> crossCorrPair = calcCrossCorrelation(matData.row(i), matData.row(j));
+    //Only the upper triangle was computed
+    matResult.triangularView<StrictlyLower>() = matResult.transpose();
+
+    return matResult;
+}
+
+
+//*************************************************************************************************************
+
+bool ConnectivityMeasures::calcCrossCorrelationChunk(const CrossCorrelationChunk &chunk)
+{
+    //Each worker needs its own FFT object
+    Eigen::FFT<double> fft;
+    fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+
+    const MatrixXcd& matSpectra = *chunk.pMatSpectra;
+    const int iNumRows = matSpectra.cols();
+
+    MatrixXcd matProducts;
+    VectorXd vecResult;
 
-            QSharedPointer<NetworkEdge> pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(finalNetwork->getNodes()[i], finalNetwork->getNodes()[j], crossCorrPair.second));
+    for(int i = chunk.iFirst; i < chunk.iLast; ++i) {
+        //All pairwise spectra of row i in one batched product
+        matProducts = matSpectra.rightCols(iNumRows - i).array().colwise() * matSpectra.col(i).array();
 
-            *finalNetwork->getNodes()[i] << pEdge;
-            *finalNetwork << pEdge;
+        for(int j = 0; j < matProducts.cols(); ++j) {
+            fft.inv(vecResult, matProducts.col(j), chunk.iFftSize);
+            (*chunk.pMatResult)(i, i + j) = vecResult.maxCoeff();
         }
     }
 
-//    finalNetwork.scale();
-//    matDist /= matDist.maxCoeff();
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+Network::SPtr ConnectivityMeasures::createNetwork(const MatrixXd& matWeights, const MatrixX3f& matVert, const QString& sName)
+{
+    Network::SPtr finalNetwork = Network::SPtr(new Network(sName));
+
+    //The node and edge objects are only created if requested
+    finalNetwork->setAdjacency(matWeights, matVert);
 
     return finalNetwork;
 }
@@ -125,6 +125,29 @@ public:
     */
     static Network::SPtr crossCorrelation(const Eigen::MatrixXd& matData, const Eigen::MatrixX3f& matVert);
 
+    //=========================================================================================================
+    /**
+    * Calculates the Pearson's correlation coefficient between all rows of the data matrix at once as
+    * normalised X * X^T. Element (i,j) equals calcPearsonsCorrelationCoeff(matData.row(i), matData.row(j)).
+    *
+    * @param[in] matData    The input data (rows are channels/sources, columns are samples).
+    *
+    * @return               The symmetric correlation matrix.
+    */
+    static Eigen::MatrixXd calcPearsonsCorrelationCoeffMatrix(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Calculates the cross correlation between all rows of the data matrix at once. Every row is transformed
+    * only once, the pairwise spectra are computed as batched products and the pairs are processed
+    * concurrently. Element (i,j) equals calcCrossCorrelation(matData.row(i), matData.row(j)).second.
+    *
+    * @param[in] matData    The input data (rows are channels/sources, columns are samples).
+    *
+    * @return               The symmetric matrix holding the maximum cross correlation value of each pair.
+    */
+    static Eigen::MatrixXd calcCrossCorrelationMatrix(const Eigen::MatrixXd& matData);
+
 protected:
     //=========================================================================================================
     /**
@@ -149,6 +172,39 @@ protected:
     static QPair<int,double> calcCrossCorrelation(const Eigen::RowVectorXd &vecFirst, const Eigen::RowVectorXd &vecSecond);
 
 private:
+    /**
+    * A range of rows which is processed by one worker of calcCrossCorrelationMatrix
+    */
+    struct CrossCorrelationChunk {
+        const Eigen::MatrixXcd*     pMatSpectra;    /**< The half spectra of all rows, one row per column */
+        Eigen::MatrixXd*            pMatResult;     /**< The resulting cross correlation matrix */
+        int                         iFftSize;       /**< The FFT size */
+        int                         iFirst;         /**< First row of the chunk */
+        int                         iLast;          /**< One past the last row of the chunk */
+    };
+
+    //=========================================================================================================
+    /**
+    * Calculates the cross correlation of the rows of one chunk with all following rows. Used by
+    * calcCrossCorrelationMatrix.
+    *
+    * @param[in] chunk      The chunk to process.
+    *
+    * @return               true if succeeded, false otherwise.
+    */
+    static bool calcCrossCorrelationChunk(const CrossCorrelationChunk &chunk);
+
+    //=========================================================================================================
+    /**
+    * Creates a network from the upper triangle (including the diagonal) of a connectivity matrix.
+    *
+    * @param[in] matWeights The symmetric connectivity matrix.
+    * @param[in] matVert    The vertices of each network node.
+    * @param[in] sName      The name of the connectivity measure.
+    *
+    * @return               The connectivity information in form of a network structure.
+    */
+    static Network::SPtr createNetwork(const Eigen::MatrixXd& matWeights, const Eigen::MatrixX3f& matVert, const QString& sName);
 
 };
 
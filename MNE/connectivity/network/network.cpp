@@ -82,6 +82,10 @@ using namespace Eigen;
 
 Network::Network(const QString& sConnectivityMethod)
 : m_sConnectivityMethod(sConnectivityMethod)
+, m_matNodeVert(0,3)
+, m_bDense(false)
+, m_bObjectsValid(true)
+, m_bAdjacencyValid(true)
 {
 }
 
@@ -94,10 +98,206 @@ MatrixXd Network::getConnectivityMatrix()
 }
 
 
+//*************************************************************************************************************
+
+void Network::setAdjacency(const MatrixXd& matWeights, const MatrixX3f& matVert)
+{
+    const qint64 n = qMin(matWeights.rows(), matWeights.cols());
+
+    m_matNodeVert = MatrixX3f::Zero(n, 3);
+    const qint64 nVert = qMin((qint64)matVert.rows(), n);
+    m_matNodeVert.topRows(nVert) = matVert.topRows(nVert);
+
+    m_vecDenseUpper.resize(n*(n+1)/2);
+    for(qint64 i = 0; i < n; ++i) {
+        m_vecDenseUpper.segment(packedIndex(i,i), n-i) = matWeights.row(i).tail(n-i).transpose().cast<float>();
+    }
+
+    m_matSparseUpper = SparseMatrix<float, RowMajor>();
+    m_bDense = true;
+
+    m_lNodes.clear();
+    m_lEdges.clear();
+    m_bObjectsValid = false;
+    m_bAdjacencyValid = true;
+}
+
+
+//*************************************************************************************************************
+
+void Network::setSparseAdjacency(const SparseMatrix<float, RowMajor>& matWeights, const MatrixX3f& matVert)
+{
+    const qint64 n = qMin(matWeights.rows(), matWeights.cols());
+
+    m_matNodeVert = MatrixX3f::Zero(n, 3);
+    const qint64 nVert = qMin((qint64)matVert.rows(), n);
+    m_matNodeVert.topRows(nVert) = matVert.topRows(nVert);
+
+    m_matSparseUpper = matWeights.topLeftCorner(n, n).triangularView<Upper>();
+    m_matSparseUpper.makeCompressed();
+
+    m_vecDenseUpper.resize(0);
+    m_bDense = false;
+
+    m_lNodes.clear();
+    m_lEdges.clear();
+    m_bObjectsValid = false;
+    m_bAdjacencyValid = true;
+}
+
+
+//*************************************************************************************************************
+
+void Network::applyThreshold(double dThreshold)
+{
+    updateAdjacency();
+
+    const qint64 n = m_matNodeVert.rows();
+
+    typedef Eigen::Triplet<float> T;
+    std::vector<T> tripletList;
+
+    if(m_bDense) {
+        for(qint64 i = 0; i < n; ++i) {
+            for(qint64 j = i; j < n; ++j) {
+                float fWeight = m_vecDenseUpper(packedIndex(i,j));
+                if(fWeight >= dThreshold) {
+                    tripletList.push_back(T(i, j, fWeight));
+                }
+            }
+        }
+    } else {
+        for(int k = 0; k < m_matSparseUpper.outerSize(); ++k) {
+            for(SparseMatrix<float, RowMajor>::InnerIterator it(m_matSparseUpper, k); it; ++it) {
+                if(it.value() >= dThreshold) {
+                    tripletList.push_back(T(it.row(), it.col(), it.value()));
+                }
+            }
+        }
+    }
+
+    SparseMatrix<float, RowMajor> matSparse(n, n);
+    matSparse.setFromTriplets(tripletList.begin(), tripletList.end());
+
+    MatrixX3f matVert = m_matNodeVert;
+    setSparseAdjacency(matSparse, matVert);
+}
+
+
+//*************************************************************************************************************
+
+MatrixXi Network::getEdgeIndices(double dThreshold)
+{
+    updateAdjacency();
+
+    const qint64 n = m_matNodeVert.rows();
+
+    //Count first to avoid resizing per edge
+    qint64 iCount = 0;
+
+    if(m_bDense) {
+        iCount = (m_vecDenseUpper.array() >= dThreshold).count();
+    } else {
+        iCount = (Map<const VectorXf>(m_matSparseUpper.valuePtr(), m_matSparseUpper.nonZeros()).array() >= dThreshold).count();
+    }
+
+    MatrixXi matEdges(iCount, 2);
+    qint64 iEdge = 0;
+
+    if(m_bDense) {
+        for(qint64 i = 0; i < n; ++i) {
+            for(qint64 j = i; j < n; ++j) {
+                if(m_vecDenseUpper(packedIndex(i,j)) >= dThreshold) {
+                    matEdges(iEdge,0) = i;
+                    matEdges(iEdge,1) = j;
+                    ++iEdge;
+                }
+            }
+        }
+    } else {
+        for(int k = 0; k < m_matSparseUpper.outerSize(); ++k) {
+            for(SparseMatrix<float, RowMajor>::InnerIterator it(m_matSparseUpper, k); it; ++it) {
+                if(it.value() >= dThreshold) {
+                    matEdges(iEdge,0) = it.row();
+                    matEdges(iEdge,1) = it.col();
+                    ++iEdge;
+                }
+            }
+        }
+    }
+
+    return matEdges;
+}
+
+
+//*************************************************************************************************************
+
+double Network::getWeight(int i, int j)
+{
+    updateAdjacency();
+
+    if(i > j) {
+        std::swap(i, j);
+    }
+
+    if(i < 0 || j >= m_matNodeVert.rows()) {
+        return 0.0;
+    }
+
+    if(m_bDense) {
+        return m_vecDenseUpper(packedIndex(i,j));
+    }
+
+    return m_matSparseUpper.coeff(i,j);
+}
+
+
+//*************************************************************************************************************
+
+const MatrixX3f& Network::getNodeVert()
+{
+    updateAdjacency();
+
+    return m_matNodeVert;
+}
+
+
+//*************************************************************************************************************
+
+qint32 Network::getNodeCount()
+{
+    updateAdjacency();
+
+    return m_matNodeVert.rows();
+}
+
+
+//*************************************************************************************************************
+
+qint32 Network::getEdgeCount()
+{
+    updateAdjacency();
+
+    return m_bDense ? m_vecDenseUpper.size() : m_matSparseUpper.nonZeros();
+}
+
+
+//*************************************************************************************************************
+
+bool Network::isDense()
+{
+    updateAdjacency();
+
+    return m_bDense;
+}
+
+
 //*************************************************************************************************************
 
 QList<NetworkEdge::SPtr> Network::getEdges()
 {
+    updateObjects();
+
     return m_lEdges;
 }
 
@@ -106,6 +306,8 @@ QList<NetworkEdge::SPtr> Network::getEdges()
 
 QList<NetworkNode::SPtr> Network::getNodes()
 {
+    updateObjects();
+
     return m_lNodes;
 }
 
@@ -116,8 +318,21 @@ qint16 Network::getDistribution()
 {
     qint16 distribution = 0;
 
-    for(NetworkNode::SPtr node : m_lNodes) {
-        distribution += node->getDegree();
+    if(m_bObjectsValid) {
+        for(NetworkNode::SPtr node : m_lNodes) {
+            distribution += node->getDegree();
+        }
+
+        return distribution;
+    }
+
+    //Every edge counts once for its start node, self connections count as in and out edge
+    distribution = getEdgeCount();
+
+    for(qint64 i = 0; i < m_matNodeVert.rows(); ++i) {
+        if(m_bDense || m_matSparseUpper.coeff(i,i) != 0.0f) {
+            ++distribution;
+        }
     }
 
     return distribution;
@@ -144,7 +359,10 @@ QString Network::getConnectivityMethod()
 
 Network& Network::operator<<(NetworkEdge::SPtr newEdge)
 {
+    updateObjects();
+
     m_lEdges << newEdge;
+    m_bAdjacencyValid = false;
 
     return *this;
 }
@@ -154,7 +372,10 @@ Network& Network::operator<<(NetworkEdge::SPtr newEdge)
 
 Network& Network::operator<<(NetworkNode::SPtr newNode)
 {
+    updateObjects();
+
     m_lNodes << newNode;
+    m_bAdjacencyValid = false;
 
     return *this;
 }
@@ -162,26 +383,114 @@ Network& Network::operator<<(NetworkNode::SPtr newNode)
 
 //*************************************************************************************************************
 
-MatrixXd Network::generateConnectMat()
+void Network::updateObjects()
+{
+    if(m_bObjectsValid) {
+        return;
+    }
+
+    const qint64 n = m_matNodeVert.rows();
+
+    m_lNodes.clear();
+    m_lEdges.clear();
+    m_lNodes.reserve(n);
+
+    for(qint64 i = 0; i < n; ++i) {
+        m_lNodes << NetworkNode::SPtr(new NetworkNode(i, m_matNodeVert.row(i)));
+    }
+
+    //Edges are attached to their start node only
+    if(m_bDense) {
+        m_lEdges.reserve(m_vecDenseUpper.size());
+
+        for(qint64 i = 0; i < n; ++i) {
+            for(qint64 j = i; j < n; ++j) {
+                NetworkEdge::SPtr pEdge = NetworkEdge::SPtr(new NetworkEdge(m_lNodes[i], m_lNodes[j], m_vecDenseUpper(packedIndex(i,j))));
+
+                *m_lNodes[i] << pEdge;
+                m_lEdges << pEdge;
+            }
+        }
+    } else {
+        m_lEdges.reserve(m_matSparseUpper.nonZeros());
+
+        for(int k = 0; k < m_matSparseUpper.outerSize(); ++k) {
+            for(SparseMatrix<float, RowMajor>::InnerIterator it(m_matSparseUpper, k); it; ++it) {
+                NetworkEdge::SPtr pEdge = NetworkEdge::SPtr(new NetworkEdge(m_lNodes[it.row()], m_lNodes[it.col()], it.value()));
+
+                *m_lNodes[it.row()] << pEdge;
+                m_lEdges << pEdge;
+            }
+        }
+    }
+
+    m_bObjectsValid = true;
+}
+
+
+//*************************************************************************************************************
+
+void Network::updateAdjacency()
 {
-    MatrixXd matDist(m_lNodes.size(), m_lNodes.size());
-    matDist.setZero();
+    if(m_bAdjacencyValid) {
+        return;
+    }
+
+    const qint64 n = m_lNodes.size();
 
-    for(int i = 0; i < m_lEdges.size(); ++i)
-    {
+    m_matNodeVert = MatrixX3f::Zero(n, 3);
+    for(qint64 i = 0; i < n; ++i) {
+        const RowVectorXf& vecVert = m_lNodes.at(i)->getVert();
+        for(int k = 0; k < qMin((int)vecVert.cols(), 3); ++k) {
+            m_matNodeVert(i,k) = vecVert(k);
+        }
+    }
+
+    //Edges which were added one by one are stored sparse
+    typedef Eigen::Triplet<float> T;
+    std::vector<T> tripletList;
+    tripletList.reserve(m_lEdges.size());
+
+    for(int i = 0; i < m_lEdges.size(); ++i) {
         int row = m_lEdges.at(i)->getStartNode()->getId();
         int col = m_lEdges.at(i)->getEndNode()->getId();
 
-        if(row < matDist.rows() && col < matDist.cols())
-        {
-            matDist(row,col) = m_lEdges.at(i)->getWeight();
+        if(row > col) {
+            std::swap(row, col);
+        }
+
+        if(row >= 0 && col < n) {
+            tripletList.push_back(T(row, col, m_lEdges.at(i)->getWeight()));
         }
     }
 
-    return matDist;
+    m_matSparseUpper = SparseMatrix<float, RowMajor>(n, n);
+    m_matSparseUpper.setFromTriplets(tripletList.begin(), tripletList.end());
+    m_matSparseUpper.makeCompressed();
+
+    m_vecDenseUpper.resize(0);
+    m_bDense = false;
+    m_bAdjacencyValid = true;
 }
 
 
+//*************************************************************************************************************
 
+MatrixXd Network::generateConnectMat()
+{
+    updateAdjacency();
+
+    const qint64 n = m_matNodeVert.rows();
+
+    MatrixXd matDist = MatrixXd::Zero(n, n);
 
+    if(m_bDense) {
+        for(qint64 i = 0; i < n; ++i) {
+            matDist.row(i).tail(n-i) = m_vecDenseUpper.segment(packedIndex(i,i), n-i).transpose().cast<double>();
+        }
+    } else {
+        matDist = MatrixXf(m_matSparseUpper).cast<double>();
+    }
 
+    return matDist;
+}
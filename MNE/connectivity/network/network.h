@@ -62,6 +62,7 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 
 
 //*************************************************************************************************************
@@ -86,9 +87,12 @@ namespace CONNECTIVITYLIB {
 
 //=============================================================================================================
 /**
-* Description of what this class is intended to do (in detail).
+* The network is stored as a contiguous adjacency, either as packed dense upper triangle (including the diagonal)
+* or, for thresholded and sparse networks, as CSR matrix holding the upper triangle. The node/edge object view is
+* only created on demand, e.g. when calling getNodes() or getEdges(). Edges are undirected, an edge between the
+* nodes i and j is stored at (min(i,j), max(i,j)).
 *
-* @brief Brief description of this class.
+* @brief This class holds a connectivity network.
 */
 
 class CONNECTIVITYSHARED_EXPORT Network
@@ -114,6 +118,80 @@ public:
     */
     Eigen::MatrixXd getConnectivityMatrix();
 
+    //=========================================================================================================
+    /**
+    * Sets the network from a dense connectivity matrix. Only the upper triangle (including the diagonal) is used.
+    * Every entry of the upper triangle forms an edge. This replaces all nodes and edges.
+    *
+    * @param[in] matWeights     The connectivity matrix.
+    * @param[in] matVert        The vertices of each network node. Missing rows are set to zero.
+    */
+    void setAdjacency(const Eigen::MatrixXd& matWeights, const Eigen::MatrixX3f& matVert);
+
+    //=========================================================================================================
+    /**
+    * Sets the network from a sparse connectivity matrix. Only the stored entries of the upper triangle (including
+    * the diagonal) form edges. This replaces all nodes and edges.
+    *
+    * @param[in] matWeights     The sparse connectivity matrix.
+    * @param[in] matVert        The vertices of each network node. Missing rows are set to zero.
+    */
+    void setSparseAdjacency(const Eigen::SparseMatrix<float, Eigen::RowMajor>& matWeights, const Eigen::MatrixX3f& matVert);
+
+    //=========================================================================================================
+    /**
+    * Removes all edges with a weight below the threshold. The network is stored as CSR matrix afterwards.
+    *
+    * @param[in] dThreshold     The threshold.
+    */
+    void applyThreshold(double dThreshold);
+
+    //=========================================================================================================
+    /**
+    * Returns the indices of the start and end nodes of all edges with a weight of at least the threshold.
+    * Walks the adjacency directly, no node/edge objects are created.
+    *
+    * @param[in] dThreshold     The threshold.
+    *
+    * @return   The node indices, one edge per row.
+    */
+    Eigen::MatrixXi getEdgeIndices(double dThreshold);
+
+    //=========================================================================================================
+    /**
+    * Returns the weight of the edge between two nodes, 0 if there is no such edge.
+    *
+    * @param[in] i      The first node.
+    * @param[in] j      The second node.
+    *
+    * @return   The edge weight.
+    */
+    double getWeight(int i, int j);
+
+    //=========================================================================================================
+    /**
+    * Returns the vertices of all nodes.
+    */
+    const Eigen::MatrixX3f& getNodeVert();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of nodes.
+    */
+    qint32 getNodeCount();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of edges.
+    */
+    qint32 getEdgeCount();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the adjacency is stored as packed dense upper triangle (true) or as CSR matrix (false).
+    */
+    bool isDense();
+
     //=========================================================================================================
     /**
     * Returns the edges.
@@ -169,11 +247,36 @@ public:
 protected:
 
 private:
-    QList<NetworkEdge::SPtr>    m_lEdges;                   /**< List with all edges of the network.*/
-    QList<NetworkNode::SPtr>    m_lNodes;                   /**< List with all nodes of the network.*/
+    QList<NetworkEdge::SPtr>    m_lEdges;                   /**< List with all edges of the network. Only valid if m_bObjectsValid.*/
+    QList<NetworkNode::SPtr>    m_lNodes;                   /**< List with all nodes of the network. Only valid if m_bObjectsValid.*/
 
     QString                     m_sConnectivityMethod;      /**< The connectivity measure method used to create the data of this network structure.*/
 
+    Eigen::MatrixX3f                            m_matNodeVert;          /**< The vertices of the nodes.*/
+    Eigen::VectorXf                             m_vecDenseUpper;        /**< The packed upper triangle (row by row, including the diagonal) if m_bDense.*/
+    Eigen::SparseMatrix<float, Eigen::RowMajor> m_matSparseUpper;       /**< The upper triangle as CSR matrix if !m_bDense.*/
+    bool                                        m_bDense;               /**< Whether the packed dense or the CSR storage is used.*/
+    bool                                        m_bObjectsValid;        /**< Whether the node/edge objects reflect the adjacency.*/
+    bool                                        m_bAdjacencyValid;      /**< Whether the adjacency reflects the node/edge objects.*/
+
+    //=========================================================================================================
+    /**
+    * Returns the position of element (i,j), i <= j, in the packed upper triangle.
+    */
+    inline qint64 packedIndex(qint64 i, qint64 j) const;
+
+    //=========================================================================================================
+    /**
+    * Creates the node/edge objects from the adjacency if they are outdated.
+    */
+    void updateObjects();
+
+    //=========================================================================================================
+    /**
+    * Rebuilds the adjacency from the node/edge objects if they were modified via the stream operators.
+    */
+    void updateAdjacency();
+
     //=========================================================================================================
     /**
     * Returns the connectivity matrix for this network structure.
@@ -190,6 +293,12 @@ private:
 // INLINE DEFINITIONS
 //=============================================================================================================
 
+inline qint64 Network::packedIndex(qint64 i, qint64 j) const
+{
+    const qint64 n = m_matNodeVert.rows();
+    return i*n - i*(i-1)/2 + (j-i);
+}
+
 
 } // namespace CONNECTIVITYLIB
 
@@ -266,17 +266,9 @@ void NetworkTreeItem::plotNetwork(QSharedPointer<CONNECTIVITYLIB::Network> pNetw
 //    m_lNodes.clear();
 
     //Create network vertices and normals
-    QList<NetworkNode::SPtr> lNetworkNodes = pNetworkData->getNodes();
+    MatrixX3f tMatVert = pNetworkData->getNodeVert();
 
-    MatrixX3f tMatVert(pNetworkData->getNodes().size(), 3);
-
-    for(int i = 0; i < lNetworkNodes.size(); ++i) {
-        tMatVert(i,0) = lNetworkNodes.at(i)->getVert()(0);
-        tMatVert(i,1) = lNetworkNodes.at(i)->getVert()(1);
-        tMatVert(i,2) = lNetworkNodes.at(i)->getVert()(2);
-    }
-
-    MatrixX3f tMatNorm(pNetworkData->getNodes().size(), 3);
+    MatrixX3f tMatNorm(tMatVert.rows(), 3);
     tMatNorm.setZero();
 
     //Draw network nodes
@@ -284,10 +276,10 @@ void NetworkTreeItem::plotNetwork(QSharedPointer<CONNECTIVITYLIB::Network> pNetw
     if(!m_bNodesPlotted) {
         QVector3D pos;
 
-        for(int i = 0; i < lNetworkNodes.size(); ++i) {
-            pos.setX(lNetworkNodes.at(i)->getVert()(0));
-            pos.setY(lNetworkNodes.at(i)->getVert()(1));
-            pos.setZ(lNetworkNodes.at(i)->getVert()(2));
+        for(int i = 0; i < tMatVert.rows(); ++i) {
+            pos.setX(tMatVert(i,0));
+            pos.setY(tMatVert(i,1));
+            pos.setZ(tMatVert(i,2));
 
             Renderable3DEntity* sourceSphereEntity = new Renderable3DEntity(m_pRenderable3DEntity);
 
@@ -311,31 +303,8 @@ void NetworkTreeItem::plotNetwork(QSharedPointer<CONNECTIVITYLIB::Network> pNetw
         m_bNodesPlotted = true;
     }
 
-    //Generate connection indices for Qt3D buffer
-    MatrixXi tMatLines;
-    int count = 0;
-
-    for(int i = 0; i < lNetworkNodes.size(); ++i) {
-        //Plot in edges
-        for(int j = 0; j < lNetworkNodes.at(i)->getEdgesIn().size(); ++j) {
-            if(lNetworkNodes.at(i)->getEdgesIn().at(j)->getWeight() >= vecThreshold.x()) {
-                tMatLines.conservativeResize(count+1,2);
-                tMatLines(count,0) = lNetworkNodes.at(i)->getEdgesIn().at(j)->getStartNode()->getId();
-                tMatLines(count,1) = lNetworkNodes.at(i)->getEdgesIn().at(j)->getEndNode()->getId();
-                ++count;
-            }
-        }
-
-        //Plot out edges
-        for(int j = 0; j < lNetworkNodes.at(i)->getEdgesOut().size(); ++j) {
-            if(lNetworkNodes.at(i)->getEdgesOut().at(j)->getWeight() >= vecThreshold.x()) {
-                tMatLines.conservativeResize(count+1,2);
-                tMatLines(count,0) = lNetworkNodes.at(i)->getEdgesOut().at(j)->getStartNode()->getId();
-                tMatLines(count,1) = lNetworkNodes.at(i)->getEdgesOut().at(j)->getEndNode()->getId();
-                ++count;
-            }
-        }
-    }
+    //Generate connection indices for Qt3D buffer directly from the network's adjacency
+    MatrixXi tMatLines = pNetworkData->getEdgeIndices(vecThreshold.x());
 
     //Generate colors for Qt3D buffer
     QByteArray arrayLineColor;
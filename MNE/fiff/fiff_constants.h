@@ -429,6 +429,25 @@ namespace FIFFLIB
 //
 #define FIFFB_MNE_RT_MEAS_INFO      3710              /**< Fiff Real-Time Measurement Info */
 
+//
+// 3720... Operator Cache
+//
+#define FIFFB_MNE_CLUSTERED_FORWARD         3720    /**< Cached clustered forward solution */
+#define FIFFB_MNE_CLUSTER_INFO              3721    /**< Cluster information of one hemisphere */
+
+#define FIFF_MNE_CACHE_KEY                  3730    /**< Hash of the inputs the cached data was computed from */
+#define FIFF_MNE_CLUSTER_GAIN_DIM           3731    /**< Rows and columns of the clustered gain matrix */
+#define FIFF_MNE_CLUSTER_GAIN               3732    /**< Clustered gain matrix, double, column major */
+#define FIFF_MNE_CLUSTER_VERTNO             3733    /**< Vertno of the clustered hemisphere (label ids) */
+#define FIFF_MNE_CLUSTER_LABEL_IDS          3734    /**< Label id of each cluster */
+#define FIFF_MNE_CLUSTER_LABEL_NAMES        3735    /**< Label name of each cluster */
+#define FIFF_MNE_CLUSTER_CENTROID_VERTNO    3736    /**< Centroid vertno of each cluster */
+#define FIFF_MNE_CLUSTER_CENTROID_RR        3737    /**< Centroid location of each cluster */
+#define FIFF_MNE_CLUSTER_SIZES              3738    /**< Number of vertices of each cluster */
+#define FIFF_MNE_CLUSTER_VERTNOS            3739    /**< Vertnos of all clusters, concatenated */
+#define FIFF_MNE_CLUSTER_SOURCE_RR          3740    /**< Source locations of all clusters, concatenated */
+#define FIFF_MNE_CLUSTER_DISTANCES          3741    /**< Distances to the centroid of all clusters, concatenated */
+
 
 //
 // Fiff values associated with MNE computations
@@ -42,6 +42,15 @@
 #include "fiff_tag.h"
 #include "fiff_stream.h"
 #include "cstdlib"
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -51,6 +60,118 @@
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+static inline qint16 swap_sample(qint16 source)
+{
+    return qbswap(source);
+}
+
+
+//*************************************************************************************************************
+
+static inline qint32 swap_sample(qint32 source)
+{
+    return qbswap(source);
+}
+
+
+//*************************************************************************************************************
+
+static inline float swap_sample(float source)
+{
+    quint32 tmp;
+    memcpy(&tmp, &source, sizeof(float));
+    tmp = qbswap(tmp);
+    memcpy(&source, &tmp, sizeof(float));
+    return source;
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+static inline double read_sample(const char* p_pData, bool p_bSwap)
+{
+    T value;
+    memcpy(&value, p_pData, sizeof(T));
+    return p_bSwap ? (double)swap_sample(value) : (double)value;
+}
+
+
+//*************************************************************************************************************
+/**
+* Converts the samples [p_iFirst, p_iFirst + p_iNumSamp) of a packed (channels x samples, column major) raw buffer
+* to double, applies the calibration factors when given and writes them to the columns starting at p_iDest.
+* If p_vecRows is not empty only the listed channels are decoded, row r of the output holds channel p_vecRows[r].
+* The calibration factors refer to the output rows.
+*/
+template<typename T>
+static void decode_samples(const char* p_pRawData, bool p_bSwap, qint32 p_iNumChan, fiff_int_t p_iFirst, fiff_int_t p_iNumSamp, const RowVectorXi& p_vecRows, const RowVectorXd& p_vecCals, MatrixXd& p_matOut, qint32 p_iDest)
+{
+    const char* pIn = p_pRawData + (qint64)p_iFirst * p_iNumChan * sizeof(T);
+    qint32 iNumRows = p_matOut.rows();
+    bool bCal = p_vecCals.size() == iNumRows;
+
+    for(qint32 j = 0; j < p_iNumSamp; ++j, pIn += p_iNumChan * sizeof(T))
+    {
+        double* pOut = p_matOut.data() + (qint64)(p_iDest + j) * iNumRows;
+
+        if(p_vecRows.size() == 0)
+        {
+            if(bCal)
+                for(qint32 i = 0; i < iNumRows; ++i)
+                    pOut[i] = p_vecCals[i] * read_sample<T>(pIn + i * sizeof(T), p_bSwap);
+            else
+                for(qint32 i = 0; i < iNumRows; ++i)
+                    pOut[i] = read_sample<T>(pIn + i * sizeof(T), p_bSwap);
+        }
+        else
+        {
+            if(bCal)
+                for(qint32 r = 0; r < iNumRows; ++r)
+                    pOut[r] = p_vecCals[r] * read_sample<T>(pIn + p_vecRows[r] * sizeof(T), p_bSwap);
+            else
+                for(qint32 r = 0; r < iNumRows; ++r)
+                    pOut[r] = read_sample<T>(pIn + p_vecRows[r] * sizeof(T), p_bSwap);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+/**
+* Type dispatch for decode_samples. Output storage is (re-)allocated when it is too small.
+*
+* @return false if the buffer type is not supported
+*/
+static bool decode_raw_buffer(const char* p_pRawData, fiff_int_t p_iType, bool p_bSwap, qint32 p_iNumChan, fiff_int_t p_iFirst, fiff_int_t p_iNumSamp, const RowVectorXi& p_vecRows, const RowVectorXd& p_vecCals, MatrixXd& p_matOut, qint32 p_iDest)
+{
+    qint32 iNumRows = p_vecRows.size() > 0 ? p_vecRows.size() : p_iNumChan;
+    if(p_matOut.rows() != iNumRows || p_matOut.cols() < p_iDest + p_iNumSamp)
+        p_matOut.resize(iNumRows, p_iDest + p_iNumSamp);
+
+    switch(p_iType)
+    {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            decode_samples<qint16>(p_pRawData, p_bSwap, p_iNumChan, p_iFirst, p_iNumSamp, p_vecRows, p_vecCals, p_matOut, p_iDest);
+            return true;
+        case FIFFT_INT:
+            decode_samples<qint32>(p_pRawData, p_bSwap, p_iNumChan, p_iFirst, p_iNumSamp, p_vecRows, p_vecCals, p_matOut, p_iDest);
+            return true;
+        case FIFFT_FLOAT:
+            decode_samples<float>(p_pRawData, p_bSwap, p_iNumChan, p_iFirst, p_iNumSamp, p_vecRows, p_vecCals, p_matOut, p_iDest);
+            return true;
+        default:
+            return false;
+    }
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -122,11 +243,15 @@ void FiffRawData::clear()
 
 bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t from, fiff_int_t to, const RowVectorXi& sel, bool do_debug)
 {
-    bool projAvailable = true;
+    SparseMatrix<double> multSegment;
+    return read_raw_segment(data, times, multSegment, from, to, sel, do_debug);
+}
 
-    if (this->proj.size() == 0)
-        projAvailable = false;
 
+//*************************************************************************************************************
+
+bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, SparseMatrix<double>& multSegment, fiff_int_t from, fiff_int_t to, const RowVectorXi& sel, bool do_debug)
+{
     if(from == -1)
         from = this->first_samp;
     if(to == -1)
@@ -150,119 +275,96 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
     //
     qint32 nchan = this->info.nchan;
     qint32 dest  = 0;//1;
-    qint32 i, k, r;
+    qint32 i, k;
 
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> tripletList;
-    tripletList.reserve(nchan);
-    for(i = 0; i < nchan; ++i)
-        tripletList.push_back(T(i, i, this->cals[i]));
+    SparseMatrix<double> cal, mult, multDecoded;
+    RowVectorXi decodeRows;
+    RowVectorXd decodeCals;
+    make_read_operator(sel, cal, mult, decodeRows, decodeCals, multDecoded);
 
-    SparseMatrix<double> cal(nchan, nchan);
-    cal.setFromTriplets(tripletList.begin(), tripletList.end());
-//    cal.makeCompressed();
+    data = MatrixXd(sel.size() > 0 ? sel.size() : nchan, to-from+1);
 
-    MatrixXd mult_full;
     //
-    if (sel.size() == 0)
+
+    FiffStream::SPtr fid;
+    if (!this->file->device()->isOpen())
     {
-        data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
-        if (projAvailable || this->comp.kind != -1)
+        if (!this->file->device()->open(QIODevice::ReadOnly))
         {
-            if (!projAvailable)
-                mult_full = this->comp.data->data*cal;
-            else if (this->comp.kind == -1)
-                mult_full = this->proj*cal;
-            else
-                mult_full = this->proj*this->comp.data->data*cal;
+            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
         }
+        fid = this->file;
     }
     else
     {
-        data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
-
-        MatrixXd selVect(sel.size(), nchan);
-
-        selVect.setZero();
+        fid = this->file;
+    }
 
-        if (!projAvailable && this->comp.kind == -1)
+    fiff_int_t first_pick, last_pick, picksamp;
+    //
+    //  Start directly at the first buffer which contains data of the requested range
+    //
+    for(k = this->find_raw_buffer(from); k < this->rawdir.size(); ++k)
+    {
+        const FiffRawDir& thisRawDir = this->rawdir[k];
+        //
+        //  The picking logic is a bit complicated
+        //
+        if (to >= thisRawDir.last && from <= thisRawDir.first)
         {
-            tripletList.clear();
-            tripletList.reserve(sel.size());
-            for(i = 0; i < sel.size(); ++i)
-                tripletList.push_back(T(i, i, this->cals[sel[i]]));
-            cal = SparseMatrix<double>(sel.size(), sel.size());
-            cal.setFromTriplets(tripletList.begin(), tripletList.end());
+            //
+            //  We need the whole buffer
+            //
+            first_pick = 0;//1;
+            last_pick  = thisRawDir.nsamp - 1;
+            if (do_debug)
+                printf("W");
         }
-        else
+        else if (from > thisRawDir.first)
         {
-            if (!projAvailable)
+            first_pick = from - thisRawDir.first;// + 1;
+            if(to < thisRawDir.last)
             {
-                qDebug() << "This has to be debugged! #1";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
-                mult_full = selVect*cal;
-            }
-            else if (this->comp.kind == -1)
-            {
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*cal;
+                //
+                //  Something from the middle
+                //
+                last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;
+                if (do_debug)
+                    printf("M");
             }
             else
             {
-                qDebug() << "This has to be debugged! #3";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*this->comp.data->data*cal;
+                //
+                //  From the middle to the end
+                //
+                last_pick = thisRawDir.nsamp - 1;
+                if (do_debug)
+                    printf("E");
             }
         }
-    }
-
-    //
-    // Make mult sparse
-    //
-    tripletList.clear();
-    tripletList.reserve(mult_full.rows()*mult_full.cols());
-    for(i = 0; i < mult_full.rows(); ++i)
-        for(k = 0; k < mult_full.cols(); ++k)
-            if(mult_full(i,k) != 0)
-                tripletList.push_back(T(i, k, mult_full(i,k)));
-
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
-    if(tripletList.size() > 0)
-        mult.setFromTriplets(tripletList.begin(), tripletList.end());
-//    mult.makeCompressed();
-
-    //
-
-    FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
-    {
-        if (!this->file->device()->open(QIODevice::ReadOnly))
+        else
         {
-            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+            //
+            //  From the beginning to the middle
+            //
+            first_pick = 0;//1;
+            last_pick  = to - thisRawDir.first;// + 1;
+            if (do_debug)
+                printf("B");
         }
-        fid = this->file;
-    }
-    else
-    {
-        fid = this->file;
-    }
-
-    MatrixXd one;
-    fiff_int_t first_pick, last_pick, picksamp;
-    for(k = 0; k < this->rawdir.size(); ++k)
-    {
-        FiffRawDir thisRawDir = this->rawdir[k];
         //
-        //  Do we need this buffer
+        //  Now we are ready to pick
         //
-        if (thisRawDir.last > from)
+        picksamp = last_pick - first_pick + 1;
+
+        if(do_debug)
+        {
+            qDebug() << "first_pick: " << first_pick;
+            qDebug() << "last_pick: " << last_pick;
+            qDebug() << "picksamp: " << picksamp;
+        }
+
+        if (picksamp > 0)
         {
             if (thisRawDir.ent.kind == -1)
             {
@@ -271,148 +373,58 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
                 //
                 if(do_debug)
                     printf("S");
-                if (sel.cols() <= 0)
-                    one.resize(nchan,thisRawDir.nsamp);
-                else
-                    one.resize(sel.cols(),thisRawDir.nsamp);
-
-                one.setZero();
+                data.block(0,dest,data.rows(),picksamp).setZero();
+            }
+            else if (mult.cols() != 0 && multDecoded.cols() == 0)
+            {
+                //
+                //  The operator does not depend on any channel, nothing has to be decoded
+                //
+                data.block(0,dest,data.rows(),picksamp).setZero();
             }
             else
             {
-                FiffTag::SPtr t_pTag;
-                FiffTag::read_tag(fid.data(), t_pTag, thisRawDir.ent.pos);
                 //
-                //   Depending on the state of the projection and selection
-                //   we proceed a little bit differently
+                //  Locate the samples of the buffer, either directly in the mapped file or in the read tag
                 //
-                if (mult.cols() == 0)
+                const char* t_pRawData = NULL;
+                fiff_int_t t_iType = -1;
+                bool t_bSwap = false;
+                const uchar* t_pMapped = fid->is_mapped() ? fid->mapped_data(thisRawDir.ent.pos, FIFFC_DATA_OFFSET + thisRawDir.ent.size) : NULL;
+                if (t_pMapped)
                 {
-                    if (sel.cols() == 0)
-                    {
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                            one = cal*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_INT)
-                            one = cal*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                            one = cal*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else
-                            printf("Data Storage Format not known jet [1]!! Type: %d\n", t_pTag->type);
-                    }
-                    else
-                    {
-
-                        //ToDo find a faster solution for this!! --> make cal and mul sparse like in MATLAB
-                        MatrixXd newData(sel.cols(), thisRawDir.nsamp); //ToDo this can be done much faster, without newData
-
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixDau16 > ( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_INT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXf > ( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else
-                        {
-                            printf("Data Storage Format not known jet [2]!! Type: %d\n", t_pTag->type);
-                        }
-
-                        one = cal*newData;
-                    }
+                    t_iType = qFromBigEndian<qint32>(t_pMapped + 4);
+                    t_pRawData = (const char*)(t_pMapped + FIFFC_DATA_OFFSET);
+                    t_bSwap = (Q_BYTE_ORDER == Q_LITTLE_ENDIAN);
                 }
                 else
                 {
-                    if (t_pTag->type == FIFFT_DAU_PACK16)
-                        one = mult*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_INT)
-                        one = mult*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_FLOAT)
-                        one = mult*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else
-                        printf("Data Storage Format not known jet [3]!! Type: %d\n", t_pTag->type);
+                    FiffTag::read_tag_reuse(fid.data(), m_pTagBuffer, thisRawDir.ent.pos);
+                    t_iType = m_pTagBuffer->type;
+                    t_pRawData = m_pTagBuffer->data();
                 }
-            }
-            //
-            //  The picking logic is a bit complicated
-            //
-            if (to >= thisRawDir.last && from <= thisRawDir.first)
-            {
                 //
-                //  We need the whole buffer
+                //   Depending on the state of the projection and selection
+                //   we proceed a little bit differently
                 //
-                first_pick = 0;//1;
-                last_pick  = thisRawDir.nsamp - 1;
-                if (do_debug)
-                    printf("W");
-            }
-            else if (from > thisRawDir.first)
-            {
-                first_pick = from - thisRawDir.first;// + 1;
-                if(to < thisRawDir.last)
+                if (mult.cols() == 0)
                 {
                     //
-                    //  Something from the middle
+                    //   Decode and calibrate the selected channels in one pass, directly into the output
                     //
-//                    qDebug() << "This needs to be debugged!";
-                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
-                    if (do_debug)
-                        printf("M");
+                    if(!decode_raw_buffer(t_pRawData, t_iType, t_bSwap, nchan, first_pick, picksamp, decodeRows, decodeCals, data, dest))
+                        printf("Data Storage Format not known jet [1]!! Type: %d\n", t_iType);
                 }
                 else
                 {
-                    //
-                    //  From the middle to the end
-                    //
-                    last_pick = thisRawDir.nsamp - 1;
-                    if (do_debug)
-                        printf("E");
-                }
-            }
-            else
-            {
-                //
-                //  From the beginning to the middle
-                //
-                first_pick = 0;//1;
-                last_pick  = to - thisRawDir.first;// + 1;
-                if (do_debug)
-                    printf("B");
-            }
-            //
-            //  Now we are ready to pick
-            //
-            picksamp = last_pick - first_pick + 1;
+                    if(!decode_raw_buffer(t_pRawData, t_iType, t_bSwap, nchan, first_pick, picksamp, decodeRows, RowVectorXd(), m_matRawBuffer, 0))
+                        printf("Data Storage Format not known jet [3]!! Type: %d\n", t_iType);
 
-            if(do_debug)
-            {
-                qDebug() << "first_pick: " << first_pick;
-                qDebug() << "last_pick: " << last_pick;
-                qDebug() << "picksamp: " << picksamp;
+                    data.block(0,dest,data.rows(),picksamp).noalias() = multDecoded*m_matRawBuffer.leftCols(picksamp);
+                }
             }
 
-            if (picksamp > 0)
-            {
-//                    for(r = 0; r < data->rows(); ++r)
-//                        for(c = 0; c < picksamp; ++c)
-//                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
-
-                dest += picksamp;
-            }
+            dest += picksamp;
         }
         //
         //  Done?
@@ -424,6 +436,10 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
         }
     }
 
+    if(mult.cols()==0)
+        multSegment = cal;
+    else
+        multSegment = mult;
 //        fclose(fid);
 
     times = MatrixXd(1, to-from+1);
@@ -437,37 +453,181 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
 
 //*************************************************************************************************************
 
-bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, SparseMatrix<double>& multSegment, fiff_int_t from, fiff_int_t to, const RowVectorXi& sel, bool do_debug)
+bool FiffRawData::read_raw_segments(QList<MatrixXd>& data, const RowVectorXi& from, fiff_int_t nsamp, const RowVectorXi& sel)
 {
-    bool projAvailable = true;
+    data.clear();
 
-    if (this->proj.size() == 0)
-        projAvailable = false;
-
-    if(from == -1)
-        from = this->first_samp;
-    if(to == -1)
-        to = this->last_samp;
+    qint32 nseg = from.size();
+    if(nseg == 0)
+        return true;
+    if(nsamp <= 0)
+    {
+        printf("No data in this range\n");
+        return false;
+    }
     //
-    //  Initial checks
+    //  Initial checks, the segments have to be sorted and lie completely within the data
     //
-    if(from < this->first_samp)
-        from = this->first_samp;
-    if(to > this->last_samp)
-        to = this->last_samp;
+    for(qint32 s = 0; s < nseg; ++s)
+    {
+        if(from[s] < this->first_samp || from[s] + nsamp - 1 > this->last_samp || (s > 0 && from[s] < from[s-1]))
+        {
+            printf("Segments have to be sorted and lie within %d ... %d\n", this->first_samp, this->last_samp);
+            return false;
+        }
+    }
+    printf("Reading %d segments of %d samples...", nseg, nsamp);
     //
-    if(from > to)
+    //  The calibration and projection are set up once for all segments
+    //
+    qint32 nchan = this->info.nchan;
+    qint32 nrows = sel.size() > 0 ? sel.size() : nchan;
+
+    SparseMatrix<double> cal, mult, multDecoded;
+    RowVectorXi decodeRows;
+    RowVectorXd decodeCals;
+    make_read_operator(sel, cal, mult, decodeRows, decodeCals, multDecoded);
+
+    data.reserve(nseg);
+    for(qint32 s = 0; s < nseg; ++s)
+        data.append(MatrixXd(nrows, nsamp));
+
+    FiffStream::SPtr fid = this->file;
+    if (!fid->device()->isOpen())
     {
-        printf("No data in this range\n");
-        return false;
+        if (!fid->device()->open(QIODevice::ReadOnly))
+        {
+            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+            return false;
+        }
     }
-    printf("Reading %d ... %d  =  %9.3f ... %9.3f secs...", from, to, ((float)from)/this->info.sfreq, ((float)to)/this->info.sfreq);
+
+    MatrixXd matBuffer;
+    qint32 iFirstSeg = 0;
+    qint32 k = this->find_raw_buffer(from[0]);
+    while(k < this->rawdir.size() && iFirstSeg < nseg)
+    {
+        const FiffRawDir& thisRawDir = this->rawdir[k];
+        //
+        //  Segments are sorted by start and have equal length, so they also end in order
+        //
+        while(iFirstSeg < nseg && from[iFirstSeg] + nsamp - 1 < thisRawDir.first)
+            ++iFirstSeg;
+        if(iFirstSeg == nseg)
+            break;
+        //
+        //  Jump over the buffers between two segments
+        //
+        if(from[iFirstSeg] > thisRawDir.last)
+        {
+            k = this->find_raw_buffer(from[iFirstSeg]);
+            continue;
+        }
+        //
+        //  Range of the buffer which is covered by any segment
+        //
+        qint32 iLastSeg = iFirstSeg;
+        while(iLastSeg + 1 < nseg && from[iLastSeg + 1] <= thisRawDir.last)
+            ++iLastSeg;
+
+        fiff_int_t first_pick = qMax(from[iFirstSeg], thisRawDir.first) - thisRawDir.first;
+        fiff_int_t last_pick = qMin(from[iLastSeg] + nsamp - 1, thisRawDir.last) - thisRawDir.first;
+        fiff_int_t picksamp = last_pick - first_pick + 1;
+        //
+        //  Decode, calibrate and project the buffer once
+        //
+        if (thisRawDir.ent.kind == -1 || (mult.cols() != 0 && multDecoded.cols() == 0))
+        {
+            //
+            //  Skip or an operator which does not depend on any channel, nothing has to be decoded
+            //
+            matBuffer.setZero(nrows, picksamp);
+        }
+        else
+        {
+            const char* t_pRawData = NULL;
+            fiff_int_t t_iType = -1;
+            bool t_bSwap = false;
+            const uchar* t_pMapped = fid->is_mapped() ? fid->mapped_data(thisRawDir.ent.pos, FIFFC_DATA_OFFSET + thisRawDir.ent.size) : NULL;
+            if (t_pMapped)
+            {
+                t_iType = qFromBigEndian<qint32>(t_pMapped + 4);
+                t_pRawData = (const char*)(t_pMapped + FIFFC_DATA_OFFSET);
+                t_bSwap = (Q_BYTE_ORDER == Q_LITTLE_ENDIAN);
+            }
+            else
+            {
+                FiffTag::read_tag_reuse(fid.data(), m_pTagBuffer, thisRawDir.ent.pos);
+                t_iType = m_pTagBuffer->type;
+                t_pRawData = m_pTagBuffer->data();
+            }
+
+            if (mult.cols() == 0)
+            {
+                if(!decode_raw_buffer(t_pRawData, t_iType, t_bSwap, nchan, first_pick, picksamp, decodeRows, decodeCals, matBuffer, 0))
+                {
+                    printf("Data Storage Format not known jet [1]!! Type: %d\n", t_iType);
+                    return false;
+                }
+            }
+            else
+            {
+                if(!decode_raw_buffer(t_pRawData, t_iType, t_bSwap, nchan, first_pick, picksamp, decodeRows, RowVectorXd(), m_matRawBuffer, 0))
+                {
+                    printf("Data Storage Format not known jet [3]!! Type: %d\n", t_iType);
+                    return false;
+                }
+                matBuffer.noalias() = multDecoded*m_matRawBuffer.leftCols(picksamp);
+            }
+        }
+        //
+        //  Scatter the buffer into all segments it overlaps
+        //
+        fiff_int_t buffer_first = thisRawDir.first + first_pick;
+        for(qint32 s = iFirstSeg; s <= iLastSeg; ++s)
+        {
+            fiff_int_t lo = qMax(from[s], buffer_first);
+            fiff_int_t hi = qMin(from[s] + nsamp - 1, thisRawDir.last);
+            if(lo <= hi)
+                data[s].middleCols(lo - from[s], hi - lo + 1) = matBuffer.middleCols(lo - buffer_first, hi - lo + 1);
+        }
+
+        ++k;
+    }
+
+    printf(" [done]\n");
+
+    return true;
+}
+
+//*************************************************************************************************************
+
+qint32 FiffRawData::find_raw_buffer(fiff_int_t sample) const
+{
     //
-    //  Initialize the data and calibration vector
+    //  The raw directory is sorted by sample, do a binary search for the first buffer ending at or after sample
     //
+    qint32 low = 0;
+    qint32 high = this->rawdir.size();
+    while(low < high)
+    {
+        qint32 mid = low + (high - low) / 2;
+        if(this->rawdir[mid].last < sample)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawData::make_read_operator(const RowVectorXi& sel, SparseMatrix<double>& cal, SparseMatrix<double>& mult, RowVectorXi& decodeRows, RowVectorXd& decodeCals, SparseMatrix<double>& multDecoded) const
+{
+    bool projAvailable = this->proj.size() > 0;
     qint32 nchan = this->info.nchan;
-    qint32 dest  = 0;//1;
-    qint32 i, k, r;
+    qint32 i, k;
 
     typedef Eigen::Triplet<double> T;
     std::vector<T> tripletList;
@@ -475,7 +635,7 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, SparseMatrix
     for(i = 0; i < nchan; ++i)
         tripletList.push_back(T(i, i, this->cals[i]));
 
-    SparseMatrix<double> cal(nchan, nchan);
+    cal = SparseMatrix<double>(nchan, nchan);
     cal.setFromTriplets(tripletList.begin(), tripletList.end());
 //    cal.makeCompressed();
 
@@ -483,8 +643,6 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, SparseMatrix
     //
     if (sel.size() == 0)
     {
-        data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
         if (projAvailable || this->comp.kind != -1)
         {
             if (!projAvailable)
@@ -497,9 +655,6 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, SparseMatrix
     }
     else
     {
-        data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
-
         MatrixXd selVect(sel.size(), nchan);
 
         selVect.setZero();
@@ -550,209 +705,68 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, SparseMatrix
             if(mult_full(i,k) != 0)
                 tripletList.push_back(T(i, k, mult_full(i,k)));
 
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
+    mult = SparseMatrix<double>(mult_full.rows(),mult_full.cols());
     if(tripletList.size() > 0)
         mult.setFromTriplets(tripletList.begin(), tripletList.end());
 //    mult.makeCompressed();
 
     //
-
-    FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
+    //  Only the selected channels, or the channels mult depends on, are decoded from the buffers
+    //
+    if (mult.cols() == 0)
     {
-        if (!this->file->device()->open(QIODevice::ReadOnly))
+        if (sel.size() > 0)
         {
-            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+            decodeRows = sel;
+            decodeCals.resize(sel.size());
+            for(i = 0; i < sel.size(); ++i)
+                decodeCals[i] = this->cals[sel[i]];
+        }
+        else
+        {
+            decodeCals = this->cals;
         }
-        fid = this->file;
     }
     else
     {
-        fid = this->file;
-    }
-
-    MatrixXd one;
-    fiff_int_t first_pick, last_pick, picksamp;
-    for(k = 0; k < this->rawdir.size(); ++k)
-    {
-        FiffRawDir thisRawDir = this->rawdir[k];
-        //
-        //  Do we need this buffer
-        //
-        if (thisRawDir.last > from)
+        RowVectorXi usedChannel = RowVectorXi::Constant(nchan, -1);
+        qint32 nused = 0;
+        for(k = 0; k < mult.outerSize(); ++k)
+            for(SparseMatrix<double>::InnerIterator it(mult,k); it; ++it)
+                if(usedChannel[it.col()] == -1)
+                    usedChannel[it.col()] = 0;
+        for(k = 0; k < nchan; ++k)
+            if(usedChannel[k] == 0)
+                usedChannel[k] = nused++;
+
+        if (nused == 0)
         {
-            if (thisRawDir.ent.kind == -1)
-            {
-                //
-                //  Take the easy route: skip is translated to zeros
-                //
-                if(do_debug)
-                    printf("S");
-                if (sel.cols() <= 0)
-                    one.resize(nchan,thisRawDir.nsamp);
-                else
-                    one.resize(sel.cols(),thisRawDir.nsamp);
-
-                one.setZero();
-            }
-            else
-            {
-                FiffTag::SPtr t_pTag;
-                FiffTag::read_tag(fid.data(), t_pTag, thisRawDir.ent.pos);
-                //
-                //   Depending on the state of the projection and selection
-                //   we proceed a little bit differently
-                //
-                if (mult.cols() == 0)
-                {
-                    if (sel.cols() == 0)
-                    {
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                            one = cal*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_INT)
-                            one = cal*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                            one = cal*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else
-                            printf("Data Storage Format not known jet [1]!! Type: %d\n", t_pTag->type);
-                    }
-                    else
-                    {
-
-                        //ToDo find a faster solution for this!! --> make cal and mul sparse like in MATLAB
-                        MatrixXd newData(sel.cols(), thisRawDir.nsamp); //ToDo this can be done much faster, without newData
-
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixDau16 > ( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_INT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXf > ( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else
-                        {
-                            printf("Data Storage Format not known jet [2]!! Type: %d\n", t_pTag->type);
-                        }
-
-                        one = cal*newData;
-                    }
-                }
-                else
-                {
-                    if (t_pTag->type == FIFFT_DAU_PACK16)
-                        one = mult*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_INT)
-                        one = mult*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_FLOAT)
-                        one = mult*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else
-                        printf("Data Storage Format not known jet [3]!! Type: %d\n", t_pTag->type);
-                }
-            }
             //
-            //  The picking logic is a bit complicated
+            //  An empty decodeRows means all channels, so flag the empty selection through multDecoded instead
             //
-            if (to >= thisRawDir.last && from <= thisRawDir.first)
-            {
-                //
-                //  We need the whole buffer
-                //
-                first_pick = 0;//1;
-                last_pick  = thisRawDir.nsamp - 1;
-                if (do_debug)
-                    printf("W");
-            }
-            else if (from > thisRawDir.first)
-            {
-                first_pick = from - thisRawDir.first;// + 1;
-                if(to < thisRawDir.last)
-                {
-                    //
-                    //  Something from the middle
-                    //
-//                    qDebug() << "This needs to be debugged!";
-                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
-                    if (do_debug)
-                        printf("M");
-                }
-                else
-                {
-                    //
-                    //  From the middle to the end
-                    //
-                    last_pick = thisRawDir.nsamp - 1;
-                    if (do_debug)
-                        printf("E");
-                }
-            }
-            else
-            {
-                //
-                //  From the beginning to the middle
-                //
-                first_pick = 0;//1;
-                last_pick  = to - thisRawDir.first;// + 1;
-                if (do_debug)
-                    printf("B");
-            }
-            //
-            //  Now we are ready to pick
-            //
-            picksamp = last_pick - first_pick + 1;
-
-            if(do_debug)
-            {
-                qDebug() << "first_pick: " << first_pick;
-                qDebug() << "last_pick: " << last_pick;
-                qDebug() << "picksamp: " << picksamp;
-            }
-
-            if (picksamp > 0)
-            {
-//                    for(r = 0; r < data->rows(); ++r)
-//                        for(c = 0; c < picksamp; ++c)
-//                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
+            decodeRows.resize(0);
+            multDecoded = SparseMatrix<double>(mult.rows(), 0);
+        }
+        else if (nused < nchan)
+        {
+            decodeRows.resize(nused);
+            for(k = 0; k < nchan; ++k)
+                if(usedChannel[k] >= 0)
+                    decodeRows[usedChannel[k]] = k;
 
-                dest += picksamp;
-            }
+            tripletList.clear();
+            tripletList.reserve(mult.nonZeros());
+            for(k = 0; k < mult.outerSize(); ++k)
+                for(SparseMatrix<double>::InnerIterator it(mult,k); it; ++it)
+                    tripletList.push_back(T(it.row(), usedChannel[it.col()], it.value()));
+            multDecoded = SparseMatrix<double>(mult.rows(), nused);
+            multDecoded.setFromTriplets(tripletList.begin(), tripletList.end());
         }
-        //
-        //  Done?
-        //
-        if (thisRawDir.last >= to)
+        else
         {
-            printf(" [done]\n");
-            break;
+            multDecoded = mult;
         }
     }
-
-    if(mult.cols()==0)
-        multSegment = cal;
-    else
-        multSegment = mult;
-//        fclose(fid);
-
-    times = MatrixXd(1, to-from+1);
-
-    for (i = 0; i < times.cols(); ++i)
-        times(0, i) = ((float)(from+i)) / this->info.sfreq;
-
-    return true;
 }
 
 
@@ -45,6 +45,7 @@
 #include "fiff_info.h"
 #include "fiff_raw_dir.h"
 #include "fiff_stream.h"
+#include "fiff_tag.h"
 
 
 //*************************************************************************************************************
@@ -190,6 +191,32 @@ public:
     */
     bool read_raw_segment_times(MatrixXd& data, MatrixXd& times, float from, float to, const RowVectorXi& sel = defaultRowVectorXi);
 
+    //=========================================================================================================
+    /**
+    * Reads several raw data segments of equal length in one sweep over the file, e.g. the epochs of an
+    * experiment. Every raw buffer is read, calibrated and projected only once and then copied into all segments
+    * which overlap it; buffers between segments are skipped.
+    *
+    * @param[out] data      returns one data matrix (channels x nsamp) per segment
+    * @param[in] from       first sample of each segment, sorted in ascending order
+    * @param[in] nsamp      number of samples per segment
+    * @param[in] sel        channel selection vector (optional)
+    *
+    * @return true if succeeded, false if a segment lies outside of the data or a buffer could not be decoded
+    */
+    bool read_raw_segments(QList<MatrixXd>& data, const RowVectorXi& from, fiff_int_t nsamp, const RowVectorXi& sel = defaultRowVectorXi);
+
+    //=========================================================================================================
+    /**
+    * Looks up the raw directory entry which holds the given sample. Since the raw directory is sorted this is
+    * done by a binary search over the first/last samples of the buffers.
+    *
+    * @param[in] sample     the sample to look up
+    *
+    * @return the index of the first buffer which ends at or after sample, rawdir.size() if sample lies behind the last buffer
+    */
+    qint32 find_raw_buffer(fiff_int_t sample) const;
+
 public:
     FiffStream::SPtr file;      /**< replaces fid */
     FiffInfo info;              /**< Fiff measurement information */
@@ -199,6 +226,24 @@ public:
     QList<FiffRawDir> rawdir;   /**< Special fiff diretory entry for raw data. */
     MatrixXd proj;              /**< SSP operator to apply to the data. */
     FiffCtfComp comp;           /**< Compensator. */
+
+private:
+    //=========================================================================================================
+    /**
+    * Sets up the calibration and the combined compensation/projection/calibration operator for reading the
+    * selected channels.
+    *
+    * @param[in] sel            channel selection vector, empty for all channels
+    * @param[out] cal           calibration matrix
+    * @param[out] mult          combined operator, empty if only calibration has to be applied
+    * @param[out] decodeRows    channels which have to be decoded from the buffers, empty for all channels
+    * @param[out] decodeCals    calibration factors of the decoded channels, used if mult is empty
+    * @param[out] multDecoded   mult restricted to the decoded channels, no columns if mult depends on no channel
+    */
+    void make_read_operator(const RowVectorXi& sel, SparseMatrix<double>& cal, SparseMatrix<double>& mult, RowVectorXi& decodeRows, RowVectorXd& decodeCals, SparseMatrix<double>& multDecoded) const;
+
+    FiffTag::SPtr m_pTagBuffer; /**< Tag which is reused when reading raw data buffers. */
+    MatrixXd m_matRawBuffer;    /**< Decoded raw buffer which is reused when the data have to be projected or picked. */
 };
 
 } // NAMESPACE
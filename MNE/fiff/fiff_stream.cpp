@@ -95,6 +95,8 @@ using namespace UTILSLIB;
 
 FiffStream::FiffStream(QIODevice *p_pIODevice)
 : QDataStream(p_pIODevice)
+, m_pMappedData(NULL)
+, m_iMappedSize(0)
 {
     this->setFloatingPointPrecision(QDataStream::SinglePrecision);
     this->setByteOrder(QDataStream::BigEndian);
@@ -106,6 +108,8 @@ FiffStream::FiffStream(QIODevice *p_pIODevice)
 
 FiffStream::FiffStream(QByteArray * a, QIODevice::OpenMode mode)
 : QDataStream(a, mode)
+, m_pMappedData(NULL)
+, m_iMappedSize(0)
 {
     this->setFloatingPointPrecision(QDataStream::SinglePrecision);
     this->setByteOrder(QDataStream::BigEndian);
@@ -219,6 +223,82 @@ bool FiffStream::get_evoked_entries(const QList<FiffDirNode> &evoked_node, QStri
 }
 
 
+//*************************************************************************************************************
+
+bool FiffStream::is_mapped() const
+{
+    return m_pMappedData != NULL;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::map_file()
+{
+    if(is_mapped())
+        return true;
+
+    QFileDevice* t_pFile = qobject_cast<QFileDevice*>(this->device());
+    if(!t_pFile || t_pFile->fileName().isEmpty())
+    {
+        printf("Only files can be mapped into memory.\n");
+        return false;
+    }
+
+    //
+    //  The mapping uses a file handle of its own. It stays valid when the stream device is closed or reopened,
+    //  e.g. by setup_read_raw, which would otherwise silently release it.
+    //
+    m_pMappedFile = QSharedPointer<QFile>(new QFile(t_pFile->fileName()));
+    if(!m_pMappedFile->open(QIODevice::ReadOnly))
+    {
+        printf("Could not open %s for mapping: %s\n", t_pFile->fileName().toUtf8().constData(), m_pMappedFile->errorString().toUtf8().constData());
+        m_pMappedFile.clear();
+        return false;
+    }
+
+    m_iMappedSize = m_pMappedFile->size();
+    m_pMappedData = m_pMappedFile->map(0, m_iMappedSize);
+    if(!m_pMappedData)
+    {
+        printf("Could not map %s into memory: %s\n", t_pFile->fileName().toUtf8().constData(), m_pMappedFile->errorString().toUtf8().constData());
+        m_pMappedFile.clear();
+        m_iMappedSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+const uchar* FiffStream::mapped_data(qint64 pos, qint64 size) const
+{
+    if(!is_mapped() || pos < 0 || size < 0 || pos + size > m_iMappedSize)
+        return NULL;
+
+    return m_pMappedData + pos;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStream::unmap_file()
+{
+    if(m_pMappedFile)
+    {
+        if(m_pMappedData)
+            m_pMappedFile->unmap(m_pMappedData);
+        m_pMappedFile->close();
+        m_pMappedFile.clear();
+    }
+
+    m_pMappedData = NULL;
+    m_iMappedSize = 0;
+}
+
+
 //*************************************************************************************************************
 
 bool FiffStream::open()
@@ -66,6 +66,7 @@
 
 #include <QByteArray>
 #include <QDataStream>
+#include <QFile>
 #include <QIODevice>
 #include <QList>
 #include <QSharedPointer>
@@ -198,6 +199,43 @@ public:
     */
     bool get_evoked_entries(const QList<FiffDirNode> &evoked_node, QStringList &comments, QList<fiff_int_t> &aspect_kinds, QString &t);
 
+    //=========================================================================================================
+    /**
+    * Returns whether the underlying file is mapped into memory, see map_file.
+    *
+    * @return true if the file is mapped, false otherwise
+    */
+    bool is_mapped() const;
+
+    //=========================================================================================================
+    /**
+    * Maps the whole underlying file into memory. Readers which support it, e.g., FiffRawData::read_raw_segment,
+    * then access the tag data directly in the mapped memory instead of copying them into a FiffTag first.
+    * The device has to be a QFileDevice, it does not have to be open. The file is mapped through a file handle of
+    * its own, so the mapping is independent of opening and closing the stream device. It is released with
+    * unmap_file or when the stream is destroyed.
+    *
+    * @return true if the file could be mapped, false otherwise
+    */
+    bool map_file();
+
+    //=========================================================================================================
+    /**
+    * Returns a pointer into the mapped file.
+    *
+    * @param[in] pos    position in the file
+    * @param[in] size   number of bytes which have to be accessible from pos on
+    *
+    * @return pointer to the mapped data at pos, NULL if the file is not mapped or the range is out of bounds
+    */
+    const uchar* mapped_data(qint64 pos, qint64 size) const;
+
+    //=========================================================================================================
+    /**
+    * Releases the memory mapping created with map_file.
+    */
+    void unmap_file();
+
     //=========================================================================================================
     /**
     * QFile::open
@@ -696,6 +734,9 @@ public:
 private:
     QList<FiffDirEntry> m_dir; /**< This is the directory. If no directory exists, open automatically scans the file to create one. */
     FiffDirNode m_tree;        /**< Directory compiled into a tree */
+    QSharedPointer<QFile> m_pMappedFile;   /**< File handle which holds the mapping. */
+    uchar* m_pMappedData;      /**< Start of the mapped file, NULL if the file is not mapped. */
+    qint64 m_iMappedSize;      /**< Size of the mapped file in bytes. */
 
 //    /** FIFF file handle returned by fiff_open(). */
 //    typedef struct _fiffFileRec {
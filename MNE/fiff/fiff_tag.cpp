@@ -249,6 +249,58 @@ bool FiffTag::read_tag(FiffStream* p_pStream, FiffTag::SPtr& p_pTag, qint64 pos)
 }
 
 
+//*************************************************************************************************************
+
+bool FiffTag::read_tag_reuse(FiffStream* p_pStream, FiffTag::SPtr& p_pTag, qint64 pos)
+{
+    if (!p_pTag)
+        return FiffTag::read_tag(p_pStream, p_pTag, pos);
+
+    if (pos >= 0)
+    {
+        p_pStream->device()->seek(pos);
+    }
+
+    //
+    // Drop the cached complex conversions of the previous tag
+    //
+    if(p_pTag->m_pComplexFloatData)
+    {
+        delete p_pTag->m_pComplexFloatData;
+        p_pTag->m_pComplexFloatData = NULL;
+    }
+    if(p_pTag->m_pComplexDoubleData)
+    {
+        delete p_pTag->m_pComplexDoubleData;
+        p_pTag->m_pComplexDoubleData = NULL;
+    }
+
+    //
+    // Read fiff tag header from stream, resize keeps the allocated memory when the size does not grow
+    //
+    *p_pStream  >> p_pTag->kind;
+    *p_pStream  >> p_pTag->type;
+    qint32 size;
+    *p_pStream  >> size;
+    p_pTag->resize(size);
+    *p_pStream  >> p_pTag->next;
+
+    //
+    // Read data when available
+    //
+    if (p_pTag->size() > 0)
+    {
+        p_pStream->readRawData(p_pTag->data(), p_pTag->size());
+        FiffTag::convert_tag_data(p_pTag,FIFFV_BIG_ENDIAN,FIFFV_NATIVE_ENDIAN);
+    }
+
+    if (p_pTag->next != FIFFV_NEXT_SEQ)
+        p_pStream->device()->seek(p_pTag->next);//fseek(fid,tag.next,'bof');
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 
 fiff_int_t FiffTag::getMatrixCoding() const
@@ -234,6 +234,20 @@ public:
     */
     static bool read_tag(FiffStream* p_pStream, FiffTag::SPtr& p_pTag, qint64 pos = -1);
 
+    //=========================================================================================================
+    /**
+    * Read one tag from a fif file and reuse the memory of an already allocated tag.
+    * Useful when many tags of the same size are read in a row, e.g., raw data buffers. If p_pTag is not
+    * allocated yet a new tag is created.
+    *
+    * @param[in] p_pStream opened fif file
+    * @param[in, out] p_pTag the tag which is reused and which holds the read tag afterwards
+    * @param[in] pos position of the tag inside the fif file
+    *
+    * @return true if succeeded, false otherwise
+    */
+    static bool read_tag_reuse(FiffStream* p_pStream, FiffTag::SPtr& p_pTag, qint64 pos = -1);
+
     //=========================================================================================================
     /**
     * Provides information about matrix coding
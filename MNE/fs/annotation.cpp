@@ -43,6 +43,8 @@
 #include "label.h"
 #include "surface.h"
 
+#include <utils/ioutils.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -68,6 +70,7 @@
 // USED NAMESPACES
 //=============================================================================================================
 
+using namespace UTILSLIB;
 using namespace FSLIB;
 
 
@@ -188,15 +191,17 @@ bool Annotation::read(const QString& p_sFileName, Annotation &p_Annotation)
     qint32 numEl;
     t_Stream >> numEl;
 
-    p_Annotation.m_Vertices = VectorXi(numEl);
-    p_Annotation.m_LabelIds = VectorXi(numEl);
-
-    for(qint32 i = 0; i < numEl; ++i)
+    //vertex and label id pairs, read them as one block
+    MatrixXi t_matVertLabel(2, numEl);
+    if(!IOUtils::read_big_endian_many(t_Stream, t_matVertLabel.data(), t_matVertLabel.size()))
     {
-        t_Stream >> p_Annotation.m_Vertices[i];
-        t_Stream >> p_Annotation.m_LabelIds[i];
+        printf("\tError: Unexpected end of the annotation file\n");
+        return false;
     }
 
+    p_Annotation.m_Vertices = t_matVertLabel.row(0).transpose();
+    p_Annotation.m_LabelIds = t_matVertLabel.row(1).transpose();
+
     qint32 hasColortable;
     t_Stream >> hasColortable;
     if (hasColortable)
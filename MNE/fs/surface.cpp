@@ -275,27 +275,25 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
         else
             printf("\t%s is a new quad file (nvert = %d nquad = %d)\n", p_sFile.toLatin1().constData(),nvert,nquad);
 
-        //vertices
-        verts.resize(nvert, 3);
+        //vertices - stored vertex by vertex, i.e. column by column of a 3 x nvert matrix
+        verts.resize(3, nvert);
         if(magic == QUAD_FILE_MAGIC_NUMBER)
         {
-            qint16 iVal;
-            for(qint32 i = 0; i < nvert; ++i)
+            Matrix<qint16, Dynamic, 1> vals(3*nvert);
+            if(!IOUtils::read_big_endian_many(t_DataStream, vals.data(), vals.size()))
             {
-                for(qint32 j = 0; j < 3; ++j)
-                {
-                    t_DataStream >> iVal;
-                    IOUtils::swap_short(iVal);
-                    verts(i,j) = ((float)iVal) / 100;
-                }
+                qWarning("Unexpected end of surface file %s",p_sFile.toLatin1().constData());
+                return false;
             }
+            verts = Map<Matrix<qint16, Dynamic, Dynamic> >(vals.data(), 3, nvert).cast<float>() / 100.0f;
         }
         else
         {
-            t_DataStream.readRawData((char *)verts.data(), nvert*3*sizeof(float));
-            for(qint32 i = 0; i < nvert; ++i)
-                for(qint32 j = 0; j < 3; ++j)
-                    IOUtils::swap_floatp(&verts(i,j));
+            if(!IOUtils::read_big_endian_many(t_DataStream, verts.data(), verts.size()))
+            {
+                qWarning("Unexpected end of surface file %s",p_sFile.toLatin1().constData());
+                return false;
+            }
         }
 
         MatrixXi quads = IOUtils::fread3_many(t_DataStream, nquad*4);
@@ -356,25 +354,16 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
         printf("\t%s is a triangle file (nvert = %d ntri = %d)\n", p_sFile.toLatin1().constData(), nvert, nface);
         printf("\t%s", s.toLatin1().constData());
 
-        //vertices
+        //vertices and faces are stored vertex by vertex and face by face, read them as blocks
         verts.resize(3, nvert);
-        t_DataStream.readRawData((char *)verts.data(), nvert*3*sizeof(float));
-        for(qint32 i = 0; i < 3; ++i)
-            for(qint32 j = 0; j < nvert; ++j)
-                IOUtils::swap_floatp(&verts(i,j));
-
-        //faces
-        faces.resize(nface, 3);
-        qint32 iVal;
-        for(qint32 i = 0; i < nface; ++i)
+        MatrixXi faces_t(3, nface);
+        if(!IOUtils::read_big_endian_many(t_DataStream, verts.data(), verts.size())
+           || !IOUtils::read_big_endian_many(t_DataStream, faces_t.data(), faces_t.size()))
         {
-            for(qint32 j = 0; j < 3; ++j)
-            {
-                t_DataStream >> iVal;
-                IOUtils::swap_int(iVal);
-                faces(i,j) = iVal;
-            }
+            qWarning("Unexpected end of surface file %s",p_sFile.toLatin1().constData());
+            return false;
         }
+        faces = faces_t.transpose();
     }
     else
     {
@@ -450,22 +439,23 @@ VectorXf Surface::read_curv(const QString &p_sFileName)
         t_DataStream >> vals_per_vertex;
 
         curv.resize(vnum, 1);
-        t_DataStream.readRawData((char *)curv.data(), vnum*sizeof(float));
-        for(qint32 i = 0; i < vnum; ++i)
-           IOUtils::swap_floatp(&curv(i));
+        if(!IOUtils::read_big_endian_many(t_DataStream, curv.data(), vnum))
+        {
+            printf("\tError: Unexpected end of the curvature file\n");
+            return VectorXf();
+        }
     }
     else
     {
         qint32 fnum = IOUtils::fread3(t_DataStream);
         Q_UNUSED(fnum)
-        qint16 iVal;
-        curv.resize(vnum, 1);
-        for(qint32 i = 0; i < vnum; ++i)
+        Matrix<qint16, Dynamic, 1> vals(vnum);
+        if(!IOUtils::read_big_endian_many(t_DataStream, vals.data(), vnum))
         {
-            t_DataStream >> iVal;
-            IOUtils::swap_short(iVal);
-            curv(i) = ((float)iVal) / 100;
+            printf("\tError: Unexpected end of the curvature file\n");
+            return VectorXf();
         }
+        curv = vals.cast<float>() / 100.0f;
     }
     t_File.close();
 
@@ -47,6 +47,7 @@
 //=============================================================================================================
 
 #include <QStringList>
+#include <QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -80,10 +81,13 @@ SurfaceSet::SurfaceSet(const QString &subject_id, qint32 hemi, const QString &su
     }
     else if(hemi == 2)
     {
-        if(Surface::read(subject_id, 0, surf, subjects_dir, t_Surface))
-            insert(t_Surface);
-        if(Surface::read(subject_id, 1, surf, subjects_dir, t_Surface))
-            insert(t_Surface);
+        QStringList t_qListFileName;
+        t_qListFileName << QString("%1/%2/surf/lh.%3").arg(subjects_dir).arg(subject_id).arg(surf)
+                        << QString("%1/%2/surf/rh.%3").arg(subjects_dir).arg(subject_id).arg(surf);
+
+        QList<Surface> t_qListSurfaces = readConcurrently(t_qListFileName);
+        for(qint32 i = 0; i < t_qListSurfaces.size(); ++i)
+            insert(t_qListSurfaces[i]);
     }
 
     calcOffset();
@@ -102,10 +106,13 @@ SurfaceSet::SurfaceSet(const QString &path, qint32 hemi, const QString &surf)
     }
     else if(hemi == 2)
     {
-        if(Surface::read(path, 0, surf, t_Surface))
-            insert(t_Surface);
-        if(Surface::read(path, 1, surf, t_Surface))
-            insert(t_Surface);
+        QStringList t_qListFileName;
+        t_qListFileName << QString("%1/lh.%2").arg(path).arg(surf)
+                        << QString("%1/rh.%2").arg(path).arg(surf);
+
+        QList<Surface> t_qListSurfaces = readConcurrently(t_qListFileName);
+        for(qint32 i = 0; i < t_qListSurfaces.size(); ++i)
+            insert(t_qListSurfaces[i]);
     }
 
     calcOffset();
@@ -178,15 +185,16 @@ bool SurfaceSet::read(const QString& p_sLHFileName, const QString& p_sRHFileName
     QStringList t_qListFileName;
     t_qListFileName << p_sLHFileName << p_sRHFileName;
 
+    QList<Surface> t_qListSurfaces = readConcurrently(t_qListFileName);
+
     for(qint32 i = 0; i < t_qListFileName.size(); ++i)
     {
-        Surface t_Surface;
-        if(Surface::read(t_qListFileName[i], t_Surface))
+        if(!t_qListSurfaces[i].isEmpty())
         {
             if(t_qListFileName[i].contains("lh."))
-                p_SurfaceSet.m_qMapSurfs.insert(0, t_Surface);
+                p_SurfaceSet.m_qMapSurfs.insert(0, t_qListSurfaces[i]);
             else if(t_qListFileName[i].contains("rh."))
-                p_SurfaceSet.m_qMapSurfs.insert(1, t_Surface);
+                p_SurfaceSet.m_qMapSurfs.insert(1, t_qListSurfaces[i]);
             else
                 return false;
         }
@@ -198,6 +206,38 @@ bool SurfaceSet::read(const QString& p_sLHFileName, const QString& p_sRHFileName
 }
 
 
+//*************************************************************************************************************
+
+bool SurfaceSet::read(const QString &subject_id, const QStringList &surfs, const QString &subjects_dir, QList<SurfaceSet> &p_qListSurfaceSets)
+{
+    p_qListSurfaceSets.clear();
+
+    //Read all files at once
+    QStringList t_qListFileName;
+    for(qint32 i = 0; i < surfs.size(); ++i)
+        t_qListFileName << QString("%1/%2/surf/lh.%3").arg(subjects_dir).arg(subject_id).arg(surfs[i])
+                        << QString("%1/%2/surf/rh.%3").arg(subjects_dir).arg(subject_id).arg(surfs[i]);
+
+    QList<Surface> t_qListSurfaces = readConcurrently(t_qListFileName);
+
+    bool bSuccess = true;
+    for(qint32 i = 0; i < surfs.size(); ++i)
+    {
+        SurfaceSet t_SurfaceSet;
+        t_SurfaceSet.insert(t_qListSurfaces[2*i]);
+        t_SurfaceSet.insert(t_qListSurfaces[2*i+1]);
+        t_SurfaceSet.calcOffset();
+
+        if(t_SurfaceSet.isEmpty())
+            bSuccess = false;
+
+        p_qListSurfaceSets.append(t_SurfaceSet);
+    }
+
+    return bSuccess;
+}
+
+
 //*************************************************************************************************************
 
 const Surface& SurfaceSet::operator[] (qint32 idx) const
@@ -279,3 +319,23 @@ void SurfaceSet::calcOffset()
         m_qMapSurfs.find(1).value().offset() = vecRhOffset;
     }
 }
+
+
+//*************************************************************************************************************
+
+QList<Surface> SurfaceSet::readConcurrently(const QStringList &p_qListFileNames)
+{
+    return QtConcurrent::blockingMapped(p_qListFileNames, &SurfaceSet::readSurface);
+}
+
+
+//*************************************************************************************************************
+
+Surface SurfaceSet::readSurface(const QString &p_sFileName)
+{
+    Surface t_Surface;
+    if(!Surface::read(p_sFileName, t_Surface))
+        t_Surface.clear();
+
+    return t_Surface;
+}
@@ -52,6 +52,8 @@
 
 #include <QSharedPointer>
 #include <QMap>
+#include <QList>
+#include <QStringList>
 
 
 //*************************************************************************************************************
@@ -179,6 +181,20 @@ public:
     */
     static bool read(const QString& p_sLHFileName, const QString& p_sRHFileName, SurfaceSet &p_SurfaceSet);
 
+    //=========================================================================================================
+    /**
+    * Reads the left and right hemisphere surfaces of several surface kinds of one subject concurrently and
+    * assembles them to one SurfaceSet per kind
+    *
+    * @param[in] subject_id         Name of subject
+    * @param[in] surfs              Names of the surface kinds to load (eg. inflated, orig ...)
+    * @param[in] subjects_dir       Subjects directory
+    * @param[out] p_qListSurfaceSets    The read surface sets, in the order of surfs
+    *
+    * @return true if at least one hemisphere of every surface kind was read, false otherwise
+    */
+    static bool read(const QString &subject_id, const QStringList &surfs, const QString &subjects_dir, QList<SurfaceSet> &p_qListSurfaceSets);
+
     //=========================================================================================================
     /**
     * The kind of Surfaces which are held by the SurfaceSet (eg. inflated, orig ...)
@@ -242,6 +258,26 @@ private:
     */
     void calcOffset();
 
+    //=========================================================================================================
+    /**
+    * Reads the given surface files concurrently, one thread per file
+    *
+    * @param[in] p_qListFileNames   The surface files
+    *
+    * @return the read surfaces in the order of the files, empty surfaces for files which could not be read
+    */
+    static QList<Surface> readConcurrently(const QStringList &p_qListFileNames);
+
+    //=========================================================================================================
+    /**
+    * Reads one surface file
+    *
+    * @param[in] p_sFileName    The surface file
+    *
+    * @return the read surface, an empty surface if the file could not be read
+    */
+    static Surface readSurface(const QString &p_sFileName);
+
     QMap<qint32, Surface> m_qMapSurfs;  /**< Hemisphere surfaces (lh = 0; rh = 1). */
 };
 
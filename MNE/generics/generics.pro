@@ -72,11 +72,13 @@ else {
 SOURCES += \ 
     circularbuffer.cpp \
     circularmatrixbuffer.cpp \
+    lockfreecircularmatrixbuffer.cpp \
     observerpattern.cpp \
     buffer.cpp
 
 HEADERS += generics_global.h \
     circularmatrixbuffer.h \
+    lockfreecircularmatrixbuffer.h \
     circularbuffer.h \
     observerpattern.h \
     commandpattern.h \
@@ -0,0 +1,612 @@
+//=============================================================================================================
+/**
+* @file     lockfreecircularmatrixbuffer.h
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    LockFreeCircularMatrixBuffer class declaration
+*
+*/
+
+#ifndef LOCKFREECIRCULARMATRIXBUFFER_H
+#define LOCKFREECIRCULARMATRIXBUFFER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+#include "buffer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <typeinfo>
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBUFFER
+//=============================================================================================================
+
+namespace IOBUFFER
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Lock-free single-producer/single-consumer variant of the CircularMatrixBuffer. Exactly one thread may push
+* and exactly one thread may pop. Each matrix occupies one contiguous slot, so matrices are copied with a single
+* memcpy. Additionally to push/pop, slots can be accessed without copying through peekPush/commitPush and
+* peekPop/commitPop. How a thread waits for a free or a filled slot is selected by the WaitStrategy.
+*
+* @brief The lock-free single-producer/single-consumer circular matrix buffer
+*/
+template<typename _Tp>
+class LockFreeCircularMatrixBuffer : public Buffer
+{
+public:
+    typedef QSharedPointer<LockFreeCircularMatrixBuffer> SPtr;              /**< Shared pointer type for LockFreeCircularMatrixBuffer. */
+    typedef QSharedPointer<const LockFreeCircularMatrixBuffer> ConstSPtr;   /**< Const shared pointer type for LockFreeCircularMatrixBuffer. */
+
+    //=========================================================================================================
+    /**
+    * How a thread waits for the other side.
+    */
+    enum WaitStrategy {
+        Spin,       /**< Busy wait, lowest latency but occupies a core. */
+        Yield,      /**< Yield the time slice between the checks. */
+        Block       /**< Sleep on a wait condition, which is only touched when a thread actually waits. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a LockFreeCircularMatrixBuffer. The number of slots is rounded up to the next power of two.
+    *
+    * @param [in] uiMaxNumMatrices  Minimal number of matrices the buffer can hold.
+    * @param [in] uiRows            Number of rows.
+    * @param [in] uiCols            Number of columns.
+    * @param [in] waitStrategy      How push and pop wait for free or filled slots.
+    */
+    explicit LockFreeCircularMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols, WaitStrategy waitStrategy = Block);
+
+    //=========================================================================================================
+    /**
+    * Destroys the LockFreeCircularMatrixBuffer.
+    */
+    ~LockFreeCircularMatrixBuffer();
+
+    //=========================================================================================================
+    /**
+    * Adds a whole matrix at the end buffer. Producer side only.
+    *
+    * @param [in] pMatrix pointer to a Matrix which should be apend to the end.
+    */
+    inline void push(const Matrix<_Tp, Dynamic, Dynamic>* pMatrix);
+
+    //=========================================================================================================
+    /**
+    * Returns the first matrix (first in first out). Consumer side only.
+    *
+    * @return the first matrix
+    */
+    inline Matrix<_Tp, Dynamic, Dynamic> pop();
+
+    //=========================================================================================================
+    /**
+    * Copies the first matrix (first in first out) to matrix, which is only reallocated if its size does not fit.
+    * Consumer side only.
+    *
+    * @param [out] matrix   the first matrix, a zero matrix if the buffer is paused or was released.
+    *
+    * @return true if a matrix was taken from the buffer, false otherwise
+    */
+    inline bool pop(Matrix<_Tp, Dynamic, Dynamic>& matrix);
+
+    //=========================================================================================================
+    /**
+    * Returns a view on the next free slot. The slot is written in place and becomes visible to the consumer
+    * with commitPush. Producer side only.
+    *
+    * @return the view on the free slot
+    */
+    inline Map<Matrix<_Tp, Dynamic, Dynamic> > peekPush();
+
+    //=========================================================================================================
+    /**
+    * Publishes the slot handed out by peekPush.
+    */
+    inline void commitPush();
+
+    //=========================================================================================================
+    /**
+    * Returns a view on the first filled slot (first in first out). The slot stays valid until commitPop is called.
+    * Consumer side only.
+    *
+    * @return the view on the filled slot, a zero matrix if the buffer is paused or was released.
+    */
+    inline Map<const Matrix<_Tp, Dynamic, Dynamic> > peekPop();
+
+    //=========================================================================================================
+    /**
+    * Frees the slot handed out by peekPop.
+    */
+    inline void commitPop();
+
+    //=========================================================================================================
+    /**
+    * Clears the buffer. Must not be called while a producer or consumer is active.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Size of the buffer.
+    */
+    inline quint32 size() const;
+
+    //=========================================================================================================
+    /**
+    * Rows of the stored matrices of the buffer.
+    */
+    inline quint32 rows() const;
+
+    //=========================================================================================================
+    /**
+    * Cols of the stored matrices of the buffer.
+    */
+    inline quint32 cols() const;
+
+    //=========================================================================================================
+    /**
+    * Number of matrices which are currently stored in the buffer.
+    */
+    inline quint32 count() const;
+
+    //=========================================================================================================
+    /**
+    * Sets how push and pop wait for free or filled slots.
+    *
+    * @param [in] waitStrategy  the wait strategy.
+    */
+    inline void setWaitStrategy(WaitStrategy waitStrategy);
+
+    //=========================================================================================================
+    /**
+    * Pauses the buffer. Skpis any incoming matrices and only pops zero matrices.
+    */
+    inline void pause(bool);
+
+    //=========================================================================================================
+    /**
+    * Releases the consumer from waiting in pop(). The waiting pop returns a zero matrix.
+    * @param [out] bool returns true if the consumer had to wait, otherwise false.
+    */
+    inline bool releaseFromPop();
+
+    //=========================================================================================================
+    /**
+    * Releases the producer from waiting in push(). The matrix which is waiting to be pushed is dropped.
+    * @param [out] bool returns true if the producer had to wait, otherwise false.
+    */
+    inline bool releaseFromPush();
+
+private:
+    //=========================================================================================================
+    /**
+    * Waits until the slot count satisfies the condition or the wait is released.
+    *
+    * @param [in] bForData      true waits for a filled slot (consumer), false for a free slot (producer).
+    *
+    * @return false if the wait was released, true otherwise.
+    */
+    inline bool wait(bool bForData);
+
+    //=========================================================================================================
+    /**
+    * Wakes up a thread which is blocked in wait. Cheap if no thread is blocked.
+    */
+    inline void notify();
+
+    unsigned int            m_uiMaxNumMatrices;     /**< Holds the number of slots, a power of two.*/
+    unsigned int            m_uiMask;               /**< Holds the mask which maps a counter to a slot.*/
+    unsigned int            m_uiRows;               /**< Holds the number rows.*/
+    unsigned int            m_uiCols;               /**< Holds the number cols.*/
+    unsigned int            m_uiSlotSize;           /**< Holds the number of elements per slot.*/
+    _Tp*                    m_pBuffer;              /**< Holds the circular buffer.*/
+    _Tp*                    m_pScratch;             /**< Holds a zero slot which is handed out while paused or released.*/
+    QAtomicInteger<quint32> m_uiWriteCount;         /**< Holds the number of pushed matrices, written by the producer only.*/
+    QAtomicInteger<quint32> m_uiReadCount;          /**< Holds the number of popped matrices, written by the consumer only.*/
+    QAtomicInt              m_iReleasePop;          /**< Holds whether the consumer should leave its wait.*/
+    QAtomicInt              m_iReleasePush;         /**< Holds whether the producer should leave its wait.*/
+    QAtomicInt              m_iNumBlocked;          /**< Holds the number of threads which are blocked in the wait condition.*/
+    QMutex                  m_mutexWait;            /**< Holds the mutex of the wait condition.*/
+    QWaitCondition          m_waitCondition;        /**< Holds the wait condition used by the Block strategy.*/
+    WaitStrategy            m_waitStrategy;         /**< Holds the wait strategy.*/
+    bool                    m_bPushPeeked;          /**< Holds whether peekPush handed out a real slot.*/
+    bool                    m_bPopPeeked;           /**< Holds whether peekPop handed out a real slot.*/
+    QAtomicInt              m_iPause;               /**< Holds whether the buffer is paused, set from any thread.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+LockFreeCircularMatrixBuffer<_Tp>::LockFreeCircularMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols, WaitStrategy waitStrategy)
+: Buffer(typeid(_Tp).name())
+, m_uiMaxNumMatrices(1)
+, m_uiRows(uiRows)
+, m_uiCols(uiCols)
+, m_uiSlotSize(uiRows*uiCols)
+, m_pBuffer(NULL)
+, m_pScratch(NULL)
+, m_uiWriteCount(0)
+, m_uiReadCount(0)
+, m_iReleasePop(0)
+, m_iReleasePush(0)
+, m_iNumBlocked(0)
+, m_waitStrategy(waitStrategy)
+, m_bPushPeeked(false)
+, m_bPopPeeked(false)
+, m_iPause(0)
+{
+    while(m_uiMaxNumMatrices < uiMaxNumMatrices)
+        m_uiMaxNumMatrices <<= 1;
+    m_uiMask = m_uiMaxNumMatrices - 1;
+
+    m_pBuffer = new _Tp[m_uiMaxNumMatrices*m_uiSlotSize];
+    m_pScratch = new _Tp[m_uiSlotSize];
+    memset(m_pScratch, 0, m_uiSlotSize*sizeof(_Tp));
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+LockFreeCircularMatrixBuffer<_Tp>::~LockFreeCircularMatrixBuffer()
+{
+    delete [] m_pBuffer;
+    delete [] m_pScratch;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeCircularMatrixBuffer<_Tp>::push(const Matrix<_Tp, Dynamic, Dynamic>* pMatrix)
+{
+    if(m_iPause.loadAcquire() || (unsigned int)pMatrix->size() != m_uiSlotSize)
+        return;
+
+    if(!wait(false))
+        return;
+
+    quint32 uiWrite = m_uiWriteCount.load();
+    memcpy(m_pBuffer + (uiWrite & m_uiMask)*m_uiSlotSize, pMatrix->data(), m_uiSlotSize*sizeof(_Tp));
+    m_uiWriteCount.storeRelease(uiWrite + 1);
+
+    notify();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline Matrix<_Tp, Dynamic, Dynamic> LockFreeCircularMatrixBuffer<_Tp>::pop()
+{
+    Matrix<_Tp, Dynamic, Dynamic> matrix(m_uiRows, m_uiCols);
+    pop(matrix);
+    return matrix;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool LockFreeCircularMatrixBuffer<_Tp>::pop(Matrix<_Tp, Dynamic, Dynamic>& matrix)
+{
+    if((unsigned int)matrix.rows() != m_uiRows || (unsigned int)matrix.cols() != m_uiCols)
+        matrix.resize(m_uiRows, m_uiCols);
+
+    if(m_iPause.loadAcquire() || !wait(true))
+    {
+        matrix.setZero();
+        return false;
+    }
+
+    quint32 uiRead = m_uiReadCount.load();
+    memcpy(matrix.data(), m_pBuffer + (uiRead & m_uiMask)*m_uiSlotSize, m_uiSlotSize*sizeof(_Tp));
+    m_uiReadCount.storeRelease(uiRead + 1);
+
+    notify();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline Map<Matrix<_Tp, Dynamic, Dynamic> > LockFreeCircularMatrixBuffer<_Tp>::peekPush()
+{
+    m_bPushPeeked = !m_iPause.loadAcquire() && wait(false);
+
+    _Tp* pSlot = m_bPushPeeked ? m_pBuffer + (m_uiWriteCount.load() & m_uiMask)*m_uiSlotSize : m_pScratch;
+    return Map<Matrix<_Tp, Dynamic, Dynamic> >(pSlot, m_uiRows, m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeCircularMatrixBuffer<_Tp>::commitPush()
+{
+    if(!m_bPushPeeked)
+    {
+        //The scratch slot might have been written, reset it since it is also handed out to the consumer
+        memset(m_pScratch, 0, m_uiSlotSize*sizeof(_Tp));
+        return;
+    }
+
+    m_bPushPeeked = false;
+    m_uiWriteCount.storeRelease(m_uiWriteCount.load() + 1);
+
+    notify();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline Map<const Matrix<_Tp, Dynamic, Dynamic> > LockFreeCircularMatrixBuffer<_Tp>::peekPop()
+{
+    m_bPopPeeked = !m_iPause.loadAcquire() && wait(true);
+
+    const _Tp* pSlot = m_bPopPeeked ? m_pBuffer + (m_uiReadCount.load() & m_uiMask)*m_uiSlotSize : m_pScratch;
+    return Map<const Matrix<_Tp, Dynamic, Dynamic> >(pSlot, m_uiRows, m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeCircularMatrixBuffer<_Tp>::commitPop()
+{
+    if(!m_bPopPeeked)
+        return;
+
+    m_bPopPeeked = false;
+    m_uiReadCount.storeRelease(m_uiReadCount.load() + 1);
+
+    notify();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool LockFreeCircularMatrixBuffer<_Tp>::wait(bool bForData)
+{
+    QAtomicInt& iRelease = bForData ? m_iReleasePop : m_iReleasePush;
+
+    forever
+    {
+        quint32 uiCount = m_uiWriteCount.loadAcquire() - m_uiReadCount.loadAcquire();
+        if(bForData ? uiCount > 0 : uiCount < m_uiMaxNumMatrices)
+            return true;
+
+        if(iRelease.testAndSetOrdered(1, 0))
+            return false;
+
+        switch(m_waitStrategy)
+        {
+            case Spin:
+                break;
+            case Yield:
+                QThread::yieldCurrentThread();
+                break;
+            case Block:
+                //Register as blocked before checking again, notify only locks the mutex if somebody is registered
+                m_iNumBlocked.fetchAndAddOrdered(1);
+                m_mutexWait.lock();
+                uiCount = m_uiWriteCount.loadAcquire() - m_uiReadCount.loadAcquire();
+                if((bForData ? uiCount == 0 : uiCount >= m_uiMaxNumMatrices) && iRelease.loadAcquire() == 0)
+                    m_waitCondition.wait(&m_mutexWait, 10);
+                m_mutexWait.unlock();
+                m_iNumBlocked.fetchAndAddOrdered(-1);
+                break;
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeCircularMatrixBuffer<_Tp>::notify()
+{
+    if(m_iNumBlocked.fetchAndAddOrdered(0) > 0)
+    {
+        m_mutexWait.lock();
+        m_waitCondition.wakeAll();
+        m_mutexWait.unlock();
+    }
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void LockFreeCircularMatrixBuffer<_Tp>::clear()
+{
+    m_uiWriteCount.storeRelease(0);
+    m_uiReadCount.storeRelease(0);
+    m_iReleasePop.storeRelease(0);
+    m_iReleasePush.storeRelease(0);
+    m_bPushPeeked = false;
+    m_bPopPeeked = false;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeCircularMatrixBuffer<_Tp>::size() const
+{
+    return m_uiMaxNumMatrices;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeCircularMatrixBuffer<_Tp>::rows() const
+{
+    return m_uiRows;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeCircularMatrixBuffer<_Tp>::cols() const
+{
+    return m_uiCols;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeCircularMatrixBuffer<_Tp>::count() const
+{
+    return m_uiWriteCount.loadAcquire() - m_uiReadCount.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeCircularMatrixBuffer<_Tp>::setWaitStrategy(WaitStrategy waitStrategy)
+{
+    m_waitStrategy = waitStrategy;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeCircularMatrixBuffer<_Tp>::pause(bool bPause)
+{
+    m_iPause.storeRelease(bPause ? 1 : 0);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool LockFreeCircularMatrixBuffer<_Tp>::releaseFromPop()
+{
+    if(count() == 0)
+    {
+        m_iReleasePop.storeRelease(1);
+        m_mutexWait.lock();
+        m_waitCondition.wakeAll();
+        m_mutexWait.unlock();
+        return true;
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool LockFreeCircularMatrixBuffer<_Tp>::releaseFromPush()
+{
+    if(count() >= m_uiMaxNumMatrices)
+    {
+        m_iReleasePush.storeRelease(1);
+        m_mutexWait.lock();
+        m_waitCondition.wakeAll();
+        m_mutexWait.unlock();
+        return true;
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef GENERICSSHARED_EXPORT LockFreeCircularMatrixBuffer<float>        _float_LockFreeCircularMatrixBuffer;      /**< Defines LockFreeCircularMatrixBuffer of float type.*/
+typedef GENERICSSHARED_EXPORT LockFreeCircularMatrixBuffer<double>       _double_LockFreeCircularMatrixBuffer;     /**< Defines LockFreeCircularMatrixBuffer of double type.*/
+
+} // NAMESPACE
+
+#endif // LOCKFREECIRCULARMATRIXBUFFER_H
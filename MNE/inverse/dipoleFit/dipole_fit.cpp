@@ -4,8 +4,15 @@
 
 #include "dipolefit_helpers.h"
 
+#include <Eigen/Core>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace INVERSELIB;
+using namespace Eigen;
 
 
 //*************************************************************************************************************
@@ -39,12 +46,93 @@ using namespace INVERSELIB;
 
 #define SEG_LEN 10.0
 
+#define FIT_BATCH_SIZE 500      /* Number of time points scored and fitted together in the multi-threaded mode */
+
 
 //*************************************************************************************************************
 //=============================================================================================================
 // STATIC DEFINITIONS ToDo make members
 //=============================================================================================================
 
+static int fit_batch(const QList<DipoleFitData*>& fits,  /* Fitting data, one per worker thread */
+                     GuessData*   guess,                  /* The initial guesses */
+                     const VectorXf& times,               /* Times of the time points */
+                     MatrixXf&    B,                      /* The measured data (channels x time points) */
+                     QVector<bool>& picked,               /* Were the time points picked successfully? */
+                     int          verbose,
+                     int&         nfitted,                /* Number of fitted dipoles so far (for reporting) */
+                     ECDSet&      set)                    /* The fitted dipoles are appended here */
+/*
+ * Fit a batch of time points with a pool of workers
+ */
+{
+    int    ntime = times.size();
+    int    report_interval = 10;
+    int    j;
+    VectorXi best;
+    VectorXf good;
+    /*
+     * Project and whiten all time points, unusable ones are zeroed so that they cannot select a guess
+     */
+    for (j = 0; j < ntime; j++) {
+        if (picked[j] && !DipoleFitData::project_and_whiten(fits.first(),B.col(j).data()))
+            picked[j] = false;
+        if (!picked[j])
+            B.col(j).setZero();
+    }
+    /*
+     * Score all guesses against all time points at once
+     */
+    if (!guess->find_best_guesses(B,FIT_GUESS_LIMIT,best,good))
+        return FAIL;
+
+    QVector<ECD>  dips(ntime);
+    QVector<char> fitted(ntime,FALSE);
+    ECD  *dipp    = dips.data();
+    char *fittedp = fitted.data();
+    const bool *pickedp = picked.constData();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(fits.size())
+#endif
+    {
+        DipoleFitData* fit = fits.first();
+#ifdef _OPENMP
+        fit = fits.at(omp_get_thread_num());
+#pragma omp for schedule(dynamic)
+#endif
+        for (int k = 0; k < ntime; k++) {
+            if (!pickedp[k] || best[k] < 0)
+                continue;
+            fittedp[k] = DipoleFitData::fit_one_from_guess(fit,guess,times[k],B.col(k).data(),best[k],verbose,dipp[k]);
+            if (fittedp[k] && !verbose) {
+#ifdef _OPENMP
+#pragma omp critical (fit_batch_report)
+#endif
+                {
+                    if (++nfitted % report_interval == 0)
+                        fprintf(stderr,"%d..",nfitted);
+                }
+            }
+        }
+    }
+    /*
+     * Merge the results in time order
+     */
+    for (j = 0; j < ntime; j++) {
+        if (!picked[j])
+            continue;
+        if (!fitted[j])
+            printf("t = %7.1f ms : %s\n",1000*times[j],"error (tbd: catch)");
+        else {
+            set.addEcd(dips[j]);
+            if (verbose)
+                dips[j].print(stdout);
+        }
+    }
+    return OK;
+}
+
 
 
 //*************************************************************************************************************
@@ -69,6 +157,8 @@ ECDSet DipoleFit::calculateFit() const
     mneMeasData         data     = NULL;
     mneRawData          raw      = NULL;
     mneChSelection      sel      = NULL;
+    QList<DipoleFitData*> fits;
+    int                 nthreads = 1;
 
     printf("---- Setting up...\n\n");
     if (settings->include_eeg) {
@@ -88,6 +178,30 @@ ECDSet DipoleFit::calculateFit() const
         goto out;
 
     fit_data->fit_mag_dipoles = settings->fit_mag_dipoles;
+    fits.append(fit_data);
+    /*
+    * The forward computations keep work areas in the fitting data, each worker thread needs its own set up copy
+    */
+#ifdef _OPENMP
+    nthreads = settings->nthreads > 0 ? settings->nthreads : omp_get_max_threads();
+#endif
+    if (nthreads > 1)
+        printf("\n---- Setting up the fitting data for %d threads...\n\n",nthreads);
+    while (fits.size() < nthreads) {
+        DipoleFitData* thread_fit_data;
+        if ((thread_fit_data = setup_dipole_fit_data(settings->mriname,
+                                                     settings->measname,
+                                                     settings->bemname.isEmpty() ? NULL : settings->bemname.toLatin1().data(),
+                                                     &settings->r0,eeg_model,settings->accurate,
+                                                     settings->badname,
+                                                     settings->noisename,
+                                                     settings->grad_std,settings->mag_std,settings->eeg_std,
+                                                     settings->mag_reg,settings->grad_reg,settings->eeg_reg,
+                                                     settings->diagnoise,settings->projnames,settings->include_meg,settings->include_eeg)) == NULL)
+            goto out;
+        thread_fit_data->fit_mag_dipoles = settings->fit_mag_dipoles;
+        fits.append(thread_fit_data);
+    }
     if (settings->is_raw) {
         int c;
         float t1,t2;
@@ -141,8 +255,9 @@ ECDSet DipoleFit::calculateFit() const
                settings->setno,settings->measname.toLatin1().data(),fit_data->nmeg,fit_data->neeg);
         if (!settings->noisename.isEmpty()) {
             printf("\nScaling the noise covariance...\n");
-            if (scale_noise_cov(fit_data,data->current->nave) == FAIL)
-                goto out;
+            for (int k = 0; k < fits.size(); k++)
+                if (scale_noise_cov(fits[k],data->current->nave) == FAIL)
+                    goto out;
         }
     }
 
@@ -160,11 +275,11 @@ ECDSet DipoleFit::calculateFit() const
 
 
     if (raw) {
-        if (fit_dipoles_raw(settings->measname,raw,sel,fit_data,guess,settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose) == FAIL)
+        if (fit_dipoles_raw(settings->measname,raw,sel,fits,guess,settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
             goto out;
     }
     else {
-        if (fit_dipoles(settings->measname,data,fit_data,guess,settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
+        if (fit_dipoles(settings->measname,data,fits,guess,settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
             goto out;
     }
     printf("%d dipoles fitted\n",set.size());
@@ -220,6 +335,52 @@ int DipoleFit::fit_dipoles( const QString& dataname, mneMeasData data, DipoleFit
 }
 
 
+//*************************************************************************************************************
+
+int DipoleFit::fit_dipoles( const QString& dataname, mneMeasData data, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
+{
+    float time;
+    ECDSet set;
+    int   s,j,ntime,nfitted;
+
+    if (fits.isEmpty())
+        return FAIL;
+    if (fits.size() == 1)
+        return fit_dipoles(dataname,data,fits.first(),guess,tmin,tmax,tstep,integ,verbose,p_set);
+
+    set.dataname = dataname;
+
+    for (ntime = 0, time = tmin; time < tmax; ntime++, time = tmin + ntime*tstep)
+        ;
+
+    fprintf(stderr,"Fitting with %d threads...%c",fits.size(),verbose ? '\n' : '\0');
+    nfitted = 0;
+    for (s = 0; s < ntime; s += FIT_BATCH_SIZE) {
+        int nbatch = qMin(FIT_BATCH_SIZE,ntime-s);
+        VectorXf      times(nbatch);
+        MatrixXf      B(data->nchan,nbatch);
+        QVector<bool> picked(nbatch,true);
+        /*
+     * Pick the data points
+     */
+        for (j = 0; j < nbatch; j++) {
+            times[j] = tmin + (s+j)*tstep;
+            if (mne_get_values_from_data(times[j],integ,data->current->data,data->current->np,data->nchan,data->current->tmin,
+                                         1.0/data->current->tstep,FALSE,B.col(j).data()) == FAIL) {
+                fprintf(stderr,"Cannot pick time: %7.1f ms\n",1000*times[j]);
+                picked[j] = false;
+            }
+        }
+        if (fit_batch(fits,guess,times,B,picked,verbose,nfitted,set) == FAIL)
+            return FAIL;
+    }
+    if (!verbose)
+        fprintf(stderr,"[done]\n");
+    p_set = set;
+    return OK;
+}
+
+
 //*************************************************************************************************************
 
 int DipoleFit::fit_dipoles_raw(const QString& dataname, mneRawData raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
@@ -294,6 +455,88 @@ bad : {
 }
 
 
+//*************************************************************************************************************
+
+int DipoleFit::fit_dipoles_raw(const QString& dataname, mneRawData raw, mneChSelection sel, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
+{
+    if (fits.isEmpty())
+        return FAIL;
+    if (fits.size() == 1)
+        return fit_dipoles_raw(dataname,raw,sel,fits.first(),guess,tmin,tmax,tstep,integ,verbose,p_set);
+
+    float sfreq   = raw->info->sfreq;
+    float myinteg = integ > 0.0 ? 2*integ : 0.1;
+    int   overlap = ceil(myinteg*sfreq);
+    int   length  = SEG_LEN*sfreq;
+    int   step    = length - overlap;
+    int   stepo   = step + overlap/2;
+    int   start   = raw->first_samp;
+    int   s,picks,nbatch,nfitted;
+    float time,stime;
+    float **data  = ALLOC_CMATRIX(sel->nchan,length);
+    ECDSet set;
+    VectorXf      times(FIT_BATCH_SIZE);
+    MatrixXf      B(sel->nchan,FIT_BATCH_SIZE);
+    QVector<bool> picked(FIT_BATCH_SIZE,true);
+
+    set.dataname = dataname;
+
+    /*
+   * Load the initial data segment
+   */
+    stime = start/sfreq;
+    if (mne_raw_pick_data_filt(raw,sel,start,length,data) == FAIL)
+        goto bad;
+    fprintf(stderr,"Fitting with %d threads...%c",fits.size(),verbose ? '\n' : '\0');
+    nbatch  = 0;
+    nfitted = 0;
+    for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
+        picks = time*sfreq - start;
+        if (picks > stepo) {		/* Need a new data segment? */
+            start = start + step;
+            if (mne_raw_pick_data_filt(raw,sel,start,length,data) == FAIL)
+                goto bad;
+            picks = time*sfreq - start;
+            stime = start/sfreq;
+        }
+        /*
+     * Get the values, the data are read by this thread only
+     */
+        times[nbatch]  = time;
+        picked[nbatch] = true;
+        if (mne_get_values_from_data_ch (time,integ,data,length,sel->nchan,stime,sfreq,FALSE,B.col(nbatch).data()) == FAIL) {
+            fprintf(stderr,"Cannot pick time: %8.3f s\n",time);
+            picked[nbatch] = false;
+        }
+        /*
+     * Fit a full batch
+     */
+        if (++nbatch == FIT_BATCH_SIZE) {
+            if (fit_batch(fits,guess,times,B,picked,verbose,nfitted,set) == FAIL)
+                goto bad;
+            nbatch = 0;
+        }
+    }
+    if (nbatch > 0) {
+        VectorXf      last_times = times.head(nbatch);
+        MatrixXf      last_B     = B.leftCols(nbatch);
+        QVector<bool> last_picked = picked.mid(0,nbatch);
+        if (fit_batch(fits,guess,last_times,last_B,last_picked,verbose,nfitted,set) == FAIL)
+            goto bad;
+    }
+    if (!verbose)
+        fprintf(stderr,"[done]\n");
+    FREE_CMATRIX(data);
+    p_set = set;
+    return OK;
+
+bad : {
+        FREE_CMATRIX(data);
+        return FAIL;
+    }
+}
+
+
 //*************************************************************************************************************
 
 int DipoleFit::fit_dipoles_raw(const QString& dataname, mneRawData raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose)
@@ -55,6 +55,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QList>
 
 
 
@@ -122,6 +123,29 @@ public:
     */
     static int fit_dipoles( const QString& dataname, mneMeasData data, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
 
+    //=========================================================================================================
+    /**
+    *
+    * Fit a single dipole to each time point of the data using one worker thread per entry of fits. The time
+    * points are processed in batches: the initial guesses of a batch are scored with a single matrix product
+    * (GuessData::find_best_guesses) and the simplex fits are distributed over the workers. The fitted dipoles are
+    * stored in time order.
+    *
+    * @param[in] dataname
+    * @param[in] data       The measured data
+    * @param[in] fits       Precomputed fitting data, one independently set up instance per worker thread
+    * @param[in] guess      The initial guesses
+    * @param[in] tmin       Time range
+    * @param[in] tmax
+    * @param[in] tstep      Time step to use
+    * @param[in] integ      Integration time
+    * @param[in] verbose    Verbose output?
+    * @param[out] p_set     the fitted ECD Set
+    *
+    * @return true when successful
+    */
+    static int fit_dipoles( const QString& dataname, mneMeasData data, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
+
     //=========================================================================================================
     /**
     *
@@ -144,6 +168,28 @@ public:
     */
     static int fit_dipoles_raw(const QString& dataname, mneRawData raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
 
+    //=========================================================================================================
+    /**
+    *
+    * Fit a single dipole to each time point of the raw data using one worker thread per entry of fits.
+    * The data segments are read by the calling thread, see the multi-threaded fit_dipoles for the details.
+    *
+    * @param[in] dataname
+    * @param[in] raw        The raw data description
+    * @param[in] sel        Channel selection to use
+    * @param[in] fits       Precomputed fitting data, one independently set up instance per worker thread
+    * @param[in] guess      The initial guesses
+    * @param[in] tmin       Time range
+    * @param[in] tmax
+    * @param[in] tstep      Time step to use
+    * @param[in] integ      Integration time
+    * @param[in] verbose    Verbose output?
+    * @param[out] p_set     Return all results here. Warning: for large data files this may take a lot of memory
+    *
+    * @return true when successful
+    */
+    static int fit_dipoles_raw(const QString& dataname, mneRawData raw, mneChSelection sel, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
+
     //=========================================================================================================
     /**
     *
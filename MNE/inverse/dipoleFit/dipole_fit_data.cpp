@@ -457,14 +457,14 @@ int mne_get_values_from_data_3 (float time,         /* Interesting time point */
 
 
 
-int mne_proj_op_proj_vector_3(mneProjOp op, float *vec, int nvec, int do_complement)
+int mne_proj_op_proj_vector_3(mneProjOp op, float *vec, int nvec, int do_complement, float **work)
 /*
       * Apply projection operator to a vector (floats)
       * Assume that all dimension checking etc. has been done before
+      * The work area (nvec floats) is allocated on first use and kept by the caller
       */
 {
-    static float *res = NULL;
-    int    res_size   = 0;
+    float *res = NULL;
     float *pvec;
     float  w;
     int k,p;
@@ -477,10 +477,12 @@ int mne_proj_op_proj_vector_3(mneProjOp op, float *vec, int nvec, int do_complem
         return FAIL;
     }
 
-    if (op->nch > res_size) {
-        res = REALLOC_3(res,op->nch,float);
-        res_size = op->nch;
-    }
+    /*
+     * The workspace belongs to the caller so that several fits can run concurrently
+     */
+    if (!*work)
+        *work = MALLOC_3(op->nch,float);
+    res = *work;
 
     for (k = 0; k < op->nch; k++)
         res[k] = 0.0;
@@ -1128,10 +1130,53 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
                     int           verbose,
                     ECD&          res               /* The fitted dipole */
                     )
+{
+    int   best;
+    float good;
+    int   nchan = fit->nmeg+fit->neeg;
+
+    if (!project_and_whiten(fit,B))
+        return false;
+    /*
+   * Get the initial guess
+   */
+    if (find_best_guess(B,nchan,guess,FIT_GUESS_LIMIT,&best,&good) < 0)
+        return false;
+
+    return fit_one_from_guess(fit,guess,time,B,best,verbose,res);
+}
+
+
+//*************************************************************************************************************
+
+bool DipoleFitData::project_and_whiten(DipoleFitData* fit, float *B)
+{
+    int nchan = fit->nmeg+fit->neeg;
+
+    if (mne_proj_op_proj_vector_3(fit->proj,B,nchan,TRUE,&fit->proj_work) == FAIL)
+        return false;
+
+    if (mne_whiten_one_data(B,B,nchan,fit->noise) == FAIL)
+        return false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool DipoleFitData::fit_one_from_guess(DipoleFitData* fit,    /* Precomputed fitting data */
+                                       GuessData*     guess, /* The initial guesses */
+                                       float         time,   /* Which time is it? */
+                                       float         *B,     /* The projected and whitened field to fit */
+                                       int           best,   /* Index of the initial guess */
+                                       int           verbose,
+                                       ECD&          res     /* The fitted dipole */
+                                       )
 {
     float  **simplex       = NULL;	       /* The simplex */
     float  vals[4];			       /* Values at the vertices */
-    float  limit           = 0.2;	               /* (pseudo) radial component omission limit */
+    float  limit           = FIT_GUESS_LIMIT;     /* (pseudo) radial component omission limit */
     float  size            = 1e-2;	       /* Size of the initial simplex */
     float  ftol[]          = { 1e-2, 1e-2 };     /* Tolerances on the the two passes */
     float  atol[]          = { 0.2e-3, 0.2e-3 }; /* If dipole movement between two iterations is less than this,
@@ -1140,8 +1185,7 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     int    max_eval        = 1000;	       /* Limit for fit function evaluations */
     int    report_interval = verbose ? 1 : -1;   /* How often to report the intermediate result */
 
-    int        best;
-    float      good,rd_guess[3],rd_final[3],Q[3],final_val;
+    float      rd_guess[3],rd_final[3],Q[3],final_val;
     fitDipUserRec user;
     int        k,p,neval,neval_tot,nchan,ncomp;
     int        fit_fail;
@@ -1149,18 +1193,9 @@ bool DipoleFitData::fit_one(DipoleFitData* fit,	            /* Precomputed fitti
     nchan = fit->nmeg+fit->neeg;
     user.fwd = NULL;
 
-    if (mne_proj_op_proj_vector_3(fit->proj,B,nchan,TRUE) == FAIL)
+    if (best < 0 || best >= guess->nguess)
         goto bad;
 
-    if (mne_whiten_one_data(B,B,nchan,fit->noise) == FAIL)
-        goto bad;
-    /*
-   * Get the initial guess
-   */
-    if (find_best_guess(B,nchan,guess,limit,&best,&good) < 0)
-        goto bad;
-
-
     user.limit = limit;
     user.B     = B;
     user.B2    = mne_dot_vectors_3(B,B,nchan);
@@ -1318,7 +1353,7 @@ int DipoleFitData::compute_dipole_field(DipoleFitData* d, float *rd, int whiten,
 #endif
 
     for (k = 0; k < 3; k++)
-        if (mne_proj_op_proj_vector_3(d->proj,fwd[k],d->nmeg+d->neeg,TRUE) == FAIL)
+        if (mne_proj_op_proj_vector_3(d->proj,fwd[k],d->nmeg+d->neeg,TRUE,&d->proj_work) == FAIL)
             goto bad;
 
 #ifdef DEBUG
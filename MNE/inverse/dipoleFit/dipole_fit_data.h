@@ -69,6 +69,8 @@
 #define COLUMN_NORM_COMP 1	    /* Componentwise normalization */
 #define COLUMN_NORM_LOC  2	    /* Dipole locationwise normalization */
 
+#define FIT_GUESS_LIMIT  0.2f     /* (Pseudo) radial component omission limit used when scoring the guesses and fitting */
+
 
 /*
  * These are the type definitions for dipole fitting
@@ -148,6 +150,35 @@ public:
     */
     static bool fit_one(DipoleFitData* fit, GuessData* guess, float time, float *B, int verbose, ECD& res);
 
+    //=========================================================================================================
+    /**
+    * Apply the projection and the whitening to a measured field in place. This is the preprocessing fit_one
+    * applies before the guess selection and the fitting.
+    *
+    * @param[in] fit        Precomputed fitting data
+    * @param[in, out] B     The field to project and whiten
+    *
+    * @return true when successful
+    */
+    static bool project_and_whiten(DipoleFitData* fit, float *B);
+
+    //=========================================================================================================
+    /**
+    * Fit a single dipole to projected and whitened data, starting from a given initial guess. The guess is usually
+    * selected for many time points at once with GuessData::find_best_guesses.
+    *
+    * @param[in] fit        Precomputed fitting data
+    * @param[in] guess      The initial guesses
+    * @param[in] time       Which time is it?
+    * @param[in] B          The projected and whitened field to fit
+    * @param[in] best       Index of the initial guess to start from
+    * @param[in] verbose
+    * @param[in] res        The fitted dipole
+    *
+    * @return true when successful
+    */
+    static bool fit_one_from_guess(DipoleFitData* fit, GuessData* guess, float time, float *B, int best, int verbose, ECD& res);
+
 
 
 //============================= dipole_forward.c
@@ -193,6 +224,7 @@ public:
       mneCovMatrix      noise;              /**< Noise covariance matrix (weighted to take the selection into account) */
       int               nave;               /**< How many averages does this correspond to? */
       mneProjOp         proj;               /**< The projection operator to use */
+      float             *proj_work;         /**< Work area for applying the projection, one per fitting data so that fits can run concurrently */
       int               column_norm;        /**< What kind of column normalization to apply to the forward solution */
       int               fit_mag_dipoles;    /**< Fit magnetic dipoles? */
       void              *user;              /**< User data for anything we need */
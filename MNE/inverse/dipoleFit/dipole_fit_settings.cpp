@@ -236,6 +236,7 @@ void DipoleFitSettings::usage(char *name)
     printf("\t--mindist dist/mm Exclude points which are closer than this distance from the inner skull surface  (default = %6.1f mm).\n",1000*guess_mindist);
     printf("\t--grid    dist/mm Source space grid size (default = %6.1f mm).\n",1000*guess_grid);
     printf("\t--magdip          Fit magnetic dipoles instead of current dipoles.\n");
+    printf("\t--threads n       Number of threads used for fitting (0 = one per core, default = %d).\n",nthreads);
     printf("\nOutput:\n\n");
     printf("\t--dip     name    xfit dip format output file name\n");
     printf("\t--bdip    name    xfit bdip format output file name\n");
@@ -769,6 +770,21 @@ bool DipoleFitSettings::check_args (int *argc,char **argv)
             }
             bdipname = QString(argv[k+1]);
         }
+        else if (strcmp(argv[k],"--threads") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical ("--threads: argument required.");
+                return false;
+            }
+            if (sscanf(argv[k+1],"%d",&nthreads) != 1) {
+                qCritical() << "Incomprehensible number of threads:" << argv[k+1];
+                return false;
+            }
+            if (nthreads < 0) {
+                qCritical ("Number of threads must be >= 0");
+                return false;
+            }
+        }
         else if (strcmp(argv[k],"--verbose") == 0) {
             found = 1;
             verbose = true;
@@ -168,6 +168,7 @@ public:
     bool  do_baseline  = false;         /**< Are both baseline limits set? */
     int   setno        = 1;             /**< Which data set */
     bool  verbose      = false;
+    int   nthreads     = 1;             /**< Number of fitting threads (0 = one per core) */
     mneFilterDefRec     filter;
     QList<QString> projnames;           /**< Projection file names */
     bool omit_data_proj = false;
@@ -13938,6 +13938,7 @@ DipoleFitData* new_dipole_fit_data()
     res->user          = NULL;
     res->user_free     = NULL;
     res->proj          = NULL;
+    res->proj_work     = NULL;
 
     res->sphere_funcs     = NULL;
     res->bem_funcs        = NULL;
@@ -13972,6 +13973,7 @@ void free_dipole_fit_data(DipoleFitData* d)
         d->user_free(d->user);
 
     mne_free_proj_op(d->proj);
+    FREE(d->proj_work);
 
     free_dipole_fit_funcs(d->sphere_funcs);
     free_dipole_fit_funcs(d->bem_funcs);
@@ -76,6 +76,7 @@ using namespace INVERSELIB;
 //=============================================================================================================
 
 GuessData::GuessData()
+: guess_basis_limit(-1.0f)
 {
 
 }
@@ -111,6 +112,7 @@ bool GuessData::compute_guess_fields(DipoleFitData* f)
         return false;
     }
     printf("Go through all guess source locations...");
+    guess_basis.resize(0,0);
     orig = f->funcs;
     if (f->fit_mag_dipoles)
         f->funcs = f->mag_dipole_funcs;
@@ -132,3 +134,55 @@ bool GuessData::compute_guess_fields(DipoleFitData* f)
 
     return true;
 }
+
+
+//*************************************************************************************************************
+
+bool GuessData::find_best_guesses(const MatrixXf& matB, float limit, VectorXi& vecBest, VectorXf& vecGood)
+{
+    int nch = matB.rows();
+    int k,c;
+
+    if (this->nguess <= 0) {
+        qCritical("No guesses available in find_best_guesses");
+        return false;
+    }
+    /*
+     * Stack the left singular vectors once, omitting the pseudoradial component where find_best_guess would
+     */
+    if (guess_basis.rows() != 3*this->nguess || guess_basis.cols() != nch || guess_basis_limit != limit) {
+        guess_basis = MatrixXf::Zero(3*this->nguess,nch);
+        for (k = 0; k < this->nguess; k++) {
+            DipoleForward* fwd = this->guess_fwd[k];
+            if (fwd->nch != nch)
+                continue;
+            int ncomp = fwd->sing[2]/fwd->sing[0] > limit ? 3 : 2;
+            for (c = 0; c < ncomp; c++)
+                guess_basis.row(3*k+c) = Map<RowVectorXf>(fwd->uu[c],nch);
+        }
+        guess_basis_limit = limit;
+    }
+    /*
+     * Projections of all time points onto all guess fields
+     */
+    MatrixXf matProj = guess_basis*matB;
+    VectorXf vecB2 = matB.colwise().squaredNorm().transpose();
+
+    vecBest.setConstant(matB.cols(),-1);
+    vecGood.setZero(matB.cols());
+
+    for (int t = 0; t < matB.cols(); t++) {
+        if (vecB2(t) <= 0.0f)
+            continue;
+        for (k = 0; k < this->nguess; k++) {
+            float Bm2 = matProj.block(3*k,t,3,1).squaredNorm();
+            float this_good = Bm2/vecB2(t);
+            if (this_good > vecGood(t)) {
+                vecBest(t) = k;
+                vecGood(t) = this_good;
+            }
+        }
+    }
+
+    return true;
+}
@@ -119,6 +119,21 @@ public:
     */
     bool compute_guess_fields(DipoleFitData* f);
 
+    //=========================================================================================================
+    /**
+    * Select the best initial guess for many time points at once. The goodness of fit of every guess location for
+    * every time point is evaluated with a single matrix product of the stacked left singular vectors of the guess
+    * fields and the data. The result is equivalent to scoring every time point separately up to float rounding.
+    *
+    * @param[in] matB       The projected and whitened data (channels x time points)
+    * @param[in] limit      Pseudoradial component omission limit
+    * @param[out] vecBest   Index of the best guess for every time point (-1 if no reasonable guess was found)
+    * @param[out] vecGood   Goodness of fit of the best guess for every time point
+    *
+    * @return true when successful
+    */
+    bool find_best_guesses(const Eigen::MatrixXf& matB, float limit, Eigen::VectorXi& vecBest, Eigen::VectorXf& vecGood);
+
 
 
 
@@ -127,6 +142,8 @@ public:
     float          **rr;            /**< These are the guess dipole locations */
     DipoleForward** guess_fwd;      /**< Forward solutions for the guesses */
     int            nguess;          /**< How many sources */
+    Eigen::MatrixXf guess_basis;    /**< Stacked left singular vectors of the guess fields (3*nguess x channels), used by find_best_guesses */
+    float          guess_basis_limit; /**< Omission limit guess_basis was built with */
 
 // ### OLD STRUCT ###
 //    typedef struct {
@@ -60,6 +60,14 @@
 #include <Eigen/Core>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define BATCH_COLS 8192     /**< Number of data columns which are multiplied with the kernel at once. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -242,6 +250,167 @@ MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin
 }
 
 
+//*************************************************************************************************************
+
+QList<MNESourceEstimate> MinimumNorm::calculateInverse(const QList<MatrixXd> &p_qListData, const QList<float> &p_qListTmin, float tstep, bool p_bUseFloat) const
+{
+    if(p_qListData.size() != p_qListTmin.size())
+    {
+        qWarning("MinimumNorm::calculateInverse - Number of data blocks and start times do not match.");
+        return QList<MNESourceEstimate>();
+    }
+
+    QList<const MatrixXd*> t_qListData;
+    for(qint32 i = 0; i < p_qListData.size(); ++i)
+        t_qListData.append(&p_qListData[i]);
+
+    if(p_bUseFloat)
+        return applyKernelBatched<float>(t_qListData, p_qListTmin, tstep, VectorXi());
+    else
+        return applyKernelBatched<double>(t_qListData, p_qListTmin, tstep, VectorXi());
+}
+
+
+//*************************************************************************************************************
+
+QList<MNESourceEstimate> MinimumNorm::calculateInverse(const MNEEpochDataList &p_epochDataList, const FiffInfo &p_info, bool p_bUseFloat) const
+{
+    if(!inverseSetup)
+    {
+        qWarning("Inverse not setup -> call doInverseSetup first!");
+        return QList<MNESourceEstimate>();
+    }
+
+    //
+    //   Pick the channels of the inverse operator
+    //
+    const QStringList &t_qListChNames = inv.noise_cov->names;
+    VectorXi t_vecPicks(t_qListChNames.size());
+    for(qint32 i = 0; i < t_qListChNames.size(); ++i)
+    {
+        t_vecPicks[i] = p_info.ch_names.indexOf(t_qListChNames[i]);
+        if(t_vecPicks[i] < 0)
+        {
+            qWarning("MinimumNorm::calculateInverse - Channel %s of the inverse operator is missing in the data.", t_qListChNames[i].toLatin1().constData());
+            return QList<MNESourceEstimate>();
+        }
+    }
+
+    QList<const MatrixXd*> t_qListData;
+    QList<float> t_qListTmin;
+    for(qint32 i = 0; i < p_epochDataList.size(); ++i)
+    {
+        t_qListData.append(&p_epochDataList[i]->epoch);
+        t_qListTmin.append(p_epochDataList[i]->tmin);
+    }
+
+    float tstep = 1.0f / p_info.sfreq;
+
+    if(p_bUseFloat)
+        return applyKernelBatched<float>(t_qListData, t_qListTmin, tstep, t_vecPicks);
+    else
+        return applyKernelBatched<double>(t_qListData, t_qListTmin, tstep, t_vecPicks);
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+QList<MNESourceEstimate> MinimumNorm::applyKernelBatched(const QList<const MatrixXd*> &p_qListData, const QList<float> &p_qListTmin, float tstep, const VectorXi &p_vecPicks) const
+{
+    typedef Matrix<T, Dynamic, Dynamic> MatrixXT;
+
+    QList<MNESourceEstimate> p_qListSourceEstimates;
+
+    if(!inverseSetup)
+    {
+        qWarning("Inverse not setup -> call doInverseSetup first!");
+        return p_qListSourceEstimates;
+    }
+
+    qint32 nchan = m_matBatchKernel.cols();
+    qint32 nitems = p_qListData.size();
+
+    //
+    //   Check dimensions and find the chunk size
+    //
+    qint32 t_iChunkCols = BATCH_COLS;
+    for(qint32 i = 0; i < nitems; ++i)
+    {
+        if((p_vecPicks.size() == 0 && p_qListData[i]->rows() != nchan) || (p_vecPicks.size() > 0 && p_qListData[i]->rows() <= p_vecPicks.maxCoeff()))
+        {
+            qWarning("MinimumNorm::calculateInverse - Data block %d does not match the channels of the inverse operator.", i);
+            return p_qListSourceEstimates;
+        }
+        if(p_qListData[i]->cols() > t_iChunkCols)
+            t_iChunkCols = p_qListData[i]->cols();
+    }
+
+    VectorXi p_vecVertices(inv.src[0].vertno.size() + inv.src[1].vertno.size());
+    p_vecVertices << inv.src[0].vertno, inv.src[1].vertno;
+
+    bool t_bCombine = inv.source_ori == FIFFV_MNE_FREE_ORI;
+    qint32 nsol = t_bCombine ? m_matBatchKernel.rows() / 3 : m_matBatchKernel.rows();
+
+    MatrixXT t_matKernel = m_matBatchKernel.template cast<T>();
+
+    // Chunk buffers, allocated once for the whole batch
+    MatrixXT t_matData(nchan, t_iChunkCols);
+    MatrixXT t_matSol(m_matBatchKernel.rows(), t_iChunkCols);
+
+    qint32 i = 0;
+    while(i < nitems)
+    {
+        //
+        //   Gather as many blocks as fit into one chunk
+        //
+        qint32 t_iFirst = i;
+        qint32 t_iCols = 0;
+        while(i < nitems && t_iCols + p_qListData[i]->cols() <= t_iChunkCols)
+        {
+            const MatrixXd &data = *p_qListData[i];
+            if(p_vecPicks.size() > 0)
+                for(qint32 k = 0; k < nchan; ++k)
+                    t_matData.row(k).segment(t_iCols, data.cols()) = data.row(p_vecPicks[k]).template cast<T>();
+            else
+                t_matData.block(0, t_iCols, nchan, data.cols()) = data.template cast<T>();
+            t_iCols += data.cols();
+            ++i;
+        }
+
+        //
+        //   One matrix product for the whole chunk
+        //
+        t_matSol.leftCols(t_iCols).noalias() = t_matKernel * t_matData.leftCols(t_iCols);
+
+        //
+        //   Scatter into the source estimates
+        //
+        t_iCols = 0;
+        for(qint32 j = t_iFirst; j < i; ++j)
+        {
+            qint32 ncols = p_qListData[j]->cols();
+            MatrixXd sol(nsol, ncols);
+            if(t_bCombine)
+            {
+                for(qint32 c = 0; c < ncols; ++c)
+                    for(qint32 r = 0; r < nsol; ++r)
+                        sol(r, c) = sqrt((double)t_matSol.col(t_iCols + c).template segment<3>(3*r).squaredNorm());
+            }
+            else
+                sol = t_matSol.block(0, t_iCols, nsol, ncols).template cast<double>();
+
+            p_qListSourceEstimates.append(MNESourceEstimate(sol, p_vecVertices, p_qListTmin[j], tstep));
+            t_iCols += ncols;
+        }
+    }
+
+    printf("Computed %d source estimates in batched mode.\n", p_qListSourceEstimates.size());
+
+    return p_qListSourceEstimates;
+}
+
+
 //*************************************************************************************************************
 
 void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
@@ -256,6 +425,23 @@ void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
 
     std::cout << "K " << K.rows() << " x " << K.cols() << std::endl;
 
+    //
+    //   Fold the noise normalization into the kernel for the batched application. The normalization
+    //   factors are positive, so for free orientations they can be applied to each xyz triplet before
+    //   the components are combined.
+    //
+    m_matBatchKernel = K;
+    if(m_bdSPM || m_bsLORETA)
+    {
+        qint32 t_iStride = (inv.source_ori == FIFFV_MNE_FREE_ORI) ? 3 : 1;
+        VectorXd t_vecNoiseNorm = inv.noisenorm.diagonal();
+        if(t_vecNoiseNorm.size() * t_iStride == m_matBatchKernel.rows())
+            for(qint32 i = 0; i < m_matBatchKernel.rows(); ++i)
+                m_matBatchKernel.row(i) *= t_vecNoiseNorm[i / t_iStride];
+        else
+            qWarning("MinimumNorm::doInverseSetup - Noise normalization does not match the kernel, batched estimates are not normalized.");
+    }
+
     inverseSetup = true;
 }
 
@@ -45,9 +45,11 @@
 #include "../IInverseAlgorithm.h"
 
 #include <mne/mne_inverse_operator.h>
+#include <mne/mne_epoch_data_list.h>
 #include <fs/label.h>
 
 #include <QSharedPointer>
+#include <QList>
 
 
 //*************************************************************************************************************
@@ -127,6 +129,35 @@ public:
 
     virtual MNESourceEstimate calculateInverse(const MatrixXd &data, float tmin, float tstep) const;
 
+    //=========================================================================================================
+    /**
+    * Applies the prepared imaging kernel to many data blocks at once. The blocks are concatenated into
+    * large column chunks, so that every chunk is a single matrix product with the kernel. The noise
+    * normalization is folded into the kernel beforehand. doInverseSetup has to be called first.
+    *
+    * @param[in] p_qListData    Data blocks, rows have to match the channels of the prepared inverse operator.
+    * @param[in] p_qListTmin    Start time of each data block.
+    * @param[in] tstep          Time between two samples.
+    * @param[in] p_bUseFloat    Whether to compute the matrix products in single precision (optional, default = false).
+    *
+    * @return the source estimates, one for each data block
+    */
+    QList<MNESourceEstimate> calculateInverse(const QList<MatrixXd> &p_qListData, const QList<float> &p_qListTmin, float tstep, bool p_bUseFloat = false) const;
+
+    //=========================================================================================================
+    /**
+    * Applies the prepared imaging kernel to all epochs of an epoch list in large batched matrix products.
+    * The channels of the prepared inverse operator are picked while the epochs are gathered, so the epochs
+    * are not copied beforehand. doInverseSetup has to be called first.
+    *
+    * @param[in] p_epochDataList    The epochs.
+    * @param[in] p_info             Measurement info describing the rows of the epochs.
+    * @param[in] p_bUseFloat        Whether to compute the matrix products in single precision (optional, default = false).
+    *
+    * @return the source estimates, one for each epoch
+    */
+    QList<MNESourceEstimate> calculateInverse(const MNEEpochDataList &p_epochDataList, const FiffInfo &p_info, bool p_bUseFloat = false) const;
+
     virtual void doInverseSetup(qint32 nave, bool pick_normal = false);
 
 
@@ -170,6 +201,20 @@ public:
     inline MatrixXd& getKernel();
 
 private:
+    //=========================================================================================================
+    /**
+    * Batched kernel application in the given precision, see calculateInverse.
+    *
+    * @param[in] p_qListData    Data blocks.
+    * @param[in] p_qListTmin    Start time of each data block.
+    * @param[in] tstep          Time between two samples.
+    * @param[in] p_vecPicks     Rows of the data blocks which correspond to the kernel channels, empty to use all rows.
+    *
+    * @return the source estimates, one for each data block
+    */
+    template<typename T>
+    QList<MNESourceEstimate> applyKernelBatched(const QList<const MatrixXd*> &p_qListData, const QList<float> &p_qListTmin, float tstep, const VectorXi &p_vecPicks) const;
+
     MNEInverseOperator m_inverseOperator;   /**< The inverse operator */
     float m_fLambda;                        /**< Regularization parameter */
     QString m_sMethod;                      /**< Selected method */
@@ -182,6 +227,7 @@ private:
     QList<VectorXi> vertno;                 /**< The vertices numbers */
     Label label;                            /**< The corresponding labels */
     MatrixXd K;                             /**< Imaging kernel */
+    MatrixXd m_matBatchKernel;              /**< Imaging kernel with the noise normalization folded in, used by the batched calculateInverse */
 
 };
 
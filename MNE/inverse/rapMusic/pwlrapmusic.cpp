@@ -179,14 +179,15 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement
 
     MatrixXT t_matProj_Phi_s(t_matOrthProj.rows(), t_pMatPhi_s->cols());
     //new Version: Calculate projection before
-    MatrixXT t_matProj_LeadField(m_ForwardSolution.sol->data.rows(), m_ForwardSolution.sol->data.cols());
+    MatrixXT t_matProj_LeadField(m_bHierarchical ? 0 : m_ForwardSolution.sol->data.rows(), m_bHierarchical ? 0 : m_ForwardSolution.sol->data.cols());
 
     for(int r = 0; r < t_iMaxSearch ; ++r)
     {
         t_matProj_Phi_s = t_matOrthProj*(*t_pMatPhi_s);
 
         //new Version: Calculating Projection before
-        t_matProj_LeadField = t_matOrthProj * m_ForwardSolution.sol->data;//Subtract the found sources from the current found source
+        if(!m_bHierarchical)
+            t_matProj_LeadField = t_matOrthProj * m_ForwardSolution.sol->data;//Subtract the found sources from the current found source
 
         //###First Option###
         //Step 1: lt. Mosher 1998 -> Maybe tmp_Proj_Phi_S is already orthogonal -> so no SVD needed -> U_B = tmp_Proj_Phi_S;
@@ -195,7 +196,7 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement
         useFullRank(t_svdProj_Phi_S.matrixU(), t_svdProj_Phi_S.singularValues().asDiagonal(), t_matU_B);
 
         //Inits
-        VectorXT t_vecRoh(m_iNumLeadFieldCombinations,1);
+        VectorXT t_vecRoh(m_bHierarchical ? 0 : m_iNumLeadFieldCombinations,1);
         t_vecRoh.setZero();
 
         //subcorr benchmark
@@ -221,6 +222,13 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement
 
         int t_iNumVecElements = m_iNumGridPoints;
 
+        //The coarse-to-fine search replaces the Powell search
+        if(m_bHierarchical)
+        {
+            t_val_roh_k = scanPairs(t_matOrthProj, t_matU_B, t_iIdx1, t_iIdx2);
+            t_iMaxFound = 1;
+        }
+
         while(t_iMaxFound == 0)
         {
 
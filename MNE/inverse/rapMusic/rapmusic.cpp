@@ -41,6 +41,9 @@
 
 #include <utils/mnemath.h>
 
+#include <algorithm>
+#include <vector>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -67,6 +70,10 @@ RapMusic::RapMusic()
 , m_iNumLeadFieldCombinations(0)
 , m_ppPairIdxCombinations(NULL)
 , m_iMaxNumThreads(1)
+, m_scanMode(ScanGram)
+, m_bHierarchical(false)
+, m_iBeamWidth(16)
+, m_bExhaustiveFallback(false)
 , m_bIsInit(false)
 , m_iSamplesStcWindow(-1)
 , m_fStcOverlap(-1)
@@ -84,6 +91,10 @@ RapMusic::RapMusic(MNEForwardSolution& p_pFwd, bool p_bSparsed, int p_iN, double
 , m_iNumLeadFieldCombinations(0)
 , m_ppPairIdxCombinations(NULL)
 , m_iMaxNumThreads(1)
+, m_scanMode(ScanGram)
+, m_bHierarchical(false)
+, m_iBeamWidth(16)
+, m_bExhaustiveFallback(false)
 , m_bIsInit(false)
 , m_iSamplesStcWindow(-1)
 , m_fStcOverlap(-1)
@@ -453,70 +464,26 @@ MNESourceEstimate RapMusic::calculateInverse(const MatrixXd& p_matMeasurement, Q
     std::cout << "##### Calculation of RAP MUSIC started ######\n\n";
 
     MatrixXT t_matProj_Phi_s(t_matOrthProj.rows(), t_pMatPhi_s->cols());
-    //new Version: Calculate projection before
-    MatrixXT t_matProj_LeadField(m_ForwardSolution.sol->data.rows(), m_ForwardSolution.sol->data.cols());
 
     for(int r = 0; r < t_iMaxSearch ; ++r)
     {
         t_matProj_Phi_s = t_matOrthProj*(*t_pMatPhi_s);
 
-        //new Version: Calculating Projection before
-        t_matProj_LeadField = t_matOrthProj * m_ForwardSolution.sol->data;//Subtract the found sources from the current found source
-
         //###First Option###
         //Step 1: lt. Mosher 1998 -> Maybe tmp_Proj_Phi_S is already orthogonal -> so no SVD needed -> U_B = tmp_Proj_Phi_S;
         Eigen::JacobiSVD< MatrixXT > t_svdProj_Phi_S(t_matProj_Phi_s, Eigen::ComputeThinU);
         MatrixXT t_matU_B;
         useFullRank(t_svdProj_Phi_S.matrixU(), t_svdProj_Phi_S.singularValues().asDiagonal(), t_matU_B);
 
-        //Inits
-        VectorXT t_vecRoh(m_iNumLeadFieldCombinations,1);
-        t_vecRoh.setZero();
-
         //subcorr benchmark
         //Stop the time
         clock_t start_subcorr, end_subcorr;
         start_subcorr = clock();
 
-        //Multithreading correlation calculation
-        #ifdef _OPENMP
-        #pragma omp parallel num_threads(m_iMaxNumThreads)
-        #endif
-        {
-        #ifdef _OPENMP
-        #pragma omp for
-        #endif
-            for(int i = 0; i < m_iNumLeadFieldCombinations; i++)
-            {
-                //new Version: calculate matrix multiplication before
-                //Create Lead Field combinations -> It would be better to use a pointer construction, to increase performance
-                MatrixX6T t_matProj_G(t_matProj_LeadField.rows(),6);
-
-                int idx1 = m_ppPairIdxCombinations[i]->x1;
-                int idx2 = m_ppPairIdxCombinations[i]->x2;
-
-                RapMusic::getGainMatrixPair(t_matProj_LeadField, t_matProj_G, idx1, idx2);
-
-                t_vecRoh(i) = RapMusic::subcorr(t_matProj_G, t_matU_B);//t_vecRoh holds the correlations roh_k
-            }
-        }
-
-
-//         if(r==0)
-//         {
-//             std::fstream filestr;
-//             std::stringstream filename;
-//             filename << "Roh_gold.txt";
-//
-//             filestr.open ( filename.str().c_str(), std::fstream::out);
-//             for(int i = 0; i < m_iNumLeadFieldCombinations; ++i)
-//             {
-//               filestr << t_vecRoh(i) << "\n";
-//             }
-//             filestr.close();
-//
-//             //exit(0);
-//         }
+        //Scan the dipole pairs for the maximal correlation
+        int t_iIdx1 = -1;
+        int t_iIdx2 = -1;
+        double t_val_roh_k = scanPairs(t_matOrthProj, t_matU_B, t_iIdx1, t_iIdx2);
 
         //subcorr benchmark
         end_subcorr = clock();
@@ -524,17 +491,6 @@ MNESourceEstimate RapMusic::calculateInverse(const MatrixXd& p_matMeasurement, Q
         float t_fSubcorrElapsedTime = ( (float)(end_subcorr-start_subcorr) / (float)CLOCKS_PER_SEC ) * 1000.0f;
         std::cout << "Time Elapsed: " << t_fSubcorrElapsedTime << " ms" << std::endl;
 
-        //Find the maximum of correlation - can't put this in the for loop because it's running in different threads.
-        double t_val_roh_k;
-
-        VectorXT::Index t_iMaxIdx;
-
-        t_val_roh_k = t_vecRoh.maxCoeff(&t_iMaxIdx);//p_vecCor = ^roh_k
-
-        //get positions in sparsed leadfield from index combinations;
-        int t_iIdx1 = m_ppPairIdxCombinations[t_iMaxIdx]->x1;
-        int t_iIdx2 = m_ppPairIdxCombinations[t_iMaxIdx]->x2;
-
         // (Idx+1) because of MATLAB positions -> starting with 1 not with 0
         std::cout << "Iteration: " << r+1 << " of " << t_iMaxSearch
             << "; Correlation: " << t_val_roh_k<< "; Position (Idx+1): " << t_iIdx1+1 << " - " << t_iIdx2+1 <<"\n\n";
@@ -751,6 +707,289 @@ double RapMusic::subcorr(MatrixX6T& p_matProj_G, const MatrixXT& p_matU_B, Vecto
 }
 
 
+//*************************************************************************************************************
+
+double RapMusic::scanPairs(const MatrixXT& p_matOrthProj, const MatrixXT& p_matU_B, int &p_iIdx1, int &p_iIdx2) const
+{
+    if(m_bHierarchical)
+    {
+        if(m_scanMode == ScanGramFloat)
+            return scanHierarchical<float>(p_matOrthProj, p_matU_B, p_iIdx1, p_iIdx2);
+        else
+            return scanHierarchical<double>(p_matOrthProj, p_matU_B, p_iIdx1, p_iIdx2);
+    }
+
+    return scanExhaustive(p_matOrthProj, p_matU_B, p_iIdx1, p_iIdx2);
+}
+
+
+//*************************************************************************************************************
+
+double RapMusic::scanExhaustive(const MatrixXT& p_matOrthProj, const MatrixXT& p_matU_B, int &p_iIdx1, int &p_iIdx2) const
+{
+    //new Version: Calculating Projection before
+    MatrixXT t_matProj_LeadField = p_matOrthProj * m_ForwardSolution.sol->data;//Subtract the found sources from the current found source
+
+    //Inits
+    VectorXT t_vecRoh(m_iNumLeadFieldCombinations,1);
+    t_vecRoh.setZero();
+
+    //Multithreading correlation calculation
+    if(m_scanMode == ScanSVD)
+    {
+    #ifdef _OPENMP
+    #pragma omp parallel num_threads(m_iMaxNumThreads)
+    #endif
+        {
+        #ifdef _OPENMP
+        #pragma omp for
+        #endif
+            for(int i = 0; i < m_iNumLeadFieldCombinations; i++)
+            {
+                //new Version: calculate matrix multiplication before
+                //Create Lead Field combinations -> It would be better to use a pointer construction, to increase performance
+                MatrixX6T t_matProj_G(t_matProj_LeadField.rows(),6);
+
+                int idx1 = m_ppPairIdxCombinations[i]->x1;
+                int idx2 = m_ppPairIdxCombinations[i]->x2;
+
+                RapMusic::getGainMatrixPair(t_matProj_LeadField, t_matProj_G, idx1, idx2);
+
+                t_vecRoh(i) = RapMusic::subcorr(t_matProj_G, p_matU_B);//t_vecRoh holds the correlations roh_k
+            }
+        }
+    }
+    else if(m_scanMode == ScanGramFloat)
+    {
+        SubcorrGram<float> t_gram;
+        calcSubcorrGram(t_matProj_LeadField, p_matU_B, t_gram);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(m_iMaxNumThreads) schedule(static, 4096)
+    #endif
+        for(int i = 0; i < m_iNumLeadFieldCombinations; i++)
+            t_vecRoh(i) = RapMusic::subcorr(t_gram, m_ppPairIdxCombinations[i]->x1, m_ppPairIdxCombinations[i]->x2);
+    }
+    else
+    {
+        SubcorrGram<double> t_gram;
+        calcSubcorrGram(t_matProj_LeadField, p_matU_B, t_gram);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(m_iMaxNumThreads) schedule(static, 4096)
+    #endif
+        for(int i = 0; i < m_iNumLeadFieldCombinations; i++)
+            t_vecRoh(i) = RapMusic::subcorr(t_gram, m_ppPairIdxCombinations[i]->x1, m_ppPairIdxCombinations[i]->x2);
+    }
+
+    //Find the maximum of correlation - can't put this in the for loop because it's running in different threads.
+    VectorXT::Index t_iMaxIdx;
+
+    double t_val_roh_k = t_vecRoh.maxCoeff(&t_iMaxIdx);//p_vecCor = ^roh_k
+
+    //get positions in sparsed leadfield from index combinations;
+    p_iIdx1 = m_ppPairIdxCombinations[t_iMaxIdx]->x1;
+    p_iIdx2 = m_ppPairIdxCombinations[t_iMaxIdx]->x2;
+
+    return t_val_roh_k;
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+double RapMusic::scanHierarchical(const MatrixXT& p_matOrthProj, const MatrixXT& p_matU_B, int &p_iIdx1, int &p_iIdx2) const
+{
+    //
+    // Coarse level: scan all pairs
+    //
+    int t_iNumCoarsePoints = m_matCoarseGain.cols()/3;
+    int t_iNumCoarseCombinations = MNEMath::nchoose2(t_iNumCoarsePoints+1);
+
+    MatrixXT t_matProj_CoarseGain = p_matOrthProj * m_matCoarseGain;
+
+    SubcorrGram<T> t_gramCoarse;
+    calcSubcorrGram(t_matProj_CoarseGain, p_matU_B, t_gramCoarse);
+
+    VectorXT t_vecRohCoarse(t_iNumCoarseCombinations);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(m_iMaxNumThreads) schedule(static, 4096)
+    #endif
+    for(int i = 0; i < t_iNumCoarseCombinations; ++i)
+    {
+        int idx1, idx2;
+        RapMusic::getPointPair(t_iNumCoarsePoints, i, idx1, idx2);
+        t_vecRohCoarse(i) = RapMusic::subcorr(t_gramCoarse, idx1, idx2);
+    }
+
+    //Keep the best coarse pairs, ties are resolved by the lower index
+    int t_iBeamWidth = m_iBeamWidth < t_iNumCoarseCombinations ? m_iBeamWidth : t_iNumCoarseCombinations;
+
+    std::vector< std::pair<double, int> > t_vecCoarseOrder(t_iNumCoarseCombinations);
+    for(int i = 0; i < t_iNumCoarseCombinations; ++i)
+        t_vecCoarseOrder[i] = std::pair<double, int>(-t_vecRohCoarse(i), i);
+    std::partial_sort(t_vecCoarseOrder.begin(), t_vecCoarseOrder.begin() + t_iBeamWidth, t_vecCoarseOrder.end());
+
+    //
+    // Fine level: all pairs of the member grid points of the kept coarse pairs
+    //
+    QVector<int> t_vecPoints;                               //grid points which are needed
+    QVector<int> t_vecLocalIdx(m_iNumGridPoints, -1);       //grid point -> position in t_vecPoints
+    std::vector<Pair> t_vecCandidates;
+
+    for(int b = 0; b < t_iBeamWidth; ++b)
+    {
+        int c1, c2;
+        RapMusic::getPointPair(t_iNumCoarsePoints, t_vecCoarseOrder[b].second, c1, c2);
+
+        const Eigen::VectorXi& t_vecMembers1 = m_qListCoarseMembers[c1];
+        const Eigen::VectorXi& t_vecMembers2 = m_qListCoarseMembers[c2];
+
+        for(int i = 0; i < t_vecMembers1.size(); ++i)
+        {
+            for(int j = 0; j < t_vecMembers2.size(); ++j)
+            {
+                int p1 = t_vecMembers1[i] < t_vecMembers2[j] ? t_vecMembers1[i] : t_vecMembers2[j];
+                int p2 = t_vecMembers1[i] < t_vecMembers2[j] ? t_vecMembers2[j] : t_vecMembers1[i];
+
+                //pairs within one coarse grid point are only visited once
+                if(c1 == c2 && t_vecMembers1[i] > t_vecMembers2[j])
+                    continue;
+
+                if(t_vecLocalIdx[p1] < 0)
+                {
+                    t_vecLocalIdx[p1] = t_vecPoints.size();
+                    t_vecPoints.append(p1);
+                }
+                if(t_vecLocalIdx[p2] < 0)
+                {
+                    t_vecLocalIdx[p2] = t_vecPoints.size();
+                    t_vecPoints.append(p2);
+                }
+
+                Pair t_pair;
+                t_pair.x1 = p1;
+                t_pair.x2 = p2;
+                t_vecCandidates.push_back(t_pair);
+            }
+        }
+    }
+
+    double t_dRohCoarse = -t_vecCoarseOrder[0].first;
+    double t_val_roh_k = -1.0;
+
+    if(!t_vecCandidates.empty())
+    {
+        MatrixXT t_matGain(m_iNumChannels, 3*t_vecPoints.size());
+        for(int i = 0; i < t_vecPoints.size(); ++i)
+            t_matGain.block(0, 3*i, m_iNumChannels, 3) = m_ForwardSolution.sol->data.block(0, 3*t_vecPoints[i], m_iNumChannels, 3);
+
+        MatrixXT t_matProj_Gain = p_matOrthProj * t_matGain;
+
+        SubcorrGram<T> t_gramFine;
+        calcSubcorrGram(t_matProj_Gain, p_matU_B, t_gramFine);
+
+        int t_iNumCandidates = (int)t_vecCandidates.size();
+        VectorXT t_vecRoh(t_iNumCandidates);
+
+        #ifdef _OPENMP
+        #pragma omp parallel for num_threads(m_iMaxNumThreads)
+        #endif
+        for(int i = 0; i < t_iNumCandidates; ++i)
+            t_vecRoh(i) = RapMusic::subcorr(t_gramFine, t_vecLocalIdx[t_vecCandidates[i].x1], t_vecLocalIdx[t_vecCandidates[i].x2]);
+
+        VectorXT::Index t_iMaxIdx;
+        t_val_roh_k = t_vecRoh.maxCoeff(&t_iMaxIdx);
+
+        p_iIdx1 = t_vecCandidates[t_iMaxIdx].x1;
+        p_iIdx2 = t_vecCandidates[t_iMaxIdx].x2;
+
+        std::cout << "Hierarchical search: " << t_iNumCoarseCombinations << " coarse and " << t_iNumCandidates << " fine pairs scanned." << std::endl;
+    }
+
+    //Heuristic check: a refinement below the coarse correlation or the threshold has likely missed the maximum
+    if(m_bExhaustiveFallback && (t_val_roh_k < t_dRohCoarse || t_val_roh_k < m_dThreshold))
+    {
+        std::cout << "Hierarchical search result " << t_val_roh_k << " is below the coarse correlation " << t_dRohCoarse
+                  << " or the threshold -> falling back to the exhaustive search." << std::endl;
+        return scanExhaustive(p_matOrthProj, p_matU_B, p_iIdx1, p_iIdx2);
+    }
+
+    return t_val_roh_k;
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+void RapMusic::calcSubcorrGram(const MatrixXT& p_matProj_LeadField, const MatrixXT& p_matU_B, SubcorrGram<T>& p_gram) const
+{
+    int t_iNumPoints = p_matProj_LeadField.cols()/3;
+
+    p_gram.matProj_G = p_matProj_LeadField.template cast<T>();
+    p_gram.matZ = (p_matU_B.transpose() * p_matProj_LeadField).template cast<T>();//U_B^T*G computed once per iteration
+
+    p_gram.matGram.resize(3, 3*t_iNumPoints);
+    p_gram.matZGram.resize(3, 3*t_iNumPoints);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(m_iMaxNumThreads)
+    #endif
+    for(int i = 0; i < t_iNumPoints; ++i)
+    {
+        p_gram.matGram.template middleCols<3>(3*i).noalias() = p_gram.matProj_G.template middleCols<3>(3*i).transpose() * p_gram.matProj_G.template middleCols<3>(3*i);
+        p_gram.matZGram.template middleCols<3>(3*i).noalias() = p_gram.matZ.template middleCols<3>(3*i).transpose() * p_gram.matZ.template middleCols<3>(3*i);
+    }
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+double RapMusic::subcorr(const SubcorrGram<T>& p_gram, int p_iIdx1, int p_iIdx2)
+{
+    typedef Eigen::Matrix<T, 6, 6> Matrix6;
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, 0, 6, 6> MatrixMax6;
+
+    //A = G^T*G and M = G^T*U_B*U_B^T*G of the projected pair G = [G_1 G_2]
+    Matrix6 t_matA;
+    t_matA.template block<3,3>(0,0) = p_gram.matGram.template middleCols<3>(3*p_iIdx1);
+    t_matA.template block<3,3>(3,3) = p_gram.matGram.template middleCols<3>(3*p_iIdx2);
+    t_matA.template block<3,3>(0,3).noalias() = p_gram.matProj_G.template middleCols<3>(3*p_iIdx1).transpose() * p_gram.matProj_G.template middleCols<3>(3*p_iIdx2);
+    t_matA.template block<3,3>(3,0) = t_matA.template block<3,3>(0,3).transpose();
+
+    Matrix6 t_matM;
+    t_matM.template block<3,3>(0,0) = p_gram.matZGram.template middleCols<3>(3*p_iIdx1);
+    t_matM.template block<3,3>(3,3) = p_gram.matZGram.template middleCols<3>(3*p_iIdx2);
+    t_matM.template block<3,3>(0,3).noalias() = p_gram.matZ.template middleCols<3>(3*p_iIdx1).transpose() * p_gram.matZ.template middleCols<3>(3*p_iIdx2);
+    t_matM.template block<3,3>(3,0) = t_matM.template block<3,3>(0,3).transpose();
+
+    //V_A and Sigma_A^2 - eigenvalues are ascending
+    Eigen::SelfAdjointEigenSolver<Matrix6> t_eigA(t_matA);
+    const Eigen::Matrix<T, 6, 1>& t_vecEigA = t_eigA.eigenvalues();
+
+    if(t_vecEigA(5) <= 0)
+        return 0.0;
+
+    //Only retain the components which correspond to singular values > 10^-5, at least one (see getRank)
+    T t_thr = std::max(T(1e-10), t_vecEigA(5) * T(6) * Eigen::NumTraits<T>::epsilon());
+    int t_iRank = 1;
+    while(t_iRank < 6 && t_vecEigA(5 - t_iRank) > t_thr)
+        ++t_iRank;
+
+    //W = V_A*Sigma_A^-1 -> U_A = G*W
+    MatrixMax6 t_matW = t_eigA.eigenvectors().rightCols(t_iRank) * t_vecEigA.tail(t_iRank).cwiseSqrt().cwiseInverse().asDiagonal();
+
+    //C^T*C = U_A^T*U_B*U_B^T*U_A = W^T*M*W
+    MatrixMax6 t_matCTC = t_matW.transpose() * t_matM * t_matW;
+
+    Eigen::SelfAdjointEigenSolver<MatrixMax6> t_eigC(t_matCTC, Eigen::EigenvaluesOnly);
+
+    return sqrt(std::max((double)t_eigC.eigenvalues()(t_iRank - 1), 0.0));
+}
+
+
 //*************************************************************************************************************
 
 void RapMusic::calcA_k_1(   const MatrixX6T& p_matG_k_1,
@@ -907,3 +1146,120 @@ void RapMusic::setStcAttr(int p_iSampStcWin, float p_fStcOverlap)
     m_iSamplesStcWindow = p_iSampStcWin;
     m_fStcOverlap = p_fStcOverlap;
 }
+
+
+//*************************************************************************************************************
+
+void RapMusic::setScanMode(ScanMode p_scanMode)
+{
+    m_scanMode = p_scanMode;
+}
+
+
+//*************************************************************************************************************
+
+bool RapMusic::setHierarchicalSearch(const MNEForwardSolution& p_fwdCoarse, const MatrixXd& p_matD, int p_iBeamWidth, bool p_bExhaustiveFallback)
+{
+    m_bHierarchical = false;
+    m_matCoarseGain.resize(0,0);
+    m_qListCoarseMembers.clear();
+
+    if(!m_bIsInit)
+    {
+        std::cout << "RAP MUSIC wasn't initialized!" << std::endl;
+        return false;
+    }
+
+    if(p_fwdCoarse.sol->data.rows() != m_iNumChannels || p_fwdCoarse.sol->data.cols() % 3 != 0)
+    {
+        std::cout << "Coarse gain matrix does not fit to the forward solution!" << std::endl;
+        return false;
+    }
+
+    int t_iNumCoarsePoints = p_fwdCoarse.sol->data.cols()/3;
+
+    //Free orientation weights have a 3x3 block per grid point pair, fixed orientation weights a single entry
+    int t_iStride;
+    if(p_matD.rows() == 3*m_iNumGridPoints && p_matD.cols() == 3*t_iNumCoarsePoints)
+        t_iStride = 3;
+    else if(p_matD.rows() == m_iNumGridPoints && p_matD.cols() == t_iNumCoarsePoints)
+        t_iStride = 1;
+    else
+    {
+        std::cout << "Weight matrix does not fit to the forward solution and its coarse level!" << std::endl;
+        return false;
+    }
+
+    //Assign each grid point to the coarse grid point with the largest weight
+    VectorXi t_vecAssignment = VectorXi::Constant(m_iNumGridPoints, -1);
+    VectorXd t_vecMaxWeight = VectorXd::Zero(m_iNumGridPoints);
+    for(int c = 0; c < t_iNumCoarsePoints; ++c)
+    {
+        for(int i = 0; i < m_iNumGridPoints; ++i)
+        {
+            double t_dWeight = fabs(p_matD(t_iStride*i, t_iStride*c));
+            if(t_dWeight > t_vecMaxWeight[i])
+            {
+                t_vecMaxWeight[i] = t_dWeight;
+                t_vecAssignment[i] = c;
+            }
+        }
+    }
+
+    VectorXi t_vecCount = VectorXi::Zero(t_iNumCoarsePoints);
+    int t_iNumUnassigned = 0;
+    for(int i = 0; i < m_iNumGridPoints; ++i)
+    {
+        if(t_vecAssignment[i] >= 0)
+            ++t_vecCount[t_vecAssignment[i]];
+        else
+            ++t_iNumUnassigned;
+    }
+
+    for(int c = 0; c < t_iNumCoarsePoints; ++c)
+        m_qListCoarseMembers.append(VectorXi(t_vecCount[c]));
+
+    t_vecCount.setZero();
+    for(int i = 0; i < m_iNumGridPoints; ++i)
+    {
+        int c = t_vecAssignment[i];
+        if(c >= 0)
+        {
+            m_qListCoarseMembers[c][t_vecCount[c]] = i;
+            ++t_vecCount[c];
+        }
+    }
+
+    if(t_iNumUnassigned > 0)
+        std::cout << "Warning: " << t_iNumUnassigned << " grid points do not belong to the coarse level and are not scanned." << std::endl;
+
+    m_matCoarseGain = p_fwdCoarse.sol->data;
+    m_iBeamWidth = p_iBeamWidth > 0 ? p_iBeamWidth : 1;
+    m_bExhaustiveFallback = p_bExhaustiveFallback;
+    m_bHierarchical = true;
+
+    std::cout << "Hierarchical search with " << t_iNumCoarsePoints << " coarse grid points and beam width " << m_iBeamWidth << "." << std::endl;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RapMusic::disableHierarchicalSearch()
+{
+    m_bHierarchical = false;
+    m_matCoarseGain.resize(0,0);
+    m_qListCoarseMembers.clear();
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EXPLICIT TEMPLATE INSTANTIATIONS
+//=============================================================================================================
+
+template void RapMusic::calcSubcorrGram<float>(const MatrixXT&, const MatrixXT&, SubcorrGram<float>&) const;
+template void RapMusic::calcSubcorrGram<double>(const MatrixXT&, const MatrixXT&, SubcorrGram<double>&) const;
+template double RapMusic::subcorr<float>(const SubcorrGram<float>&, int, int);
+template double RapMusic::subcorr<double>(const SubcorrGram<double>&, int, int);
@@ -50,6 +50,7 @@
 #include <time.h>
 
 #include <QVector>
+#include <QList>
 
 
 
@@ -61,6 +62,7 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 #include <Eigen/LU>
+#include <Eigen/Eigenvalues>
 
 
 //*************************************************************************************************************
@@ -99,6 +101,21 @@ typedef struct Pair
 } Pair;
 
 
+//=============================================================================================================
+/**
+* Declares the per iteration precomputation of the Gram based subspace correlation. With it the subspace
+* correlation of a dipole pair reduces to 6x6 eigenproblems, see RapMusic::subcorr.
+*/
+template<typename T>
+struct SubcorrGram
+{
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> matProj_G;  /**< The projected gain matrix (channels x 3*grid points). */
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> matZ;       /**< U_B^T times the projected gain matrix (rank x 3*grid points). */
+    Eigen::Matrix<T, 3, Eigen::Dynamic> matGram;                 /**< 3x3 Gram blocks G_i^T*G_i of the projected gain, one per grid point. */
+    Eigen::Matrix<T, 3, Eigen::Dynamic> matZGram;                /**< 3x3 Gram blocks Z_i^T*Z_i of matZ, one per grid point. */
+};
+
+
 
 //=============================================================================================================
 /**
@@ -112,6 +129,17 @@ public:
     typedef QSharedPointer<RapMusic> SPtr;             /**< Shared pointer type for RapMusic. */
     typedef QSharedPointer<const RapMusic> ConstSPtr;  /**< Const shared pointer type for RapMusic. */
 
+    //=========================================================================================================
+    /**
+    * Kernels which can be used to scan the dipole pairs.
+    */
+    enum ScanMode
+    {
+        ScanSVD,            /**< SVD of every projected pair gain, reference implementation. */
+        ScanGram,           /**< Gram based 6x6 kernel in double precision. */
+        ScanGramFloat       /**< Gram based 6x6 kernel in single precision. */
+    };
+
     //*********************************************************************************************************
     //=========================================================================================================
     // TYPEDEFS
@@ -183,6 +211,40 @@ public:
     */
     void setStcAttr(int p_iSampStcWin, float p_fStcOverlap);
 
+    //=========================================================================================================
+    /**
+    * Sets the kernel which is used to scan the dipole pairs (default ScanGram).
+    *
+    * @param[in] p_scanMode     The scan kernel.
+    */
+    void setScanMode(ScanMode p_scanMode);
+
+    //=========================================================================================================
+    /**
+    * Enables the coarse-to-fine search. All dipole pairs of the coarse level are scanned, the p_iBeamWidth
+    * best coarse pairs are kept and all pairs of their member grid points are scanned on the fine level.
+    * The search is approximate, the best pair can lie outside the refined coarse pairs.
+    * Has to be called after init.
+    *
+    * @param[in] p_fwdCoarse            The coarse level, e.g. a clustered version of the forward solution. The
+    *                                   channels have to be the same.
+    * @param[in] p_matD                 Weights which map the grid points onto the coarse grid points (3*grid points
+    *                                   x 3*coarse grid points, like the one of cluster_forward_solution). Each grid
+    *                                   point belongs to the coarse grid point with the largest weight.
+    * @param[in] p_iBeamWidth           The number of coarse pairs which are refined (default 16).
+    * @param[in] p_bExhaustiveFallback  Whether to fall back to the exhaustive search when the refined correlation is
+    *                                   below the best coarse correlation or the threshold (default false). This is
+    *                                   a heuristic, a result above both can still miss the exhaustive maximum.
+    * @return   true if the coarse level fits to the forward solution, false otherwise.
+    */
+    bool setHierarchicalSearch(const MNEForwardSolution& p_fwdCoarse, const MatrixXd& p_matD, int p_iBeamWidth = 16, bool p_bExhaustiveFallback = false);
+
+    //=========================================================================================================
+    /**
+    * Disables the coarse-to-fine search, the dipole pairs are scanned exhaustively again.
+    */
+    void disableHierarchicalSearch();
+
 protected:
     //=========================================================================================================
     /**
@@ -228,6 +290,74 @@ protected:
     */
     static double subcorr(MatrixX6T& p_matProj_G, const MatrixXT& p_matU_B, Vector6T& p_vec_phi_k_1);
 
+    //=========================================================================================================
+    /**
+    * Searches the dipole pair with the maximal subspace correlation, hierarchically when enabled otherwise
+    * exhaustively.
+    *
+    * @param[in] p_matOrthProj  The current orthogonal projector.
+    * @param[in] p_matU_B       The matrix U is the subspace projection of the orthogonal projected Phi_s
+    * @param[out] p_iIdx1       First grid index of the found pair.
+    * @param[out] p_iIdx2       Second grid index of the found pair.
+    * @return   The correlation of the found pair.
+    */
+    double scanPairs(const MatrixXT& p_matOrthProj, const MatrixXT& p_matU_B, int &p_iIdx1, int &p_iIdx2) const;
+
+    //=========================================================================================================
+    /**
+    * Scans all dipole pairs with the selected scan kernel.
+    *
+    * @param[in] p_matOrthProj  The current orthogonal projector.
+    * @param[in] p_matU_B       The matrix U is the subspace projection of the orthogonal projected Phi_s
+    * @param[out] p_iIdx1       First grid index of the found pair.
+    * @param[out] p_iIdx2       Second grid index of the found pair.
+    * @return   The correlation of the found pair.
+    */
+    double scanExhaustive(const MatrixXT& p_matOrthProj, const MatrixXT& p_matU_B, int &p_iIdx1, int &p_iIdx2) const;
+
+    //=========================================================================================================
+    /**
+    * Coarse-to-fine scan, see setHierarchicalSearch. Only the grid points of the kept coarse pairs are
+    * projected and precomputed.
+    *
+    * @param[in] p_matOrthProj  The current orthogonal projector.
+    * @param[in] p_matU_B       The matrix U is the subspace projection of the orthogonal projected Phi_s
+    * @param[out] p_iIdx1       First grid index of the found pair.
+    * @param[out] p_iIdx2       Second grid index of the found pair.
+    * @return   The correlation of the found pair.
+    */
+    template<typename T>
+    double scanHierarchical(const MatrixXT& p_matOrthProj, const MatrixXT& p_matU_B, int &p_iIdx1, int &p_iIdx2) const;
+
+    //=========================================================================================================
+    /**
+    * Precomputes everything the Gram based subspace correlation needs for one iteration: U_B^T*G and the 3x3
+    * Gram blocks per grid point. Since U_B lies in the range of the orthogonal projector U_B^T*G equals U_B^T
+    * times the unprojected gain.
+    *
+    * @param[in] p_matProj_LeadField    The projected gain matrix.
+    * @param[in] p_matU_B               The matrix U is the subspace projection of the orthogonal projected Phi_s
+    * @param[out] p_gram                The precomputation.
+    */
+    template<typename T>
+    void calcSubcorrGram(const MatrixXT& p_matProj_LeadField, const MatrixXT& p_matU_B, SubcorrGram<T>& p_gram) const;
+
+    //=========================================================================================================
+    /**
+    * Computes the same subspace correlation as subcorr(p_matProj_G, p_matU_B) from the precomputed Gram blocks.
+    * With A = G^T*G and M = G^T*U_B*U_B^T*G of the projected pair G, U_A = G*V_A*Sigma_A^-1 and the squared
+    * correlation is the largest eigenvalue of Sigma_A^-1*V_A^T*M*V_A*Sigma_A^-1. A is restricted to its rank
+    * like in getRank. Only the 3x3 cross blocks of A and M are computed per pair.
+    *
+    * @param[in] p_gram     The precomputation of the current iteration.
+    * @param[in] p_iIdx1    First Lead Field index point.
+    * @param[in] p_iIdx2    Second Lead Field index point.
+    * @return   The maximal correlation c_1 of the subspace correlation of the current projected Lead Field
+    *           combination and the projected measurement.
+    */
+    template<typename T>
+    static double subcorr(const SubcorrGram<T>& p_gram, int p_iIdx1, int p_iIdx2);
+
     //=========================================================================================================
     /**
     * Calculates the accumulated manifold vectors A_{k1}
@@ -328,6 +458,14 @@ protected:
 
     int m_iMaxNumThreads;   /**< Number of available CPU threads. */
 
+    ScanMode m_scanMode;    /**< Kernel used to scan the dipole pairs. */
+
+    bool m_bHierarchical;                           /**< Whether the coarse-to-fine search is used. */
+    MatrixXT m_matCoarseGain;                       /**< Gain matrix of the coarse level. */
+    QList<Eigen::VectorXi> m_qListCoarseMembers;    /**< Grid points which belong to each coarse grid point. */
+    int m_iBeamWidth;                               /**< Number of coarse pairs which are refined. */
+    bool m_bExhaustiveFallback;                     /**< Whether to fall back to the exhaustive search. */
+
     bool m_bIsInit; /**< Wether the algorithm is initialized. */
 
     //Stc stuff
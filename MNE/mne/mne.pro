@@ -98,7 +98,8 @@ SOURCES += \
     mne_corsourceestimate.cpp\
     mne_bem.cpp\
     mne_bem_surface.cpp \
-    mne_project_to_surface.cpp
+    mne_project_to_surface.cpp \
+    mne_operator_cache.cpp
 
 HEADERS += \
     mne.h \
@@ -115,7 +116,8 @@ HEADERS += \
     mne_corsourceestimate.h\
     mne_bem.h\
     mne_bem_surface.h \
-    mne_project_to_surface.h
+    mne_project_to_surface.h \
+    mne_operator_cache.h
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
 INCLUDEPATH += $${MNE_INCLUDE_DIR}
@@ -134,6 +134,7 @@ public:
     FIFFLIB::fiff_int_t  event; /**< The event code */
     float       tmin;           /**< New start time (must be >= 0). */
     float       tmax;           /**< New end time of the data (cannot exceed data duration). */
+    bool        bReject;        /**< Whether the epoch exceeded an artifact rejection threshold. */
 
 };
 
@@ -41,6 +41,27 @@
 #include "mne_epoch_data_list.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QFile>
+#include <QThread>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -126,3 +147,174 @@ FiffEvoked MNEEpochDataList::average(FiffInfo& info, fiff_int_t first, fiff_int_
 
     return p_evoked;
 }
+
+
+//*************************************************************************************************************
+
+MNEEpochDataList MNEEpochDataList::readEpochs(const FiffRawData& raw, const MatrixXi& events, float tmin, float tmax, qint32 event, const QMap<QString,double>& mapReject, const RowVectorXi& picks, bool bParallel)
+{
+    MNEEpochDataList data;
+
+    fiff_int_t iOffsetFrom = (fiff_int_t)floor(tmin*raw.info.sfreq);
+    fiff_int_t iOffsetTo   = (fiff_int_t)floor(tmax*raw.info.sfreq + 0.5);
+    fiff_int_t iNumSamples = iOffsetTo - iOffsetFrom + 1;
+    if(iNumSamples <= 0)
+    {
+        printf("Epoch time window is empty\n");
+        return data;
+    }
+    //
+    //  Select the desired events which lie completely within the data, sorted by sample
+    //
+    QVector<fiff_int_t> vecEventSamples;
+    for(qint32 p = 0; p < events.rows(); ++p)
+    {
+        if(events(p,1) == 0 && events(p,2) == event)
+        {
+            fiff_int_t from = events(p,0) + iOffsetFrom;
+            if(from >= raw.first_samp && from + iNumSamples - 1 <= raw.last_samp)
+                vecEventSamples.append(events(p,0));
+            else
+                printf("Event at sample %d is too close to the data boundary, skipped\n", events(p,0));
+        }
+    }
+    std::sort(vecEventSamples.begin(), vecEventSamples.end());
+
+    qint32 iNumEpochs = vecEventSamples.size();
+    if(iNumEpochs == 0)
+    {
+        printf("No desired events found.\n");
+        return data;
+    }
+    //
+    //  Peak-to-peak rejection threshold per picked channel, infinity for channels which are not checked
+    //
+    qint32 iNumRows = picks.size() > 0 ? picks.size() : raw.info.nchan;
+    VectorXd vecThresholds;
+    if(!mapReject.isEmpty())
+    {
+        vecThresholds = VectorXd::Constant(iNumRows, std::numeric_limits<double>::infinity());
+        for(qint32 r = 0; r < iNumRows; ++r)
+        {
+            const FiffChInfo& ch = raw.info.chs[picks.size() > 0 ? picks[r] : r];
+            QString sType;
+            if(ch.kind == FIFFV_MEG_CH)
+                sType = ch.unit == FIFF_UNIT_T_M ? QString("grad") : QString("mag");
+            else if(ch.kind == FIFFV_EEG_CH)
+                sType = "eeg";
+            else if(ch.kind == FIFFV_EOG_CH)
+                sType = "eog";
+
+            if(mapReject.contains(sType))
+                vecThresholds[r] = mapReject[sType];
+        }
+    }
+    //
+    //  Preallocate the epochs and split them into consecutive file regions
+    //
+    QList<MNEEpochData::SPtr> lEpochs;
+    lEpochs.reserve(iNumEpochs);
+    for(qint32 i = 0; i < iNumEpochs; ++i)
+    {
+        MNEEpochData::SPtr pEpoch(new MNEEpochData());
+        fiff_int_t from = vecEventSamples[i] + iOffsetFrom;
+        pEpoch->event = event;
+        pEpoch->tmin = ((float)(from)-(float)(raw.first_samp))/raw.info.sfreq;
+        pEpoch->tmax = ((float)(from + iNumSamples - 1)-(float)(raw.first_samp))/raw.info.sfreq;
+        lEpochs.append(pEpoch);
+    }
+
+    //Each thread opens the file on its own, so this requires the raw data to come from a file
+    bool bOwnFile = !raw.info.filename.isEmpty() && QFile::exists(raw.info.filename);
+    qint32 iNumChunks = 1;
+    if(bParallel && bOwnFile)
+        iNumChunks = qMax(1, qMin(iNumEpochs, QThread::idealThreadCount()));
+
+    printf("Reading %d epochs in %d file region(s)\n", iNumEpochs, iNumChunks);
+
+    QList<EpochChunk> chunks;
+    for(qint32 c = 0; c < iNumChunks; ++c)
+    {
+        qint32 iFirst = (qint64)c * iNumEpochs / iNumChunks;
+        qint32 iLast = (qint64)(c + 1) * iNumEpochs / iNumChunks;
+
+        EpochChunk chunk;
+        chunk.pRaw = &raw;
+        chunk.bOwnFile = bOwnFile;
+        chunk.vecFrom.resize(iLast - iFirst);
+        for(qint32 i = iFirst; i < iLast; ++i)
+            chunk.vecFrom[i - iFirst] = vecEventSamples[i] + iOffsetFrom;
+        chunk.iNumSamples = iNumSamples;
+        chunk.pPicks = &picks;
+        chunk.pThresholds = &vecThresholds;
+        chunk.lEpochs = lEpochs.mid(iFirst, iLast - iFirst);
+        chunks.append(chunk);
+    }
+
+    bool bSuccess = true;
+    if(chunks.size() == 1)
+    {
+        bSuccess = readEpochChunk(chunks[0]);
+    }
+    else
+    {
+        QList<bool> lResults = QtConcurrent::blockingMapped(chunks, &MNEEpochDataList::readEpochChunk);
+        bSuccess = !lResults.contains(false);
+    }
+
+    if(!bSuccess)
+    {
+        printf("Can't read the event data segments\n");
+        return data;
+    }
+
+    qint32 iNumRejected = 0;
+    for(qint32 i = 0; i < iNumEpochs; ++i)
+    {
+        if(lEpochs[i]->bReject)
+            ++iNumRejected;
+        else
+            data.append(lEpochs[i]);
+    }
+
+    printf("%d epochs read, %d rejected\n", iNumEpochs, iNumRejected);
+
+    return data;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEEpochDataList::readEpochChunk(const EpochChunk& chunk)
+{
+    //The copy has its own tag and decoding buffers and, if possible, its own file handle
+    QFile t_file(chunk.pRaw->info.filename);
+    FiffRawData raw(*chunk.pRaw);
+    if(chunk.bOwnFile)
+    {
+        raw.file = FiffStream::SPtr(new FiffStream(&t_file));
+        if(chunk.pRaw->file && chunk.pRaw->file->is_mapped())
+            raw.file->map_file();
+    }
+
+    QList<MatrixXd> lData;
+    if(!raw.read_raw_segments(lData, chunk.vecFrom, chunk.iNumSamples, *chunk.pPicks))
+        return false;
+
+    const VectorXd& vecThresholds = *chunk.pThresholds;
+
+    for(qint32 i = 0; i < lData.size(); ++i)
+    {
+        MNEEpochData& epoch = *chunk.lEpochs[i];
+        epoch.epoch.swap(lData[i]);
+
+        //Check the epoch while its data are still in cache
+        if(vecThresholds.size() == epoch.epoch.rows())
+        {
+            VectorXd vecPeakToPeak = epoch.epoch.rowwise().maxCoeff() - epoch.epoch.rowwise().minCoeff();
+            epoch.bReject = (vecPeakToPeak.array() > vecThresholds.array()).any();
+        }
+    }
+
+    return true;
+}
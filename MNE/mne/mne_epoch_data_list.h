@@ -43,6 +43,7 @@
 
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_evoked.h>
+#include <fiff/fiff_raw_data.h>
 
 
 //*************************************************************************************************************
@@ -60,6 +61,7 @@
 //=============================================================================================================
 
 #include <QList>
+#include <QMap>
 #include <QSharedPointer>
 
 
@@ -112,6 +114,57 @@ public:
     * @param[in] proj       Apply SSP projection vectors (optional, default = false)
     */
     FIFFLIB::FiffEvoked average(FIFFLIB::FiffInfo& p_info, FIFFLIB::fiff_int_t first, FIFFLIB::fiff_int_t last, VectorXi sel = FIFFLIB::defaultVectorXi, bool proj = false);
+
+    //=========================================================================================================
+    /**
+    * Reads the epochs of all events with the given code from a raw file. The events are sorted by sample and
+    * the file is read in one sweep, each raw buffer is read, calibrated and projected once and copied into all
+    * epochs it overlaps (see FiffRawData::read_raw_segments). Epochs which do not lie completely within the
+    * data are skipped. If the raw data were read from a file the events are split into consecutive file regions
+    * which are read concurrently, each thread opens the file on its own. Mapped files (see FiffStream::map_file)
+    * are mapped by every thread.
+    *
+    * Artifact rejection is done on the fly: an epoch is dropped if the peak-to-peak amplitude of a channel
+    * exceeds the threshold given for its channel type. Valid keys are "grad", "mag", "eeg" and "eog".
+    *
+    * @param[in] raw        raw data, including the projection and compensation to apply
+    * @param[in] events     events (samples x 3) as read by MNE::read_events
+    * @param[in] tmin       start time of the epochs relative to the event in seconds
+    * @param[in] tmax       end time of the epochs relative to the event in seconds
+    * @param[in] event      the event code to select
+    * @param[in] mapReject  peak-to-peak rejection thresholds per channel type (optional)
+    * @param[in] picks      channel selection vector (optional)
+    * @param[in] bParallel  whether file regions may be read concurrently (optional, default = true)
+    *
+    * @return the epochs which were not rejected, in the order of their events
+    */
+    static MNEEpochDataList readEpochs(const FIFFLIB::FiffRawData& raw, const MatrixXi& events, float tmin, float tmax, qint32 event, const QMap<QString,double>& mapReject = QMap<QString,double>(), const RowVectorXi& picks = FIFFLIB::defaultRowVectorXi, bool bParallel = true);
+
+private:
+    //=========================================================================================================
+    /**
+    * Consecutive epochs of one file region, which are read by one thread.
+    */
+    struct EpochChunk
+    {
+        const FIFFLIB::FiffRawData* pRaw;   /**< The raw data, copied by the reading thread. */
+        bool bOwnFile;                      /**< Whether the reading thread opens the raw file on its own. */
+        RowVectorXi vecFrom;                /**< First sample of each epoch, sorted. */
+        FIFFLIB::fiff_int_t iNumSamples;    /**< Number of samples per epoch. */
+        const RowVectorXi* pPicks;          /**< Channel selection. */
+        const VectorXd* pThresholds;        /**< Peak-to-peak threshold per picked channel, empty for no rejection. */
+        QList<MNEEpochData::SPtr> lEpochs;  /**< Preallocated epochs the data are written to. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Reads the epochs of one chunk and flags the ones exceeding the rejection thresholds.
+    *
+    * @param[in] chunk      the chunk to read
+    *
+    * @return true if succeeded, false otherwise
+    */
+    static bool readEpochChunk(const EpochChunk& chunk);
 };
 
 } // NAMESPACE
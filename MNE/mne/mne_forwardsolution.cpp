@@ -485,62 +485,7 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
     //
     // Cluster operator D (sources x clusters)
     //
-    qint32 totalNumOfClust = 0;
-    for (qint32 h = 0; h < 2; ++h)
-        totalNumOfClust += p_fwdOut.src[h].cluster_info.clusterVertnos.size();
-
-    if(this->isFixedOrient())
-        p_D = MatrixXd::Zero(this->sol->data.cols(), totalNumOfClust);
-    else
-        p_D = MatrixXd::Zero(this->sol->data.cols(), totalNumOfClust*3);
-
-    QList<VectorXi> t_vertnos = this->src.get_vertno();
-
-//    qDebug() << "Size: " << t_vertnos[0].size()  << t_vertnos[1].size();
-//    qDebug() << "this->sol->data.cols(): " << this->sol->data.cols();
-
-    qint32 currentCluster = 0;
-    for (qint32 h = 0; h < 2; ++h)
-    {
-        int hemiOffset = h == 0 ? 0 : t_vertnos[0].size();
-        for(qint32 i = 0; i < p_fwdOut.src[h].cluster_info.clusterVertnos.size(); ++i)
-        {
-            VectorXi idx_sel;
-            MNEMath::intersect(t_vertnos[h], p_fwdOut.src[h].cluster_info.clusterVertnos[i], idx_sel);
-
-//            std::cout << "\nVertnos:\n" << t_vertnos[h] << std::endl;
-
-//            std::cout << "clusterVertnos[i]:\n" << p_fwdOut.src[h].cluster_info.clusterVertnos[i] << std::endl;
-
-            idx_sel.array() += hemiOffset;
-
-//            std::cout << "idx_sel]:\n" << idx_sel << std::endl;
-
-
-
-            double selectWeight = 1.0/idx_sel.size();
-            if(this->isFixedOrient())
-            {
-                for(qint32 j = 0; j < idx_sel.size(); ++j)
-                    p_D.col(currentCluster)[idx_sel(j)] = selectWeight;
-            }
-            else
-            {
-                qint32 clustOffset = currentCluster*3;
-                for(qint32 j = 0; j < idx_sel.size(); ++j)
-                {
-                    qint32 idx_sel_Offset = idx_sel(j)*3;
-                    //x
-                    p_D(idx_sel_Offset,clustOffset) = selectWeight;
-                    //y
-                    p_D(idx_sel_Offset+1, clustOffset+1) = selectWeight;
-                    //z
-                    p_D(idx_sel_Offset+2, clustOffset+2) = selectWeight;
-                }
-            }
-            ++currentCluster;
-        }
-    }
+    this->compute_cluster_operator(p_fwdOut, p_D);
 
 //    std::cout << "D:\n" << D.row(0) << std::endl << D.row(1) << std::endl << D.row(2) << std::endl << D.row(3) << std::endl << D.row(4) << std::endl << D.row(5) << std::endl;
 
@@ -708,6 +653,69 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
 }
 
 
+//*************************************************************************************************************
+
+void MNEForwardSolution::compute_cluster_operator(const MNEForwardSolution &p_fwdClustered, MatrixXd& p_D) const
+{
+    qint32 totalNumOfClust = 0;
+    for (qint32 h = 0; h < 2; ++h)
+        totalNumOfClust += p_fwdClustered.src[h].cluster_info.clusterVertnos.size();
+
+    if(this->isFixedOrient())
+        p_D = MatrixXd::Zero(this->sol->data.cols(), totalNumOfClust);
+    else
+        p_D = MatrixXd::Zero(this->sol->data.cols(), totalNumOfClust*3);
+
+    QList<VectorXi> t_vertnos = this->src.get_vertno();
+
+//    qDebug() << "Size: " << t_vertnos[0].size()  << t_vertnos[1].size();
+//    qDebug() << "this->sol->data.cols(): " << this->sol->data.cols();
+
+    qint32 currentCluster = 0;
+    for (qint32 h = 0; h < 2; ++h)
+    {
+        int hemiOffset = h == 0 ? 0 : t_vertnos[0].size();
+        for(qint32 i = 0; i < p_fwdClustered.src[h].cluster_info.clusterVertnos.size(); ++i)
+        {
+            VectorXi idx_sel;
+            MNEMath::intersect(t_vertnos[h], p_fwdClustered.src[h].cluster_info.clusterVertnos[i], idx_sel);
+
+//            std::cout << "\nVertnos:\n" << t_vertnos[h] << std::endl;
+
+//            std::cout << "clusterVertnos[i]:\n" << p_fwdClustered.src[h].cluster_info.clusterVertnos[i] << std::endl;
+
+            idx_sel.array() += hemiOffset;
+
+//            std::cout << "idx_sel]:\n" << idx_sel << std::endl;
+
+
+
+            double selectWeight = 1.0/idx_sel.size();
+            if(this->isFixedOrient())
+            {
+                for(qint32 j = 0; j < idx_sel.size(); ++j)
+                    p_D.col(currentCluster)[idx_sel(j)] = selectWeight;
+            }
+            else
+            {
+                qint32 clustOffset = currentCluster*3;
+                for(qint32 j = 0; j < idx_sel.size(); ++j)
+                {
+                    qint32 idx_sel_Offset = idx_sel(j)*3;
+                    //x
+                    p_D(idx_sel_Offset,clustOffset) = selectWeight;
+                    //y
+                    p_D(idx_sel_Offset+1, clustOffset+1) = selectWeight;
+                    //z
+                    p_D(idx_sel_Offset+2, clustOffset+2) = selectWeight;
+                }
+            }
+            ++currentCluster;
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 
 MNEForwardSolution MNEForwardSolution::reduce_forward_solution(qint32 p_iNumDipoles, MatrixXd& p_D) const
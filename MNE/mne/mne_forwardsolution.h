@@ -153,7 +153,7 @@ struct RegionData
         // Kmeans Reduction
         RegionDataOut p_RegionDataOut;
 
-        KMeans t_kMeans(t_sDistMeasure, QString("sample"), 5);
+        KMeans t_kMeans(t_sDistMeasure, QString("sample"), 5, QString("error"), true, 100, true);
 
         if(bUseWhitened)
         {
@@ -262,6 +262,16 @@ public:
     */
     MNEForwardSolution cluster_forward_solution(const AnnotationSet &p_AnnotationSet, qint32 p_iClusterSize, MatrixXd& p_D = defaultD, const FiffCov &p_pNoise_cov = defaultCov, const FiffInfo &p_pInfo = defaultInfo, QString p_sMethod = "cityblock") const;
 
+    //=========================================================================================================
+    /**
+    * Computes the cluster operator D, which maps this (unclustered) forward solution to the clusters of
+    * p_fwdClustered. Only the cluster information of p_fwdClustered is used.
+    *
+    * @param[in]    p_fwdClustered      The clustered version of this forward solution
+    * @param[out]   p_D                 The cluster operator (sources x clusters)
+    */
+    void compute_cluster_operator(const MNEForwardSolution &p_fwdClustered, MatrixXd& p_D) const;
+
     //=========================================================================================================
     /**
     * Compute orientation prior
@@ -146,7 +146,7 @@ struct RegionMT
         // Kmeans Reduction
         RegionMTOut p_RegionMTOut;
 
-        KMeans t_kMeans(t_sDistMeasure, QString("sample"), 5);
+        KMeans t_kMeans(t_sDistMeasure, QString("sample"), 5, QString("error"), true, 100, true);
 
         t_kMeans.calculate(this->matRoiMT, this->nClusters, p_RegionMTOut.roiIdx, p_RegionMTOut.ctrs, p_RegionMTOut.sumd, p_RegionMTOut.D);
 
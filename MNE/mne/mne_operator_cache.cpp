@@ -0,0 +1,516 @@
+//=============================================================================================================
+/**
+* @file     mne_operator_cache.cpp
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MNEOperatorCache class implementation
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_operator_cache.h"
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_dir_node.h>
+#include <fiff/fiff_tag.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define CACHE_FORMAT_VERSION    "1"     /**< Part of every key, increase when the cached computations or the file layout change */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MNEOperatorCache::MNEOperatorCache(const QString &p_sCacheDir)
+: m_sCacheDir(p_sCacheDir.isEmpty() ? defaultCacheDir() : p_sCacheDir)
+{
+}
+
+
+//*************************************************************************************************************
+
+QString MNEOperatorCache::defaultCacheDir()
+{
+    QString t_sLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(t_sLocation.isEmpty())
+        t_sLocation = QDir::tempPath() + "/mne-cpp";
+
+    return t_sLocation + "/operators";
+}
+
+
+//*************************************************************************************************************
+
+MNEForwardSolution MNEOperatorCache::cluster_forward_solution(const MNEForwardSolution &p_fwd, const AnnotationSet &p_AnnotationSet, qint32 p_iClusterSize, MatrixXd& p_D, const FiffCov &p_pNoise_cov, const FiffInfo &p_pInfo, QString p_sMethod) const
+{
+    //
+    // Key on everything the clustering depends on
+    //
+    QCryptographicHash t_hash(QCryptographicHash::Sha1);
+    t_hash.addData("cluster_forward_solution " CACHE_FORMAT_VERSION);
+    addToHash(t_hash, p_fwd);
+    for(qint32 h = 0; h < p_AnnotationSet.size(); ++h)
+    {
+        VectorXi t_vecLabelIds = p_AnnotationSet[h].getLabelIds();
+        t_hash.addData((const char*)t_vecLabelIds.data(), t_vecLabelIds.size()*sizeof(int));
+        VectorXi t_vecTableIds = p_AnnotationSet[h].getColortable().getLabelIds();
+        t_hash.addData((const char*)t_vecTableIds.data(), t_vecTableIds.size()*sizeof(int));
+        addToHash(t_hash, p_AnnotationSet[h].getColortable().getNames());
+    }
+    t_hash.addData(QString("%1 %2").arg(p_iClusterSize).arg(p_sMethod).toUtf8());
+    if(!p_pNoise_cov.isEmpty() && !p_pInfo.isEmpty())
+    {
+        addToHash(t_hash, p_pNoise_cov);
+        addToHash(t_hash, p_pInfo);
+    }
+    QString t_sKey = QString(t_hash.result().toHex());
+    QString t_sFilePath = filePath("fwd-clustered", t_sKey);
+
+    MNEForwardSolution t_fwdClustered;
+    if(readClustered(t_sFilePath, t_sKey, p_fwd, t_fwdClustered))
+    {
+        printf("Using cached clustered forward solution %s.\n", t_sFilePath.toUtf8().constData());
+        p_fwd.compute_cluster_operator(t_fwdClustered, p_D);
+        return t_fwdClustered;
+    }
+
+    t_fwdClustered = p_fwd.cluster_forward_solution(p_AnnotationSet, p_iClusterSize, p_D, p_pNoise_cov, p_pInfo, p_sMethod);
+
+    // Forward solutions which could not be clustered are not cached
+    if(t_fwdClustered.isClustered())
+    {
+        QString t_sTmpPath = t_sFilePath + ".tmp";
+        if(!writeClustered(t_sTmpPath, t_sKey, t_fwdClustered) || !commitFile(t_sTmpPath, t_sFilePath))
+            printf("Warning: Could not cache the clustered forward solution in %s.\n", t_sFilePath.toUtf8().constData());
+    }
+
+    return t_fwdClustered;
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator MNEOperatorCache::make_inverse_operator(const FiffInfo &info, const MNEForwardSolution &forward, const FiffCov& p_noise_cov, float loose, float depth, bool fixed, bool limit_depth_chs) const
+{
+    QCryptographicHash t_hash(QCryptographicHash::Sha1);
+    t_hash.addData("make_inverse_operator " CACHE_FORMAT_VERSION);
+    addToHash(t_hash, info);
+    addToHash(t_hash, forward);
+    addToHash(t_hash, p_noise_cov);
+    t_hash.addData(QString("%1 %2 %3 %4").arg(loose).arg(depth).arg(fixed).arg(limit_depth_chs).toUtf8());
+    QString t_sKey = QString(t_hash.result().toHex());
+    QString t_sFilePath = filePath("inv", t_sKey);
+
+    MNEInverseOperator t_invOp;
+    if(QFile::exists(t_sFilePath))
+    {
+        QFile t_file(t_sFilePath);
+        if(MNEInverseOperator::read_inverse_operator(t_file, t_invOp)
+                && t_invOp.nsource == forward.nsource
+                && t_invOp.source_ori == forward.source_ori
+                && restoreSourceSpace(forward, t_invOp))
+        {
+            printf("Using cached inverse operator %s.\n", t_sFilePath.toUtf8().constData());
+            return t_invOp;
+        }
+        printf("Warning: Discarding invalid cached inverse operator %s.\n", t_sFilePath.toUtf8().constData());
+    }
+
+    t_invOp = MNEInverseOperator::make_inverse_operator(info, forward, p_noise_cov, loose, depth, fixed, limit_depth_chs);
+
+    if(t_invOp.nsource > 0 && QDir().mkpath(m_sCacheDir))
+    {
+        QString t_sTmpPath = t_sFilePath + ".tmp";
+        bool t_bWritten = false;
+        {
+            QFile t_file(t_sTmpPath);
+            t_invOp.write(t_file);
+            t_bWritten = t_file.error() == QFile::NoError && QFileInfo(t_sTmpPath).size() > 0;
+        }
+        if(!t_bWritten)
+            QFile::remove(t_sTmpPath);
+        if(!t_bWritten || !commitFile(t_sTmpPath, t_sFilePath))
+            printf("Warning: Could not cache the inverse operator in %s.\n", t_sFilePath.toUtf8().constData());
+    }
+
+    return t_invOp;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEOperatorCache::restoreSourceSpace(const MNEForwardSolution &p_fwd, MNEInverseOperator &p_invOp)
+{
+    if(p_invOp.src.size() != p_fwd.src.size())
+        return false;
+
+    //
+    // The inverse operator file does not store the clustering, its vertno is rebuilt from inuse on reading
+    //
+    for(qint32 h = 0; h < p_fwd.src.size(); ++h)
+    {
+        if(p_fwd.src[h].isClustered())
+        {
+            p_invOp.src[h].vertno = p_fwd.src[h].vertno;
+            p_invOp.src[h].cluster_info = p_fwd.src[h].cluster_info;
+        }
+        else if(p_invOp.src[h].vertno.size() != p_fwd.src[h].vertno.size() || p_invOp.src[h].vertno != p_fwd.src[h].vertno)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void MNEOperatorCache::clear() const
+{
+    QDir t_dir(m_sCacheDir);
+    QStringList t_listFiles = t_dir.entryList(QStringList() << "*.fif" << "*.fif.tmp", QDir::Files);
+    for(qint32 i = 0; i < t_listFiles.size(); ++i)
+        t_dir.remove(t_listFiles[i]);
+}
+
+
+//*************************************************************************************************************
+
+void MNEOperatorCache::addToHash(QCryptographicHash &p_hash, const MNEForwardSolution &p_fwd)
+{
+    p_hash.addData(QString("%1 %2 %3 %4").arg(p_fwd.source_ori).arg(p_fwd.coord_frame).arg(p_fwd.nsource).arg(p_fwd.nchan).toUtf8());
+    addToHash(p_hash, p_fwd.info.ch_names);
+    addToHash(p_hash, p_fwd.sol->row_names);
+    addToHash(p_hash, p_fwd.sol->data);
+    for(qint32 h = 0; h < p_fwd.src.size(); ++h)
+        p_hash.addData((const char*)p_fwd.src[h].vertno.data(), p_fwd.src[h].vertno.size()*sizeof(int));
+}
+
+
+//*************************************************************************************************************
+
+void MNEOperatorCache::addToHash(QCryptographicHash &p_hash, const FiffCov &p_cov)
+{
+    addToHash(p_hash, p_cov.names);
+    addToHash(p_hash, p_cov.bads);
+    addToHash(p_hash, p_cov.data);
+    p_hash.addData(QString("%1 %2 %3").arg(p_cov.kind).arg(p_cov.diag).arg(p_cov.nfree).toUtf8());
+}
+
+
+//*************************************************************************************************************
+
+void MNEOperatorCache::addToHash(QCryptographicHash &p_hash, const FiffInfo &p_info)
+{
+    addToHash(p_hash, p_info.ch_names);
+    addToHash(p_hash, p_info.bads);
+    for(qint32 i = 0; i < p_info.projs.size(); ++i)
+    {
+        p_hash.addData(QString("%1 %2").arg(p_info.projs[i].desc).arg(p_info.projs[i].active).toUtf8());
+        addToHash(p_hash, p_info.projs[i].data->col_names);
+        addToHash(p_hash, p_info.projs[i].data->data);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MNEOperatorCache::addToHash(QCryptographicHash &p_hash, const MatrixXd &p_mat)
+{
+    qint64 t_iDims[2] = {p_mat.rows(), p_mat.cols()};
+    p_hash.addData((const char*)t_iDims, sizeof(t_iDims));
+    p_hash.addData((const char*)p_mat.data(), p_mat.size()*sizeof(double));
+}
+
+
+//*************************************************************************************************************
+
+void MNEOperatorCache::addToHash(QCryptographicHash &p_hash, const QStringList &p_list)
+{
+    p_hash.addData(QString::number(p_list.size()).toUtf8());
+    for(qint32 i = 0; i < p_list.size(); ++i)
+    {
+        p_hash.addData(p_list[i].toUtf8());
+        p_hash.addData("\n", 1);
+    }
+}
+
+
+//*************************************************************************************************************
+
+QString MNEOperatorCache::filePath(const QString &p_sPrefix, const QString &p_sKey) const
+{
+    return QString("%1/%2-%3.fif").arg(m_sCacheDir).arg(p_sPrefix).arg(p_sKey);
+}
+
+
+//*************************************************************************************************************
+
+bool MNEOperatorCache::writeClustered(const QString &p_sFilePath, const QString &p_sKey, const MNEForwardSolution &p_fwdClustered)
+{
+    if(!QDir().mkpath(QFileInfo(p_sFilePath).absolutePath()))
+        return false;
+
+    QFile t_file(p_sFilePath);
+    FiffStream::SPtr t_pStream = FiffStream::start_file(t_file);
+    if(!t_pStream)
+        return false;
+
+    t_pStream->start_block(FIFFB_MNE_CLUSTERED_FORWARD);
+    t_pStream->write_string(FIFF_MNE_CACHE_KEY, p_sKey);
+
+    const MatrixXd& t_matGain = p_fwdClustered.sol->data;
+    fiff_int_t t_iDims[2] = {(fiff_int_t)t_matGain.rows(), (fiff_int_t)t_matGain.cols()};
+    t_pStream->write_int(FIFF_MNE_CLUSTER_GAIN_DIM, t_iDims, 2);
+    t_pStream->write_double(FIFF_MNE_CLUSTER_GAIN, t_matGain.data(), t_matGain.size());
+
+    for(qint32 h = 0; h < p_fwdClustered.src.size(); ++h)
+    {
+        const MNEHemisphere& t_hemi = p_fwdClustered.src[h];
+        const MNEClusterInfo& t_info = t_hemi.cluster_info;
+        qint32 nClusters = t_info.numClust();
+
+        VectorXi t_vecLabelIds(nClusters);
+        VectorXi t_vecCentroidVertno(nClusters);
+        MatrixXf t_matCentroidRR(nClusters, 3);
+        VectorXi t_vecSizes(nClusters);
+        qint32 nVertices = 0;
+        for(qint32 i = 0; i < nClusters; ++i)
+        {
+            t_vecLabelIds[i] = t_info.clusterLabelIds[i];
+            t_vecCentroidVertno[i] = t_info.centroidVertno[i];
+            t_matCentroidRR.row(i) = t_info.centroidSource_rr[i].transpose();
+            t_vecSizes[i] = t_info.clusterVertnos[i].size();
+            nVertices += t_vecSizes[i];
+        }
+
+        VectorXi t_vecVertnos(nVertices);
+        MatrixXf t_matSourceRR(nVertices, 3);
+        VectorXd t_vecDistances(nVertices);
+        qint32 offset = 0;
+        for(qint32 i = 0; i < nClusters; ++i)
+        {
+            t_vecVertnos.segment(offset, t_vecSizes[i]) = t_info.clusterVertnos[i];
+            t_matSourceRR.block(offset, 0, t_vecSizes[i], 3) = t_info.clusterSource_rr[i];
+            t_vecDistances.segment(offset, t_vecSizes[i]) = t_info.clusterDistances[i];
+            offset += t_vecSizes[i];
+        }
+
+        t_pStream->start_block(FIFFB_MNE_CLUSTER_INFO);
+        t_pStream->write_int(FIFF_MNE_HEMI, &h);
+        t_pStream->write_int(FIFF_MNE_CLUSTER_VERTNO, t_hemi.vertno.data(), t_hemi.vertno.size());
+        t_pStream->write_int(FIFF_MNE_CLUSTER_LABEL_IDS, t_vecLabelIds.data(), nClusters);
+        t_pStream->write_name_list(FIFF_MNE_CLUSTER_LABEL_NAMES, QStringList(t_info.clusterLabelNames));
+        t_pStream->write_int(FIFF_MNE_CLUSTER_CENTROID_VERTNO, t_vecCentroidVertno.data(), nClusters);
+        t_pStream->write_float_matrix(FIFF_MNE_CLUSTER_CENTROID_RR, t_matCentroidRR);
+        t_pStream->write_int(FIFF_MNE_CLUSTER_SIZES, t_vecSizes.data(), nClusters);
+        t_pStream->write_int(FIFF_MNE_CLUSTER_VERTNOS, t_vecVertnos.data(), nVertices);
+        t_pStream->write_float_matrix(FIFF_MNE_CLUSTER_SOURCE_RR, t_matSourceRR);
+        t_pStream->write_double(FIFF_MNE_CLUSTER_DISTANCES, t_vecDistances.data(), nVertices);
+        t_pStream->end_block(FIFFB_MNE_CLUSTER_INFO);
+    }
+
+    t_pStream->end_block(FIFFB_MNE_CLUSTERED_FORWARD);
+    t_pStream->end_file();
+
+    t_file.close();
+
+    return t_file.error() == QFile::NoError;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEOperatorCache::readClustered(const QString &p_sFilePath, const QString &p_sKey, const MNEForwardSolution &p_fwd, MNEForwardSolution &p_fwdClustered)
+{
+    if(!QFile::exists(p_sFilePath))
+        return false;
+
+    QFile t_file(p_sFilePath);
+    FiffStream::SPtr t_pStream(new FiffStream(&t_file));
+    if(!t_pStream->open())
+        return false;
+
+    QList<FiffDirNode> t_qListNodes = t_pStream->tree().dir_tree_find(FIFFB_MNE_CLUSTERED_FORWARD);
+    if(t_qListNodes.size() != 1)
+        return false;
+    const FiffDirNode& t_node = t_qListNodes[0];
+
+    FiffTag::SPtr t_pTag;
+
+    //
+    // The key has to match, the file name alone could have been copied or truncated
+    //
+    if(!t_node.find_tag(t_pStream.data(), FIFF_MNE_CACHE_KEY, t_pTag) || t_pTag->toString() != p_sKey)
+        return false;
+
+    if(!t_node.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_GAIN_DIM, t_pTag) || t_pTag->size() != 2*4)
+        return false;
+    qint32 nRows = t_pTag->toInt()[0];
+    qint32 nCols = t_pTag->toInt()[1];
+
+    if(nRows != p_fwd.sol->data.rows() || nCols % 3 != 0)
+        return false;
+
+    if(!t_node.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_GAIN, t_pTag) || !t_pTag->toDouble() || t_pTag->size() != (qint64)nRows*nCols*8)
+        return false;
+    MatrixXd t_matGain = Map<MatrixXd>(t_pTag->toDouble(), nRows, nCols);
+
+    QList<FiffDirNode> t_qListHemis = t_node.dir_tree_find(FIFFB_MNE_CLUSTER_INFO);
+    if(t_qListHemis.size() != p_fwd.src.size())
+        return false;
+
+    p_fwdClustered = MNEForwardSolution(p_fwd);
+
+    qint32 nTotalClusters = 0;
+    for(qint32 k = 0; k < t_qListHemis.size(); ++k)
+    {
+        const FiffDirNode& t_hemiNode = t_qListHemis[k];
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_HEMI, t_pTag))
+            return false;
+        qint32 h = *t_pTag->toInt();
+        if(h < 0 || h >= p_fwd.src.size())
+            return false;
+
+        MNEHemisphere& t_hemi = p_fwdClustered.src[h];
+        MNEClusterInfo& t_info = t_hemi.cluster_info;
+        t_info.clear();
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_VERTNO, t_pTag))
+            return false;
+        t_hemi.vertno = Map<VectorXi>(t_pTag->toInt(), t_pTag->size()/4);
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_SIZES, t_pTag))
+            return false;
+        VectorXi t_vecSizes = Map<VectorXi>(t_pTag->toInt(), t_pTag->size()/4);
+        qint32 nClusters = t_vecSizes.size();
+        qint32 nVertices = t_vecSizes.sum();
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_LABEL_IDS, t_pTag) || t_pTag->size()/4 != nClusters)
+            return false;
+        VectorXi t_vecLabelIds = Map<VectorXi>(t_pTag->toInt(), nClusters);
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_LABEL_NAMES, t_pTag))
+            return false;
+        QStringList t_listLabelNames = FiffStream::split_name_list(t_pTag->toString());
+        if(t_listLabelNames.size() != nClusters)
+            return false;
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_CENTROID_VERTNO, t_pTag) || t_pTag->size()/4 != nClusters)
+            return false;
+        VectorXi t_vecCentroidVertno = Map<VectorXi>(t_pTag->toInt(), nClusters);
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_CENTROID_RR, t_pTag))
+            return false;
+        MatrixXf t_matCentroidRR = t_pTag->toFloatMatrix();
+        if(t_matCentroidRR.rows() != nClusters || t_matCentroidRR.cols() != 3)
+            return false;
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_VERTNOS, t_pTag) || t_pTag->size()/4 != nVertices)
+            return false;
+        VectorXi t_vecVertnos = Map<VectorXi>(t_pTag->toInt(), nVertices);
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_SOURCE_RR, t_pTag))
+            return false;
+        MatrixXf t_matSourceRR = t_pTag->toFloatMatrix();
+        if(t_matSourceRR.rows() != nVertices || t_matSourceRR.cols() != 3)
+            return false;
+
+        if(!t_hemiNode.find_tag(t_pStream.data(), FIFF_MNE_CLUSTER_DISTANCES, t_pTag) || !t_pTag->toDouble() || t_pTag->size()/8 != nVertices)
+            return false;
+        VectorXd t_vecDistances = Map<VectorXd>(t_pTag->toDouble(), nVertices);
+
+        qint32 offset = 0;
+        for(qint32 i = 0; i < nClusters; ++i)
+        {
+            t_info.clusterLabelIds.append(t_vecLabelIds[i]);
+            t_info.clusterLabelNames.append(t_listLabelNames[i]);
+            t_info.centroidVertno.append(t_vecCentroidVertno[i]);
+            t_info.centroidSource_rr.append(t_matCentroidRR.row(i).transpose());
+            t_info.clusterVertnos.append(t_vecVertnos.segment(offset, t_vecSizes[i]));
+            t_info.clusterSource_rr.append(t_matSourceRR.block(offset, 0, t_vecSizes[i], 3));
+            t_info.clusterDistances.append(t_vecDistances.segment(offset, t_vecSizes[i]));
+            offset += t_vecSizes[i];
+        }
+
+        nTotalClusters += nClusters;
+    }
+
+    // Free orientation: three gain columns per cluster
+    if(nTotalClusters*3 != nCols)
+        return false;
+
+    p_fwdClustered.sol->data = t_matGain;
+    p_fwdClustered.sol->ncol = nCols;
+    p_fwdClustered.nsource = nCols/3;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEOperatorCache::commitFile(const QString &p_sTmpPath, const QString &p_sFilePath)
+{
+    if(QFile::exists(p_sFilePath) && !QFile::remove(p_sFilePath))
+        return false;
+
+    return QFile::rename(p_sTmpPath, p_sFilePath);
+}
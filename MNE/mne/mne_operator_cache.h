@@ -0,0 +1,288 @@
+//=============================================================================================================
+/**
+* @file     mne_operator_cache.h
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MNEOperatorCache class declaration, which provides an on-disk cache for clustered forward
+*           solutions and inverse operators.
+*
+*/
+
+#ifndef MNE_OPERATOR_CACHE_H
+#define MNE_OPERATOR_CACHE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_global.h"
+#include "mne_forwardsolution.h"
+#include "mne_inverse_operator.h"
+
+#include <fs/annotationset.h>
+
+#include <fiff/fiff_cov.h>
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QString>
+#include <QCryptographicHash>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNELIB
+//=============================================================================================================
+
+namespace MNELIB
+{
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace FSLIB;
+using namespace FIFFLIB;
+
+
+//=============================================================================================================
+/**
+* Content addressed on-disk cache for clustered forward solutions and inverse operators. Each entry is a FIFF
+* file named after a hash of all inputs of the computation; a missing, unreadable or mismatching entry is
+* recomputed and replaced.
+*
+* @brief On-disk cache for clustered forward solutions and inverse operators
+*/
+class MNESHARED_EXPORT MNEOperatorCache
+{
+public:
+    typedef QSharedPointer<MNEOperatorCache> SPtr;            /**< Shared pointer type for MNEOperatorCache. */
+    typedef QSharedPointer<const MNEOperatorCache> ConstSPtr; /**< Const shared pointer type for MNEOperatorCache. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a cache.
+    *
+    * @param[in] p_sCacheDir    Directory of the cache files. If empty the default cache location is used.
+    */
+    explicit MNEOperatorCache(const QString &p_sCacheDir = QString());
+
+    //=========================================================================================================
+    /**
+    * Returns the cache directory.
+    *
+    * @return the cache directory.
+    */
+    inline QString cacheDir() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the default cache directory, a subdirectory of the writable cache location of the application.
+    *
+    * @return the default cache directory.
+    */
+    static QString defaultCacheDir();
+
+    //=========================================================================================================
+    /**
+    * Same as MNEForwardSolution::cluster_forward_solution, but returns the cached result if the same forward
+    * solution was clustered with the same parameters before.
+    *
+    * @param[in]    p_fwd               The forward solution to cluster
+    * @param[in]    p_AnnotationSet     Annotation set containing the annotation of left & right hemisphere
+    * @param[in]    p_iClusterSize      Maximal cluster size per roi
+    * @param[out]   p_D                 The cluster operator
+    * @param[in]    p_pNoise_cov        Noise covariance used to whiten the gain matrix (optional)
+    * @param[in]    p_pInfo             Measurement info used to whiten the gain matrix (optional)
+    * @param[in]    p_sMethod           "cityblock" or "sqeuclidean"
+    *
+    * @return clustered MNE forward solution
+    */
+    MNEForwardSolution cluster_forward_solution(const MNEForwardSolution &p_fwd, const AnnotationSet &p_AnnotationSet, qint32 p_iClusterSize, MatrixXd& p_D = defaultD, const FiffCov &p_pNoise_cov = defaultCov, const FiffInfo &p_pInfo = defaultInfo, QString p_sMethod = "cityblock") const;
+
+    //=========================================================================================================
+    /**
+    * Same as MNEInverseOperator::make_inverse_operator, but returns the cached operator if it was assembled
+    * from the same inputs before.
+    *
+    * @param[in] info               The measurement info to specify the channels to include.
+    * @param[in] forward            Forward operator.
+    * @param[in] p_noise_cov        The noise covariance matrix.
+    * @param[in] loose              Value that weights the source variances of the dipole components.
+    * @param[in] depth              Depth weighting coefficients.
+    * @param[in] fixed              Use fixed source orientations normal to the cortical mantle.
+    * @param[in] limit_depth_chs    If True, use only grad channels in depth weighting.
+    *
+    * @return the assembled inverse operator
+    */
+    MNEInverseOperator make_inverse_operator(const FiffInfo &info, const MNEForwardSolution &forward, const FiffCov& p_noise_cov, float loose = 0.2f, float depth = 0.8f, bool fixed = false, bool limit_depth_chs = true) const;
+
+    //=========================================================================================================
+    /**
+    * Removes all cache files.
+    */
+    void clear() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Feeds a forward solution into a hash.
+    *
+    * @param[in, out] p_hash    The hash.
+    * @param[in] p_fwd          The forward solution.
+    */
+    static void addToHash(QCryptographicHash &p_hash, const MNEForwardSolution &p_fwd);
+
+    //=========================================================================================================
+    /**
+    * Feeds a covariance into a hash.
+    *
+    * @param[in, out] p_hash    The hash.
+    * @param[in] p_cov          The covariance.
+    */
+    static void addToHash(QCryptographicHash &p_hash, const FiffCov &p_cov);
+
+    //=========================================================================================================
+    /**
+    * Feeds the channel selection and projectors of a measurement info into a hash.
+    *
+    * @param[in, out] p_hash    The hash.
+    * @param[in] p_info         The measurement info.
+    */
+    static void addToHash(QCryptographicHash &p_hash, const FiffInfo &p_info);
+
+    //=========================================================================================================
+    /**
+    * Feeds a matrix into a hash.
+    *
+    * @param[in, out] p_hash    The hash.
+    * @param[in] p_mat          The matrix.
+    */
+    static void addToHash(QCryptographicHash &p_hash, const MatrixXd &p_mat);
+
+    //=========================================================================================================
+    /**
+    * Feeds a list of strings into a hash.
+    *
+    * @param[in, out] p_hash    The hash.
+    * @param[in] p_list         The strings.
+    */
+    static void addToHash(QCryptographicHash &p_hash, const QStringList &p_list);
+
+    //=========================================================================================================
+    /**
+    * Returns the path of the cache file of a key.
+    *
+    * @param[in] p_sPrefix      Kind of the cached data.
+    * @param[in] p_sKey         The key.
+    *
+    * @return the file path.
+    */
+    QString filePath(const QString &p_sPrefix, const QString &p_sKey) const;
+
+    //=========================================================================================================
+    /**
+    * Writes the clustering result of a clustered forward solution.
+    *
+    * @param[in] p_sFilePath    The cache file.
+    * @param[in] p_sKey         The key of the entry.
+    * @param[in] p_fwdClustered The clustered forward solution.
+    *
+    * @return true if succeeded, false otherwise.
+    */
+    static bool writeClustered(const QString &p_sFilePath, const QString &p_sKey, const MNEForwardSolution &p_fwdClustered);
+
+    //=========================================================================================================
+    /**
+    * Reads a clustering result and applies it to a copy of the unclustered forward solution.
+    *
+    * @param[in] p_sFilePath    The cache file.
+    * @param[in] p_sKey         The expected key of the entry.
+    * @param[in] p_fwd          The unclustered forward solution.
+    * @param[out] p_fwdClustered The clustered forward solution.
+    *
+    * @return true if the entry is valid, false otherwise.
+    */
+    static bool readClustered(const QString &p_sFilePath, const QString &p_sKey, const MNEForwardSolution &p_fwd, MNEForwardSolution &p_fwdClustered);
+
+    //=========================================================================================================
+    /**
+    * Restores the source space of a cached inverse operator from the forward solution it was computed from.
+    * The vertno and cluster_info of clustered hemispheres are copied, the vertno of unclustered ones has to match.
+    *
+    * @param[in] p_fwd          The forward solution the inverse operator was computed from.
+    * @param[in, out] p_invOp   The inverse operator read from the cache.
+    *
+    * @return true if the source spaces are consistent, false otherwise.
+    */
+    static bool restoreSourceSpace(const MNEForwardSolution &p_fwd, MNEInverseOperator &p_invOp);
+
+    //=========================================================================================================
+    /**
+    * Moves a completely written temporary file to its final location.
+    *
+    * @param[in] p_sTmpPath     The temporary file.
+    * @param[in] p_sFilePath    The final file.
+    *
+    * @return true if succeeded, false otherwise.
+    */
+    static bool commitFile(const QString &p_sTmpPath, const QString &p_sFilePath);
+
+    QString m_sCacheDir;    /**< Directory of the cache files. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline QString MNEOperatorCache::cacheDir() const
+{
+    return m_sCacheDir;
+}
+
+} // NAMESPACE
+
+#endif // MNE_OPERATOR_CACHE_H
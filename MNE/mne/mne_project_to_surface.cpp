@@ -56,6 +56,11 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QtConcurrent>
+#include <QThread>
+#include <QVector>
+#include <QDebug>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -65,6 +70,15 @@
 #include <Eigen/Geometry>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <limits>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -79,6 +93,23 @@ using namespace Eigen;
 // DEFINE GLOBAL METHODS
 //=============================================================================================================
 
+#define BVH_LEAF_SIZE 8         /* Maximum number of triangles in a leaf of the bounding volume hierarchy */
+#define BVH_MAX_DEPTH 64        /* Traversal stack size, the median split keeps the depth at about log2(ntri) */
+
+/**
+* Orders triangles by the coordinate of their centroid along one axis
+*/
+struct CentroidLess
+{
+    const MatrixX3f* pCentroids;
+    int iAxis;
+
+    bool operator()(int i, int j) const
+    {
+        return (*pCentroids)(i,iAxis) < (*pCentroids)(j,iAxis);
+    }
+};
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -95,7 +126,7 @@ MNEProjectToSurface::MNEProjectToSurface()
 , c(VectorXf::Zero(1))
 , det(VectorXf::Zero(1))
 {
-
+    this->build_bvh();
 }
 
 
@@ -132,7 +163,17 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
             nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).transpose();
         }
     }
+    for (int i = 0; i < nn.rows(); ++i)
+    {
+        float len = nn.row(i).norm();
+        if (len > 0)
+        {
+            nn.row(i) /= len;
+        }
+    }
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+
+    this->build_bvh();
 }
 
 
@@ -159,17 +200,31 @@ MNEProjectToSurface::MNEProjectToSurface(const MNESurface &p_MNESurf)
         c(i) = r12.row(i) * r13.row(i).transpose();
     }
 
+    for (int i = 0; i < nn.rows(); ++i)
+    {
+        float len = nn.row(i).norm();
+        if (len > 0)
+        {
+            nn.row(i) /= len;
+        }
+    }
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+
+    this->build_bvh();
 }
 
 
 //*************************************************************************************************************
 
 bool MNEProjectToSurface::mne_find_closest_on_surface(const MatrixXf &r, const int np, MatrixXf &rTri,
-                                                      VectorXi &nearest, VectorXf &dist)
+                                                      VectorXi &nearest, VectorXf &dist) const
 {
     nearest.resize(np);
     dist.resize(np);
+    if (rTri.rows() < np || rTri.cols() != 3)
+    {
+        rTri.resize(np, 3);
+    }
     if (this->r1.isZero(0))
     {
         qDebug() << "No surface loaded to make the projection./n";
@@ -182,7 +237,7 @@ bool MNEProjectToSurface::mne_find_closest_on_surface(const MatrixXf &r, const i
     {
         /*
          * To do: decide_search_restriction for the use in an iterative closest point to plane algorithm
-         * For now it's OK to go through all triangles.
+         * The bounding volume hierarchy restricts the search to the triangles near the point.
          */
         if (!this->mne_project_to_surface(r.row(k).transpose(), rTriK, bestTri, bestDist))
         {
@@ -199,25 +254,225 @@ bool MNEProjectToSurface::mne_find_closest_on_surface(const MatrixXf &r, const i
 
 //*************************************************************************************************************
 
-bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rTri, int &bestTri, float &bestDist)
+bool MNEProjectToSurface::mne_find_closest_on_surface_concurrent(const MatrixXf &r, const int np, MatrixXf &rTri,
+                                                                 VectorXi &nearest, VectorXf &dist) const
+{
+    nearest.resize(np);
+    dist.resize(np);
+    if (rTri.rows() < np || rTri.cols() != 3)
+    {
+        rTri.resize(np, 3);
+    }
+    if (this->r1.isZero(0))
+    {
+        qDebug() << "No surface loaded to make the projection./n";
+        return false;
+    }
+
+    //Use a few chunks per thread to balance the load
+    int nChunks = qMax(1, qMin(np, 4*QThread::idealThreadCount()));
+    int chunkSize = (np + nChunks - 1) / nChunks;
+
+    QList<ProjectionChunk> chunks;
+    for (int first = 0; first < np; first += chunkSize)
+    {
+        ProjectionChunk chunk;
+        chunk.pProjector = this;
+        chunk.pR = &r;
+        chunk.pRTri = &rTri;
+        chunk.pNearest = &nearest;
+        chunk.pDist = &dist;
+        chunk.iFirst = first;
+        chunk.iLast = qMin(first + chunkSize, np);
+        chunks.append(chunk);
+    }
+
+    QList<bool> results = QtConcurrent::blockingMapped(chunks, &MNEProjectToSurface::project_chunk);
+
+    return !results.contains(false);
+}
+
+
+//*************************************************************************************************************
+
+bool MNEProjectToSurface::project_chunk(const ProjectionChunk &chunk)
+{
+    int bestTri = -1;
+    float bestDist = -1;
+    Vector3f rTriK;
+    for (int k = chunk.iFirst; k < chunk.iLast; ++k)
+    {
+        if (!chunk.pProjector->mne_project_to_surface(chunk.pR->row(k).transpose(), rTriK, bestTri, bestDist))
+        {
+            qDebug() << "The projection of point number " << k << " didn't work./n";
+            return false;
+        }
+        chunk.pRTri->row(k) = rTriK.transpose();
+        (*chunk.pNearest)[k] = bestTri;
+        (*chunk.pDist)[k] = bestDist;
+    }
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void MNEProjectToSurface::build_bvh()
+{
+    int ntri = a.size();
+
+    //Bounding boxes and centroids of the triangles
+    MatrixX3f triMin(ntri,3), triMax(ntri,3), centroids(ntri,3);
+    for (int i = 0; i < ntri; ++i)
+    {
+        RowVector3f v1 = r1.row(i);
+        RowVector3f v2 = v1 + r12.row(i);
+        RowVector3f v3 = v1 + r13.row(i);
+        triMin.row(i) = v1.cwiseMin(v2).cwiseMin(v3);
+        triMax.row(i) = v1.cwiseMax(v2).cwiseMax(v3);
+        centroids.row(i) = (v1 + v2 + v3) / 3.0f;
+    }
+
+    triOrder.resize(ntri);
+    for (int i = 0; i < ntri; ++i)
+    {
+        triOrder[i] = i;
+    }
+
+    int maxNodes = qMax(1, 2*ntri);
+    boxMin.resize(maxNodes,3);
+    boxMax.resize(maxNodes,3);
+    nodeChild = VectorXi::Constant(maxNodes,-1);
+    nodeFirst = VectorXi::Zero(maxNodes);
+    nodeCount = VectorXi::Zero(maxNodes);
+
+    //Nodes still to be processed, stored as (node, first, count)
+    QVector<Vector3i> todo;
+    todo.append(Vector3i(0, 0, ntri));
+    int nNodes = 1;
+
+    while (!todo.isEmpty())
+    {
+        Vector3i job = todo.takeLast();
+        int node = job[0], first = job[1], count = job[2];
+
+        RowVector3f bMin = RowVector3f::Constant(std::numeric_limits<float>::max());
+        RowVector3f bMax = RowVector3f::Constant(-std::numeric_limits<float>::max());
+        RowVector3f cMin = bMin, cMax = bMax;
+        for (int i = first; i < first + count; ++i)
+        {
+            int tri = triOrder[i];
+            bMin = bMin.cwiseMin(triMin.row(tri));
+            bMax = bMax.cwiseMax(triMax.row(tri));
+            cMin = cMin.cwiseMin(centroids.row(tri));
+            cMax = cMax.cwiseMax(centroids.row(tri));
+        }
+        boxMin.row(node) = bMin;
+        boxMax.row(node) = bMax;
+
+        if (count <= BVH_LEAF_SIZE)
+        {
+            nodeFirst[node] = first;
+            nodeCount[node] = count;
+            continue;
+        }
+
+        //Split at the median centroid along the longest axis
+        CentroidLess less;
+        less.pCentroids = &centroids;
+        (cMax - cMin).maxCoeff(&less.iAxis);
+        int mid = first + count/2;
+        std::nth_element(triOrder.data() + first, triOrder.data() + mid, triOrder.data() + first + count, less);
+
+        nodeChild[node] = nNodes;
+        todo.append(Vector3i(nNodes, first, mid - first));
+        todo.append(Vector3i(nNodes + 1, mid, first + count - mid));
+        nNodes += 2;
+    }
+
+    boxMin.conservativeResize(nNodes,3);
+    boxMax.conservativeResize(nNodes,3);
+    nodeChild.conservativeResize(nNodes);
+    nodeFirst.conservativeResize(nNodes);
+    nodeCount.conservativeResize(nNodes);
+}
+
+
+//*************************************************************************************************************
+
+float MNEProjectToSurface::box_distance2(const Vector3f &r, const int node) const
+{
+    Vector3f below = (this->boxMin.row(node).transpose() - r).cwiseMax(0.0f);
+    Vector3f above = (r - this->boxMax.row(node).transpose()).cwiseMax(0.0f);
+    return below.squaredNorm() + above.squaredNorm();
+}
+
+
+//*************************************************************************************************************
+
+bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rTri, int &bestTri, float &bestDist) const
 {
     float p = 0, q = 0, p0 = 0, q0 = 0, dist0 = 0;
+    float bestAbs = std::numeric_limits<float>::max();
     bestDist = 0;
     bestTri = -1;
-    for (int tri = 0; tri < a .size(); ++tri)
+
+    /*
+     * Traverse the bounding volume hierarchy, nearer children first. Boxes which are farther away than the best
+     * triangle so far cannot contain a closer triangle and are skipped.
+     */
+    int stack[BVH_MAX_DEPTH];
+    int nStack = 0;
+    stack[nStack++] = 0;
+
+    while (nStack > 0)
     {
-        if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
+        int node = stack[--nStack];
+        if (this->box_distance2(r, node) > bestAbs*bestAbs)
         {
-            qDebug() << "The projection on triangle " << tri << " didn't work./n";
-            return false;
+            continue;
         }
 
-        if ((bestTri < 0) || (fabs(dist0) < fabs(bestDist)))
+        if (this->nodeChild[node] < 0)
+        {
+            for (int i = this->nodeFirst[node]; i < this->nodeFirst[node] + this->nodeCount[node]; ++i)
+            {
+                int tri = this->triOrder[i];
+                if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
+                {
+                    qDebug() << "The projection on triangle " << tri << " didn't work./n";
+                    return false;
+                }
+
+                //Ties go to the lowest triangle index, as in an exhaustive search
+                if ((bestTri < 0) || (fabs(dist0) < bestAbs) || (fabs(dist0) == bestAbs && tri < bestTri))
+                {
+                    bestDist = dist0;
+                    bestAbs = fabs(dist0);
+                    p = p0;
+                    q = q0;
+                    bestTri = tri;
+                }
+            }
+            continue;
+        }
+
+        int left = this->nodeChild[node];
+        int right = left + 1;
+        if (nStack + 2 > BVH_MAX_DEPTH)
+        {
+            qDebug() << "The bounding volume hierarchy is too deep./n";
+            return false;
+        }
+        if (this->box_distance2(r, left) <= this->box_distance2(r, right))
+        {
+            stack[nStack++] = right;
+            stack[nStack++] = left;
+        }
+        else
         {
-            bestDist = dist0;
-            p = p0;
-            q = q0;
-            bestTri = tri;
+            stack[nStack++] = left;
+            stack[nStack++] = right;
         }
     }
 
@@ -238,7 +493,7 @@ bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rT
 
 //*************************************************************************************************************
 
-bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tri, float &p, float &q, float &dist)
+bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tri, float &p, float &q, float &dist) const
 {
     //Calculate some helpers
     Vector3f rr = r - this->r1.row(tri).transpose(); //Vector from triangle corner #1 to r
@@ -347,7 +602,7 @@ bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tr
 
 //*************************************************************************************************************
 
-bool MNEProjectToSurface::project_to_triangle(Vector3f &rTri, const float p, const float q, const int tri)
+bool MNEProjectToSurface::project_to_triangle(Vector3f &rTri, const float p, const float q, const int tri) const
 {
     rTri = this->r1.row(tri) + p*this->r12.row(tri) + q*this->r13.row(tri);
     return true;
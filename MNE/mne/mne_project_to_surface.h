@@ -135,11 +135,72 @@ public:
      * @return true if succeeded, false otherwise
      */
     bool mne_find_closest_on_surface(const Eigen::MatrixXf &r, const int np, Eigen::MatrixXf &rTri,
-                                     Eigen::VectorXi &nearest, Eigen::VectorXf &dist);
+                                     Eigen::VectorXi &nearest, Eigen::VectorXf &dist) const;
+
+    //=========================================================================================================
+    /**
+     * Projects a set of points r on the Surface. The points are split into chunks which are projected
+     * concurrently. The results are identical to mne_find_closest_on_surface.
+     *
+     * @brief mne_find_closest_on_surface_concurrent
+     *
+     * @param[in] r         Set of pionts, which are to be projectied.
+     * @param[in] np        number of points
+     * @param[out] rTri     set of points on the surface
+     * @param[out] nearest  Triangle of the new point
+     * @param[out] dist     Distance between r and rTri
+     *
+     * @return true if succeeded, false otherwise
+     */
+    bool mne_find_closest_on_surface_concurrent(const Eigen::MatrixXf &r, const int np, Eigen::MatrixXf &rTri,
+                                                Eigen::VectorXi &nearest, Eigen::VectorXf &dist) const;
 
 protected:
 
 private:
+    /**
+     * A range of points which is projected by one worker of mne_find_closest_on_surface_concurrent
+     */
+    struct ProjectionChunk {
+        const MNEProjectToSurface*  pProjector;    /**< The projector */
+        const Eigen::MatrixXf*      pR;            /**< The points to project */
+        Eigen::MatrixXf*            pRTri;         /**< The projected points */
+        Eigen::VectorXi*            pNearest;      /**< The nearest triangles */
+        Eigen::VectorXf*            pDist;         /**< The distances */
+        int                         iFirst;        /**< First point of the chunk */
+        int                         iLast;         /**< One past the last point of the chunk */
+    };
+
+    //=========================================================================================================
+    /**
+     * Projects the points of one chunk. Used by mne_find_closest_on_surface_concurrent.
+     *
+     * @param[in] chunk     The chunk to project
+     *
+     * @return true if succeeded, false otherwise
+     */
+    static bool project_chunk(const ProjectionChunk &chunk);
+
+    //=========================================================================================================
+    /**
+     * Builds the bounding volume hierarchy over the triangles. Each node stores the axis aligned bounding box
+     * of its triangles; inner nodes are split at the median triangle centroid along the longest axis.
+     *
+     * @brief build_bvh
+     */
+    void build_bvh();
+
+    //=========================================================================================================
+    /**
+     * Squared distance between a point and the bounding box of a node of the bounding volume hierarchy.
+     *
+     * @param[in] r     Point in space
+     * @param[in] node  The node of the bounding volume hierarchy
+     *
+     * @return the squared distance, 0 if r lies inside the box
+     */
+    float box_distance2(const Eigen::Vector3f &r, const int node) const;
+
     //=========================================================================================================
     /**
      * Projects a point r on the Surface
@@ -153,7 +214,7 @@ private:
      *
      * @return true if succeeded, false otherwise
      */
-    bool mne_project_to_surface(const Eigen::Vector3f &r, Eigen::Vector3f &rTri, int &bestTri, float &bestDist);
+    bool mne_project_to_surface(const Eigen::Vector3f &r, Eigen::Vector3f &rTri, int &bestTri, float &bestDist) const;
 
     //=========================================================================================================
     /**
@@ -169,7 +230,7 @@ private:
      *
      * @return true if succeeded, false otherwise
      */
-    bool nearest_triangle_point(const Eigen::Vector3f &r, const int tri, float &p, float &q, float &dist);
+    bool nearest_triangle_point(const Eigen::Vector3f &r, const int tri, float &p, float &q, float &dist) const;
 
     //=========================================================================================================
     /**
@@ -184,7 +245,7 @@ private:
      *
      * @return true if succeeded, false otherwise
      */
-    bool project_to_triangle(Eigen::Vector3f &rTri, const float p, const float q, const int tri);
+    bool project_to_triangle(Eigen::Vector3f &rTri, const float p, const float q, const int tri) const;
 
     Eigen::MatrixX3f r1;         /**< Cartesian Vector to the first triangel corner */
     Eigen::MatrixX3f r12;        /**< Cartesian Vector from the first to the second triangel corner */
@@ -194,6 +255,13 @@ private:
     Eigen::VectorXf b;           /**< r13*r13 */
     Eigen::VectorXf c;           /**< r12*r13 */
     Eigen::VectorXf det;         /**< Determinant of the Matrix [a c, c b] */
+
+    Eigen::MatrixX3f boxMin;     /**< Minimum corner of the bounding box of each node of the bounding volume hierarchy */
+    Eigen::MatrixX3f boxMax;     /**< Maximum corner of the bounding box of each node of the bounding volume hierarchy */
+    Eigen::VectorXi nodeChild;   /**< Index of the first child of each node (the second child follows it), -1 for leafs */
+    Eigen::VectorXi nodeFirst;   /**< First entry of a leaf in triOrder */
+    Eigen::VectorXi nodeCount;   /**< Number of triangles of a leaf */
+    Eigen::VectorXi triOrder;    /**< Triangle indices sorted by leaf */
 };
 
 
@@ -44,7 +44,6 @@
 
 #include <utils/ioutils.h>
 #include <utils/detecttrigger.h>
-#include <utils/mnemath.h>
 
 #include <iostream>
 
@@ -508,26 +507,43 @@ void RtAve::mergeData(double dTriggerType)
 {
     QMutexLocker locker(&m_qMutex);
 
-    MatrixXd mergedData(m_mapDataPre[dTriggerType].rows(), m_mapDataPre[dTriggerType].cols() + m_mapDataPost[dTriggerType].cols());
+    const MatrixXd& matDataPre = m_mapDataPre[dTriggerType];
+    const MatrixXd& matDataPost = m_mapDataPost[dTriggerType];
 
-    mergedData << m_mapDataPre[dTriggerType], m_mapDataPost[dTriggerType];
+    //Merge into the reused epoch matrix of this trigger type
+    MatrixXd& mergedData = m_mapMergedData[dTriggerType];
+    mergedData.resize(matDataPre.rows(), matDataPre.cols() + matDataPost.cols());
+    mergedData.leftCols(matDataPre.cols()) = matDataPre;
+    mergedData.rightCols(matDataPost.cols()) = matDataPost;
 
     //Perform artifact threshold
     bool bArtifactedDetected = checkForArtifact(mergedData);
 
     if(bArtifactedDetected == false) {
-        //Add cut data to average buffer
-        m_mapStimAve[dTriggerType].append(mergedData);
+        QList<MatrixXd>& lEpochs = m_mapStimAve[dTriggerType];
+        MatrixXd& matSum = m_mapStimAveSum[dTriggerType];
+        qint32& iNextEpoch = m_mapStimAveNextIdx[dTriggerType];
 
-        //Pop data from buffer
-        if(m_mapStimAve[dTriggerType].size() > m_iNumAverages && m_iNumAverages >= 1) {
-            m_mapStimAve[dTriggerType].pop_front();
+        //Zero number of averages keeps the latest epoch only
+        qint32 iMaxEpochs = qMax(1, m_iNumAverages);
+
+        if(matSum.rows() != mergedData.rows() || matSum.cols() != mergedData.cols()) {
+            matSum = MatrixXd::Zero(mergedData.rows(), mergedData.cols());
         }
 
-        //Proceed a bit different if we use zero number of averages
-        if(m_mapStimAve[dTriggerType].size() > 1 && m_iNumAverages == 0) {
-            m_mapStimAve[dTriggerType].pop_front();
+        if(lEpochs.size() < iMaxEpochs) {
+            //Add cut data to average buffer
+            lEpochs.append(mergedData);
+            matSum += mergedData;
+        } else {
+            //Replace the oldest epoch and reuse its memory for the next merge
+            MatrixXd& matOldest = lEpochs[iNextEpoch];
+            matSum -= matOldest;
+            matOldest.swap(mergedData);
+            matSum += matOldest;
         }
+
+        iNextEpoch = (iNextEpoch + 1) % iMaxEpochs;
     }
 }
 
@@ -647,17 +663,17 @@ void RtAve::generateEvoked(double dTriggerType)
 {
     QMutexLocker locker(&m_qMutex);
 
-    if(m_mapStimAve[dTriggerType].isEmpty()) {
+    const QList<MatrixXd>& lEpochs = m_mapStimAve[dTriggerType];
+
+    if(lEpochs.isEmpty()) {
         return;
     }
 
     //Init evoked
-    FiffEvoked evoked;    
     int iEvokedIdx = -1;
 
     for(int i = 0; i < m_pStimEvokedSet->evoked.size(); ++i) {
         if(m_pStimEvokedSet->evoked.at(i).comment == QString::number(dTriggerType)) {
-            evoked = m_pStimEvokedSet->evoked.at(i);
             iEvokedIdx = i;
             break;
         }
@@ -665,6 +681,7 @@ void RtAve::generateEvoked(double dTriggerType)
 
     //If the evoked is not yet present add it here
     if(iEvokedIdx == -1) {
+        FiffEvoked evoked;
         float T = 1.0/m_pFiffInfo->sfreq;
 
         evoked.setInfo(*m_pFiffInfo.data());
@@ -676,53 +693,78 @@ void RtAve::generateEvoked(double dTriggerType)
         evoked.first = evoked.times[0];
         evoked.last = evoked.times[evoked.times.size()-1];
         evoked.comment = QString::number(dTriggerType);
+
+        m_pStimEvokedSet->evoked.append(evoked);
+        iEvokedIdx = m_pStimEvokedSet->evoked.size() - 1;
     }
 
-    // Generate final evoked
-    MatrixXd finalAverage = MatrixXd::Zero(m_mapStimAve[dTriggerType].first().rows(), m_iPreStimSamples+m_iPostStimSamples);
+    FiffEvoked& evoked = m_pStimEvokedSet->evoked[iEvokedIdx];
 
+    // Generate final evoked
     if(m_iAverageMode == 0) {
-        for(int i = 0; i < m_mapStimAve[dTriggerType].size(); ++i) {
-            finalAverage += m_mapStimAve[dTriggerType].at(i);
-        }
-
-        if(m_mapStimAve[dTriggerType].isEmpty()) {
-            finalAverage = finalAverage/1;
-        } else {
-            finalAverage = finalAverage/m_mapStimAve[dTriggerType].size();
-        }
+        //The running sum holds exactly the stored epochs
+        evoked.data = m_mapStimAveSum[dTriggerType] / lEpochs.size();
 
         if(m_bDoBaselineCorrection) {
-            finalAverage = MNEMath::rescale(finalAverage, evoked.times, m_pairBaselineSec, QString("mean"));
+            applyBaseline(evoked.data, evoked.times);
         }
 
-        evoked.data = finalAverage;
-
         if(m_mapNumberCalcAverages[dTriggerType] < m_iNumAverages) {
             m_mapNumberCalcAverages[dTriggerType]++;
         }
 
         evoked.nave = m_mapNumberCalcAverages[dTriggerType];
     } else if(m_iAverageMode == 1) {
-        MatrixXd tempMatrix = m_mapStimAve[dTriggerType].last();
+        //Latest epoch sits before the next one to be replaced
+        qint32 iLastEpoch = (m_mapStimAveNextIdx[dTriggerType] + lEpochs.size() - 1) % lEpochs.size();
 
         if(m_bDoBaselineCorrection) {
-            tempMatrix = MNEMath::rescale(tempMatrix, evoked.times, m_pairBaselineSec, QString("mean"));
+            MatrixXd tempMatrix = lEpochs.at(iLastEpoch);
+            applyBaseline(tempMatrix, evoked.times);
+            evoked += tempMatrix;
+        } else {
+            evoked += lEpochs.at(iLastEpoch);
         }
 
-        evoked += tempMatrix;
-
         m_mapNumberCalcAverages[dTriggerType]++;
     }
+}
+
+
+//*************************************************************************************************************
+
+void RtAve::applyBaseline(MatrixXd& data, const RowVectorXf& times) const
+{
+    //Same baseline area as MNEMath::rescale, corrected in place
+    qint32 imin = 0;
+    qint32 imax = times.size();
+
+    if(m_pairBaselineSec.first.isValid()) {
+        float bmin = m_pairBaselineSec.first.toFloat();
+        for(qint32 i = 0; i < times.size(); ++i) {
+            if(times[i] >= bmin) {
+                imin = i;
+                break;
+            }
+        }
+    }
 
-    //Add new data to evoked data set
-    if(iEvokedIdx != -1) {
-        //Evoked data is already present
-        m_pStimEvokedSet->evoked[iEvokedIdx] = evoked;
-    } else {
-        //Evoked data is not present yet
-        m_pStimEvokedSet->evoked.append(evoked);
+    if(m_pairBaselineSec.second.isValid()) {
+        float bmax = m_pairBaselineSec.second.toFloat();
+        for(qint32 i = times.size()-1; i >= 0; --i) {
+            if(times[i] <= bmax) {
+                imax = i+1;
+                break;
+            }
+        }
     }
+
+    if(imax <= imin || imax > data.cols()) {
+        return;
+    }
+
+    VectorXd mean = data.middleCols(imin, imax-imin).rowwise().mean();
+    data.colwise() -= mean;
 }
 
 
@@ -758,6 +800,9 @@ void RtAve::reset()
 
     m_qMapDetectedTrigger.clear();
     m_mapStimAve.clear();
+    m_mapStimAveSum.clear();
+    m_mapStimAveNextIdx.clear();
+    m_mapMergedData.clear();
     m_mapDataPre.clear();
     m_mapDataPost.clear();
     m_mapMatDataPostIdx.clear();
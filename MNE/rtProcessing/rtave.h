@@ -285,6 +285,15 @@ private:
     */
     void generateEvoked(double dTriggerType);
 
+    //=========================================================================================================
+    /**
+    * Subtracts the mean of the baseline area from each channel.
+    *
+    * @param[in, out] data      The epoch or average to correct.
+    * @param[in] times          The time of each sample of data.
+    */
+    void applyBaseline(Eigen::MatrixXd& data, const Eigen::RowVectorXf& times) const;
+
     //=========================================================================================================
     /**
     * Checks the givven matrix for artifacts beyond a threshold value.
@@ -345,7 +354,10 @@ private:
     FIFFLIB::FiffEvokedSet::SPtr                    m_pStimEvokedSet;           /**< Holds the evoked information. */
 
     QMap<int,QList<int> >                           m_qMapDetectedTrigger;      /**< Detected trigger for each trigger channel. */
-    QMap<double,QList<Eigen::MatrixXd> >            m_mapStimAve;               /**< the current stimulus average buffer. Holds m_iNumAverages vectors */
+    QMap<double,QList<Eigen::MatrixXd> >            m_mapStimAve;               /**< the current stimulus average buffer. Ring of at most m_iNumAverages epochs */
+    QMap<double,Eigen::MatrixXd>                    m_mapStimAveSum;            /**< Running sum of the epochs in m_mapStimAve. */
+    QMap<double,qint32>                             m_mapStimAveNextIdx;        /**< Index of the epoch in m_mapStimAve which is replaced next. */
+    QMap<double,Eigen::MatrixXd>                    m_mapMergedData;            /**< The reused matrix the pre and post stim data are merged into. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPre;               /**< The matrix holding the pre stim data. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPost;              /**< The matrix holding the post stim data. */
     QMap<double,qint32>                             m_mapMatDataPostIdx;        /**< Current index inside of the matrix m_matDataPost */
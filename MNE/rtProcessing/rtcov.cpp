@@ -44,6 +44,8 @@
 
 #include <iostream>
 #include <fiff/fiff_cov.h>
+#include <fiff/fiff_proj.h>
+#include <utils/mnemath.h>
 
 
 //*************************************************************************************************************
@@ -52,6 +54,23 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/SVD>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
 
 
 //*************************************************************************************************************
@@ -61,6 +80,15 @@
 
 using namespace RTPROCESSINGLIB;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE STATIC METHODS
+//=============================================================================================================
+
+#define MAX_WINDOW_TURNOVERS 8  /* Number of window lengths after which the sliding window statistics are recomputed to bound round-off */
 
 
 //*************************************************************************************************************
@@ -74,6 +102,10 @@ RtCov::RtCov(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 , m_iNewMaxSamples(0)
 , m_pFiffInfo(p_pFiffInfo)
 , m_bIsRunning(false)
+, m_eMode(BlockMode)
+, m_iUpdateInterval(qMax(1, p_iMaxSamples/10))
+, m_dWeight(0.0)
+, m_iWindowSamples(0)
 {
     qRegisterMetaType<FiffCov::SPtr>("FiffCov::SPtr");
 }
@@ -105,10 +137,29 @@ void RtCov::append(const MatrixXd &p_DataSegment)
 
 void RtCov::setSamples(qint32 samples)
 {
+    QMutexLocker locker(&mutex);
     m_iNewMaxSamples = samples;
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::setEstimationMode(EstimationMode mode)
+{
+    QMutexLocker locker(&mutex);
+    m_eMode = mode;
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::setUpdateInterval(qint32 samples)
+{
+    QMutexLocker locker(&mutex);
+    m_iUpdateInterval = qMax(1, samples);
+}
+
+
 //*************************************************************************************************************
 
 bool RtCov::start()
@@ -143,39 +194,104 @@ bool RtCov::stop()
 void RtCov::run()
 {
     //SETUP
-    QStringList exclude;
-    for(int i = 0; i<m_pFiffInfo->chs.size(); i++) {
-        if(m_pFiffInfo->chs.at(i).kind == FIFFV_STIM_CH) {
-            exclude << m_pFiffInfo->chs.at(i).ch_name;
-        }
-    }
-    bool doProj = true;
+    prepareRegularization();
 
     quint32 n_samples = 0;
+    quint32 iSamplesSinceUpdate = 0;
+    quint32 iRemovedSamples = 0;
 
     FiffCov::SPtr cov(new FiffCov());
     VectorXd mu;
 
+    EstimationMode lastMode = m_eMode;
+    m_dWeight = 0.0;
+    m_lWindow.clear();
+    m_iWindowSamples = 0;
+
     while(m_bIsRunning)
     {
         if(m_pRawMatrixBuffer)
         {
             MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
 
+            mutex.lock();
+            if(m_iNewMaxSamples > 0) {
+                m_iMaxSamples = m_iNewMaxSamples;
+                m_iNewMaxSamples = 0;
+            }
+            EstimationMode mode = m_eMode;
+            quint32 iUpdateInterval = m_iUpdateInterval;
+            mutex.unlock();
+
+            //Start over if the mode changed
+            if(mode != lastMode) {
+                n_samples = 0;
+                iSamplesSinceUpdate = 0;
+                iRemovedSamples = 0;
+                m_dWeight = 0.0;
+                m_lWindow.clear();
+                m_iWindowSamples = 0;
+                lastMode = mode;
+            }
+
+            if(mode != BlockMode)
+            {
+                //Running estimation, the statistics are updated with every block
+                if(mode == ForgettingMode && m_dWeight > 0.0) {
+                    double dForget = std::pow(1.0 - 1.0/qMax(m_iMaxSamples, (quint32)2), (double)rawSegment.cols());
+                    m_dWeight *= dForget;
+                    m_matScatter.triangularView<Lower>() *= dForget;
+                }
+
+                addBlock(rawSegment);
+
+                if(mode == SlidingWindowMode) {
+                    m_lWindow.append(rawSegment);
+                    m_iWindowSamples += rawSegment.cols();
+
+                    while(m_lWindow.size() > 1 && m_iWindowSamples - m_lWindow.first().cols() >= m_iMaxSamples) {
+                        removeBlock(m_lWindow.first());
+                        m_iWindowSamples -= m_lWindow.first().cols();
+                        iRemovedSamples += m_lWindow.first().cols();
+                        m_lWindow.removeFirst();
+                    }
+
+                    //Recompute the statistics from the stored window now and then to bound the round-off of the downdates
+                    if(iRemovedSamples >= MAX_WINDOW_TURNOVERS * m_iMaxSamples) {
+                        m_dWeight = 0.0;
+                        for(int i = 0; i < m_lWindow.size(); ++i)
+                            addBlock(m_lWindow.at(i));
+                        iRemovedSamples = 0;
+                    }
+                }
+
+                iSamplesSinceUpdate += rawSegment.cols();
+                if(iSamplesSinceUpdate >= iUpdateInterval && m_dWeight > 1.0) {
+                    emitRunningCovariance();
+                    iSamplesSinceUpdate = 0;
+                }
+
+                continue;
+            }
+
             if(n_samples == 0)
             {
                 mu = rawSegment.rowwise().sum();
-                cov->data = rawSegment * rawSegment.transpose();
+                cov->data = MatrixXd::Zero(rawSegment.rows(), rawSegment.rows());
             }
             else
             {
                 mu.array() += rawSegment.rowwise().sum().array();
-                cov->data += rawSegment * rawSegment.transpose();
             }
+            //Accumulate the lower triangle only
+            cov->data.selfadjointView<Lower>().rankUpdate(rawSegment);
             n_samples += rawSegment.cols();
 
             if(n_samples > m_iMaxSamples)
             {
+                MatrixXd matFull = cov->data.selfadjointView<Lower>();
+                cov->data = matFull;
+
                 mu /= (float)n_samples;
                 cov->data.array() -= n_samples * (mu * mu.transpose()).array();
                 cov->data.array() /= (n_samples - 1);
@@ -191,26 +307,178 @@ void RtCov::run()
                 cov->nfree = n_samples;
 
                 // regularize noise covariance
-                *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+                regularize(cov->data);
 
                 emit covCalculated(cov);
 
                 cov = FiffCov::SPtr(new FiffCov());
                 n_samples = 0;
             }
+        }
+    }
+}
 
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+//*************************************************************************************************************
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+void RtCov::prepareRegularization()
+{
+    //Same setup as FiffCov::regularize with the stim channels excluded
+    QStringList exclude;
+    for(int i = 0; i<m_pFiffInfo->chs.size(); i++) {
+        if(m_pFiffInfo->chs.at(i).kind == FIFFV_STIM_CH) {
+            exclude << m_pFiffInfo->chs.at(i).ch_name;
+        }
+    }
+
+    QList<FiffProj> t_listProjs = m_pFiffInfo->projs + m_pFiffInfo->projs;
+    FiffProj::activate_projs(t_listProjs);
+
+    m_lRegSelections.clear();
+    m_lRegSelections.append(QPair<double, RowVectorXi>(0.1, m_pFiffInfo->pick_types(false, true, false, defaultQStringList, exclude)));
+    m_lRegSelections.append(QPair<double, RowVectorXi>(0.05, m_pFiffInfo->pick_types(QString("grad"), false, false, defaultQStringList, exclude)));
+    m_lRegSelections.append(QPair<double, RowVectorXi>(0.05, m_pFiffInfo->pick_types(QString("mag"), false, false, defaultQStringList, exclude)));
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+    m_lRegProjBases.clear();
+    for(int k = 0; k < m_lRegSelections.size(); ++k) {
+        const RowVectorXi& sel = m_lRegSelections.at(k).second;
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
+        QStringList this_ch_names;
+        for(qint32 i = 0; i < sel.size(); ++i)
+            this_ch_names << m_pFiffInfo->ch_names[sel(i)];
 
+        MatrixXd U;
+        if(sel.size() > 0) {
+            MatrixXd P;
+            qint32 ncomp = FiffProj::make_projector(t_listProjs, this_ch_names, P);
+
+            if(ncomp > 0) {
+                JacobiSVD<MatrixXd> svd(P, ComputeFullU);
+                //Sort singular values and singular vectors
+                VectorXd t_s = svd.singularValues();
+                MatrixXd t_U = svd.matrixU();
+                MNEMath::sort<double>(t_s, t_U);
+
+                U = t_U.block(0,0, t_U.rows(), t_U.cols()-ncomp);
+            }
         }
+        m_lRegProjBases.append(U);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::regularize(MatrixXd &matCov) const
+{
+    for(int k = 0; k < m_lRegSelections.size(); ++k) {
+        double reg = m_lRegSelections.at(k).first;
+        const RowVectorXi& idx = m_lRegSelections.at(k).second;
+        const MatrixXd& U = m_lRegProjBases.at(k);
+
+        if(idx.size() == 0 || reg == 0.0)
+            continue;
+
+        MatrixXd this_C(idx.size(), idx.size());
+        for(qint32 i = 0; i < idx.size(); ++i)
+            for(qint32 j = 0; j < idx.size(); ++j)
+                this_C(i,j) = matCov(idx[i], idx[j]);
+
+        if(U.size() > 0)
+            this_C = U.transpose() * (this_C * U);
+
+        double sigma = this_C.diagonal().mean();
+        this_C.diagonal() = this_C.diagonal().array() + reg * sigma;
+
+        if(U.size() > 0)
+            this_C = U * (this_C * U.transpose());
+
+        for(qint32 i = 0; i < idx.size(); ++i)
+            for(qint32 j = 0; j < idx.size(); ++j)
+                matCov(idx[i], idx[j]) = this_C(i,j);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::addBlock(const MatrixXd &matBlock)
+{
+    if(matBlock.cols() == 0)
+        return;
+
+    double k = matBlock.cols();
+    VectorXd vecBlockMean = matBlock.rowwise().mean();
+    MatrixXd matCentered = matBlock.colwise() - vecBlockMean;
+
+    if(m_dWeight <= 0.0 || m_vecMean.size() != matBlock.rows()) {
+        m_vecMean = vecBlockMean;
+        m_matScatter = MatrixXd::Zero(matBlock.rows(), matBlock.rows());
+        m_matScatter.selfadjointView<Lower>().rankUpdate(matCentered);
+        m_dWeight = k;
+        return;
     }
+
+    double dNewWeight = m_dWeight + k;
+    VectorXd vecDelta = vecBlockMean - m_vecMean;
+
+    m_matScatter.selfadjointView<Lower>().rankUpdate(matCentered);
+    m_matScatter.selfadjointView<Lower>().rankUpdate(vecDelta, m_dWeight * k / dNewWeight);
+
+    m_vecMean += vecDelta * (k / dNewWeight);
+    m_dWeight = dNewWeight;
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::removeBlock(const MatrixXd &matBlock)
+{
+    if(matBlock.cols() == 0 || m_dWeight <= 0.0)
+        return;
+
+    double k = matBlock.cols();
+    double dNewWeight = m_dWeight - k;
+
+    if(dNewWeight < 1.0) {
+        m_dWeight = 0.0;
+        return;
+    }
+
+    VectorXd vecBlockMean = matBlock.rowwise().mean();
+    MatrixXd matCentered = matBlock.colwise() - vecBlockMean;
+    VectorXd vecNewMean = (m_dWeight * m_vecMean - k * vecBlockMean) / dNewWeight;
+    VectorXd vecDelta = vecBlockMean - vecNewMean;
+
+    m_matScatter.selfadjointView<Lower>().rankUpdate(matCentered, -1.0);
+    m_matScatter.selfadjointView<Lower>().rankUpdate(vecDelta, -dNewWeight * k / m_dWeight);
+
+    m_vecMean = vecNewMean;
+    m_dWeight = dNewWeight;
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::emitRunningCovariance()
+{
+    FiffCov::SPtr cov(new FiffCov());
+
+    cov->data = m_matScatter.selfadjointView<Lower>();
+    cov->data /= (m_dWeight - 1.0);
+
+    cov->kind = FIFFV_MNE_NOISE_COV;
+    cov->diag = false;
+    cov->dim = cov->data.rows();
+
+    //ToDo do picks
+    cov->names = m_pFiffInfo->ch_names;
+    cov->projs = m_pFiffInfo->projs;
+    cov->bads = m_pFiffInfo->bads;
+    cov->nfree = (qint32)m_dWeight;
+
+    // regularize noise covariance
+    regularize(cov->data);
+
+    emit covCalculated(cov);
 }
@@ -69,6 +69,8 @@
 #include <QThread>
 #include <QMutex>
 #include <QSharedPointer>
+#include <QList>
+#include <QPair>
 
 
 //*************************************************************************************************************
@@ -111,6 +113,15 @@ public:
     typedef QSharedPointer<RtCov> SPtr;             /**< Shared pointer type for RtCov. */
     typedef QSharedPointer<const RtCov> ConstSPtr;  /**< Const shared pointer type for RtCov. */
 
+    /**
+    * Covariance estimation modes.
+    */
+    enum EstimationMode {
+        BlockMode,          /**< Estimate from consecutive, non-overlapping blocks of the maximal number of samples. */
+        SlidingWindowMode,  /**< Estimate continuously from the last maximal number of samples. */
+        ForgettingMode      /**< Estimate continuously with exponential forgetting, the maximal number of samples is the time constant. */
+    };
+
     //=========================================================================================================
     /**
     * Creates the real-time covariance estimation object.
@@ -151,6 +162,24 @@ public:
     */
     void setSamples(qint32 samples);
 
+    //=========================================================================================================
+    /**
+    * Set the estimation mode. In the sliding window and forgetting modes the mean and the scatter matrix are
+    * updated with every incoming block (Welford/Chan updates on the lower triangle) and covCalculated is emitted
+    * every update interval samples.
+    *
+    * @param[in] mode       the estimation mode to use
+    */
+    void setEstimationMode(EstimationMode mode);
+
+    //=========================================================================================================
+    /**
+    * Set the number of samples between two emitted covariance matrices in the sliding window and forgetting modes.
+    *
+    * @param[in] samples    number of samples between two updates
+    */
+    void setUpdateInterval(qint32 samples);
+
     //=========================================================================================================
     /**
     * Starts the RtCov by starting the producer's thread.
@@ -186,6 +215,44 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Computes the channel selections and the projection bases used by regularize. This is done once per run
+    * instead of once per covariance matrix.
+    */
+    void prepareRegularization();
+
+    //=========================================================================================================
+    /**
+    * Regularizes the covariance matrix in place, equivalent to FiffCov::regularize(info, 0.05, 0.05, 0.1, true, exclude)
+    * but using the selections prepared by prepareRegularization.
+    *
+    * @param[in, out] matCov    the covariance matrix to regularize
+    */
+    void regularize(MatrixXd &matCov) const;
+
+    //=========================================================================================================
+    /**
+    * Adds a data block to the running statistics (Chan's update of mean and lower triangle of the scatter matrix).
+    *
+    * @param[in] matBlock   the data block
+    */
+    void addBlock(const MatrixXd &matBlock);
+
+    //=========================================================================================================
+    /**
+    * Removes a data block, which was added before, from the running statistics.
+    *
+    * @param[in] matBlock   the data block
+    */
+    void removeBlock(const MatrixXd &matBlock);
+
+    //=========================================================================================================
+    /**
+    * Creates a covariance object from the running statistics and emits it.
+    */
+    void emitRunningCovariance();
+
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
     quint32      m_iMaxSamples;         /**< Maximal amount of samples received, before covariance is estimated.*/
@@ -197,6 +264,18 @@ private:
     bool        m_bIsRunning;           /**< Holds if real-time Covariance estimation is running.*/
 
     CircularMatrixBuffer<double>::SPtr m_pRawMatrixBuffer;   /**< The Circular Raw Matrix Buffer. */
+
+    EstimationMode  m_eMode;            /**< The estimation mode. */
+    quint32     m_iUpdateInterval;      /**< Number of samples between two emitted covariance matrices in the running modes. */
+
+    VectorXd    m_vecMean;              /**< Running mean. */
+    MatrixXd    m_matScatter;           /**< Running scatter matrix, only the lower triangle is updated. */
+    double      m_dWeight;              /**< Number of (weighted) samples in the running statistics. */
+    QList<MatrixXd> m_lWindow;          /**< Blocks in the sliding window. */
+    quint32     m_iWindowSamples;       /**< Number of samples in the sliding window. */
+
+    QList<QPair<double, RowVectorXi> > m_lRegSelections;    /**< Regularization and channel selection per channel type. */
+    QList<MatrixXd> m_lRegProjBases;                        /**< Basis of the space left by the projectors per channel type, empty if no projector. */
 };
 
 //*************************************************************************************************************
@@ -72,6 +72,9 @@ void doFilterPerChannelRTMSA(QPair<QList<FilterData>,QPair<int,RowVectorXd> > &c
 //=============================================================================================================
 
 RtFilter::RtFilter()
+: m_iFFTLength(0)
+, m_iNumTaps(0)
+, m_iBlockSize(0)
 {
 }
 
@@ -152,3 +155,154 @@ MatrixXd RtFilter::filterChannelsConcurrently(const MatrixXd& matDataIn, int iMa
 
     return matDataOut;
 }
+
+
+//*************************************************************************************************************
+
+MatrixXd RtFilter::filterChannelsOverlapSave(const MatrixXd& matDataIn, const QVector<int>& lFilterChannelList, const QList<FilterData>& lFilterData)
+{
+    const int iNumRows = matDataIn.rows();
+    const int iBlockSize = matDataIn.cols();
+
+    prepareOverlapSave(iBlockSize, lFilterData);
+
+    const int iHistory = m_iNumTaps > 0 ? m_iNumTaps - 1 : 0;
+    const int iDelay = iHistory/2;
+
+    //(Re)initialise the per channel state if the layout changed
+    if(m_matHistory.rows() != iNumRows || m_matHistory.cols() != iHistory) {
+        m_matHistory = MatrixXd::Zero(iNumRows, iHistory);
+    }
+
+    MatrixXd matDataOut(iNumRows, iBlockSize);
+
+    //Sort channels into filtered and not filtered ones
+    QVector<bool> vecFilter(iNumRows, false);
+    for(int i = 0; i < lFilterChannelList.size(); ++i) {
+        if(lFilterChannelList.at(i) >= 0 && lFilterChannelList.at(i) < iNumRows) {
+            vecFilter[lFilterChannelList.at(i)] = true;
+        }
+    }
+
+    QVector<int> vecFilterRows;
+    vecFilterRows.reserve(iNumRows);
+    for(int i = 0; i < iNumRows; ++i) {
+        if(vecFilter.at(i) && m_iNumTaps > 0) {
+            vecFilterRows.append(i);
+        } else {
+            //Delay not filtered channels by the group delay of the filter
+            if(iDelay == 0) {
+                matDataOut.row(i) = matDataIn.row(i);
+            } else if(iDelay >= iBlockSize) {
+                matDataOut.row(i) = m_matHistory.row(i).segment(iHistory - iDelay, iBlockSize);
+            } else {
+                matDataOut.row(i) << m_matHistory.row(i).tail(iDelay), matDataIn.row(i).head(iBlockSize - iDelay);
+            }
+        }
+    }
+
+    //Overlap-save on pairs of channels packed into one complex signal
+    for(int k = 0; k < vecFilterRows.size(); k += 2) {
+        const int iRowRe = vecFilterRows.at(k);
+        const int iRowIm = k + 1 < vecFilterRows.size() ? vecFilterRows.at(k + 1) : -1;
+
+        m_vecTimeBuffer.setZero();
+        m_vecTimeBuffer.head(iHistory).real() = m_matHistory.row(iRowRe);
+        m_vecTimeBuffer.segment(iHistory, iBlockSize).real() = matDataIn.row(iRowRe);
+        if(iRowIm != -1) {
+            m_vecTimeBuffer.head(iHistory).imag() = m_matHistory.row(iRowIm);
+            m_vecTimeBuffer.segment(iHistory, iBlockSize).imag() = matDataIn.row(iRowIm);
+        }
+
+        m_fft.fwd(m_vecFreqBuffer, m_vecTimeBuffer);
+        m_vecFreqBuffer.array() *= m_vecFilterSpectrum.array();
+        m_fft.inv(m_vecTimeBuffer, m_vecFreqBuffer);
+
+        //The first iHistory samples are wrapped around and are discarded
+        matDataOut.row(iRowRe) = m_vecTimeBuffer.segment(iHistory, iBlockSize).real();
+        if(iRowIm != -1) {
+            matDataOut.row(iRowIm) = m_vecTimeBuffer.segment(iHistory, iBlockSize).imag();
+        }
+    }
+
+    //Store the last input samples as state for the next block
+    if(iHistory > 0) {
+        if(iBlockSize >= iHistory) {
+            m_matHistory = matDataIn.rightCols(iHistory);
+        } else {
+            MatrixXd matTemp(iNumRows, iHistory);
+            matTemp << m_matHistory.rightCols(iHistory - iBlockSize), matDataIn;
+            m_matHistory = matTemp;
+        }
+    }
+
+    return matDataOut;
+}
+
+
+//*************************************************************************************************************
+
+void RtFilter::reset()
+{
+    m_matHistory.setZero();
+    m_matOverlap.setZero();
+    m_matDelay.setZero();
+}
+
+
+//*************************************************************************************************************
+
+void RtFilter::prepareOverlapSave(int iBlockSize, const QList<FilterData>& lFilterData)
+{
+    //Check whether the stored spectrum is still valid
+    bool bChanged = iBlockSize != m_iBlockSize || lFilterData.size() != m_lFilterCoeffs.size();
+    for(int i = 0; !bChanged && i < lFilterData.size(); ++i) {
+        const RowVectorXd& vecCoeff = lFilterData.at(i).m_dCoeffA;
+        bChanged = vecCoeff.cols() != m_lFilterCoeffs.at(i).cols() || vecCoeff != m_lFilterCoeffs.at(i);
+    }
+
+    if(!bChanged) {
+        return;
+    }
+
+    //Combine the filter cascade into one impulse response
+    m_lFilterCoeffs.clear();
+    RowVectorXd vecTaps;
+
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        const RowVectorXd& vecCoeff = lFilterData.at(i).m_dCoeffA;
+        m_lFilterCoeffs.append(vecCoeff);
+
+        if(vecCoeff.cols() == 0) {
+            continue;
+        }
+
+        if(vecTaps.cols() == 0) {
+            vecTaps = vecCoeff;
+            continue;
+        }
+
+        RowVectorXd vecConv = RowVectorXd::Zero(vecTaps.cols() + vecCoeff.cols() - 1);
+        for(int j = 0; j < vecCoeff.cols(); ++j) {
+            vecConv.segment(j, vecTaps.cols()) += vecCoeff(j) * vecTaps;
+        }
+        vecTaps = vecConv;
+    }
+
+    m_iBlockSize = iBlockSize;
+    m_iNumTaps = vecTaps.cols();
+
+    //Smallest power of two which avoids circular wrap-around into the valid output samples
+    m_iFFTLength = 1;
+    while(m_iFFTLength < iBlockSize + m_iNumTaps - 1) {
+        m_iFFTLength <<= 1;
+    }
+
+    RowVectorXcd vecTapsPadded = RowVectorXcd::Zero(m_iFFTLength);
+    vecTapsPadded.head(m_iNumTaps).real() = vecTaps;
+
+    m_fft.fwd(m_vecFilterSpectrum, vecTapsPadded);
+
+    m_vecTimeBuffer.resize(m_iFFTLength);
+    m_vecFreqBuffer.resize(m_iFFTLength);
+}
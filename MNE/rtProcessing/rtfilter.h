@@ -115,10 +115,53 @@ public:
     */
     Eigen::MatrixXd filterChannelsConcurrently(const Eigen::MatrixXd& matDataIn, int iMaxFilterLength, const QVector<int>& lFilterChannelList, const QList<UTILSLIB::FilterData> &lFilterData);
 
+    //=========================================================================================================
+    /**
+    * Filters the raw input data block with a streaming, causal overlap-save convolution. The combined spectrum of
+    * the filter cascade and the FFT plans are kept between calls and are only recomputed if the filter
+    * coefficients or the block size change. The last filter length - 1 input samples of every channel are kept
+    * as state, so consecutive blocks form one continuous filtered stream. Two channels are transformed at once
+    * by packing them into the real and imaginary part of a single complex FFT.
+    * Channels which are not filtered are delayed by (filter length - 1)/2 samples to stay aligned with the
+    * filtered channels.
+    *
+    * @param [in] matDataIn             data which is to be filtered (channels x samples).
+    * @param [in] lFilterChannelList    indices of the channels which are to be filtered.
+    * @param [in] lFilterData           the filters which are applied in sequence.
+    *
+    * @return the filtered data block.
+    */
+    Eigen::MatrixXd filterChannelsOverlapSave(const Eigen::MatrixXd& matDataIn, const QVector<int>& lFilterChannelList, const QList<UTILSLIB::FilterData> &lFilterData);
+
+    //=========================================================================================================
+    /**
+    * Clears the stored filter state. The next block is filtered as if it were the beginning of the stream.
+    */
+    void reset();
+
 protected:
+    //=========================================================================================================
+    /**
+    * Recomputes the combined filter spectrum if the filter coefficients or the block size changed.
+    *
+    * @param [in] iBlockSize    number of samples per block.
+    * @param [in] lFilterData   the filters which are applied in sequence.
+    */
+    void prepareOverlapSave(int iBlockSize, const QList<UTILSLIB::FilterData> &lFilterData);
+
     Eigen::MatrixXd                 m_matOverlap;                   /**< Last overlap block */
     Eigen::MatrixXd                 m_matDelay;                     /**< Last delay block */
 
+    Eigen::FFT<double>              m_fft;                          /**< FFT object, keeps its plans between the blocks. */
+    Eigen::RowVectorXcd             m_vecFilterSpectrum;            /**< Full spectrum of the combined filter cascade at m_iFFTLength. */
+    Eigen::RowVectorXcd             m_vecTimeBuffer;                /**< Complex time domain work buffer holding two packed channels. */
+    Eigen::RowVectorXcd             m_vecFreqBuffer;                /**< Complex frequency domain work buffer. */
+    Eigen::MatrixXd                 m_matHistory;                   /**< Last m_iNumTaps-1 input samples of every channel. */
+    QList<Eigen::RowVectorXd>       m_lFilterCoeffs;                /**< Filter coefficients m_vecFilterSpectrum was computed from. */
+    int                             m_iFFTLength;                   /**< FFT length used by the overlap-save method. */
+    int                             m_iNumTaps;                     /**< Number of taps of the combined filter cascade. */
+    int                             m_iBlockSize;                   /**< Block size m_vecFilterSpectrum was computed for. */
+
 private:
 
 };
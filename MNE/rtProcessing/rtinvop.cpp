@@ -48,6 +48,15 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QCryptographicHash>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Eigenvalues>
 
 
 //*************************************************************************************************************
@@ -68,6 +77,9 @@ RtInvOp::RtInvOp(FiffInfo::SPtr &p_pFiffInfo, MNEForwardSolution::SPtr &p_pFwd,
 , m_bIsRunning(false)
 , m_pFiffInfo(p_pFiffInfo)
 , m_pFwd(p_pFwd)
+, m_fLoose(0.2f)
+, m_fDepth(0.8f)
+, m_iMethods(FIFFV_MNE_MEG)
 {
     qRegisterMetaType<MNEInverseOperator::SPtr>("MNEInverseOperator::SPtr");
 }
@@ -106,24 +118,235 @@ bool RtInvOp::stop()
 }
 
 
+//*************************************************************************************************************
+
+void RtInvOp::prepareForward(const FiffInfo &p_gainInfo, const MatrixXd &p_matGain)
+{
+    printf("\tPreparing the forward part of the inverse operator for %d channels.\n", p_gainInfo.ch_names.size());
+
+    bool is_fixed_ori = m_forwardMeg.isFixedOrient();
+
+    //
+    // Depth prior, the source covariance starts from it
+    //
+    MatrixXd patch_areas;
+    m_sourceCov = MNEForwardSolution::compute_depth_prior(p_matGain, p_gainInfo, is_fixed_ori, m_fDepth, 10.0, patch_areas, true);
+
+    //
+    // Loose orientations
+    //
+    m_pOrientPrior = FiffCov::SDPtr();
+    if(!is_fixed_ori)
+    {
+        m_pOrientPrior = FiffCov::SDPtr(new FiffCov(m_forwardMeg.compute_orient_prior(m_fLoose)));
+        m_sourceCov.data.array() *= m_pOrientPrior->data.array();
+    }
+
+    //
+    // Source weighting of the unwhitened gain and its Gram matrix, whitening is linear and applied later
+    //
+    RowVectorXd source_std = m_sourceCov.data.array().sqrt().transpose();
+
+    m_matGainWeighted = p_matGain;
+    for(qint32 i = 0; i < m_matGainWeighted.rows(); ++i)
+        m_matGainWeighted.row(i).array() *= source_std.array();
+
+    m_matGainGram = MatrixXd::Zero(m_matGainWeighted.rows(), m_matGainWeighted.rows());
+    m_matGainGram.selfadjointView<Lower>().rankUpdate(m_matGainWeighted);
+    m_matGainGram = m_matGainGram.selfadjointView<Lower>();
+
+    //
+    // Methods
+    //
+    bool has_meg = false;
+    bool has_eeg = false;
+    for(qint32 i = 0; i < p_gainInfo.chs.size(); ++i)
+    {
+        QString ch_type = p_gainInfo.channel_type(i);
+        if (ch_type == "eeg")
+            has_eeg = true;
+        if ((ch_type == "mag") || (ch_type == "grad"))
+            has_meg = true;
+    }
+
+    if(has_eeg && has_meg)
+        m_iMethods = FIFFV_MNE_MEG_EEG;
+    else if(has_meg)
+        m_iMethods = FIFFV_MNE_MEG;
+    else
+        m_iMethods = FIFFV_MNE_EEG;
+
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator::SPtr RtInvOp::computeInverseOperator(const FiffCov &p_noiseCov)
+{
+    QByteArray t_qForwardKey = forwardCacheKey(*m_pFiffInfo.data(), p_noiseCov);
+    QByteArray t_qCovKey = covarianceKey(p_noiseCov);
+
+    if(m_pInvOpLast && t_qForwardKey == m_qForwardKey && t_qCovKey == m_qCovKey)
+    {
+        printf("\tNoise covariance, channels and projectors unchanged, reusing the inverse operator.\n");
+        return m_pInvOpLast;
+    }
+
+    //
+    // Whitener for the current noise covariance
+    //
+    FiffInfo gain_info;
+    MatrixXd gain;
+    MatrixXd whitener;
+    qint32 n_nzero;
+    FiffCov t_outNoiseCov;
+    m_forwardMeg.prepare_forward(*m_pFiffInfo.data(), p_noiseCov, false, gain_info, gain, t_outNoiseCov, whitener, n_nzero);
+
+    if(t_qForwardKey != m_qForwardKey)
+    {
+        prepareForward(gain_info, gain);
+        m_qForwardKey = t_qForwardKey;
+    }
+
+    //
+    // Whitened Gram matrix W*G*R*G'*W' and trace normalization
+    //
+    MatrixXd t_matGram = whitener * m_matGainGram * whitener.transpose();
+
+    double trace_GRGT = t_matGram.trace();
+    double scaling_source_cov = (double)n_nzero / trace_GRGT;
+
+    t_matGram *= scaling_source_cov;
+
+    //
+    // Decompose: G = U*S*V' with G*G' = U*S^2*U' and V = G'*U*S^-1
+    //
+    SelfAdjointEigenSolver<MatrixXd> t_eigSolver(t_matGram);
+
+    qint32 n_chan = t_matGram.rows();
+    VectorXd p_sing(n_chan);
+    MatrixXd t_U(n_chan, n_chan);
+    double t_dEigMax = qMax(t_eigSolver.eigenvalues()[n_chan - 1], 0.0);
+    double t_dEigTol = t_dEigMax * n_chan * NumTraits<double>::epsilon();
+    for(qint32 i = 0; i < n_chan; ++i)
+    {
+        // Eigen returns ascending eigenvalues, the inverse expects descending singular values
+        double t_dEig = t_eigSolver.eigenvalues()[n_chan - 1 - i];
+        p_sing[i] = t_dEig > t_dEigTol ? sqrt(t_dEig) : 0.0;
+        t_U.col(i) = t_eigSolver.eigenvectors().col(n_chan - 1 - i);
+    }
+
+    VectorXd t_vecSingInv = VectorXd::Zero(n_chan);
+    for(qint32 i = 0; i < n_chan; ++i)
+        if(p_sing[i] > 0)
+            t_vecSingInv[i] = sqrt(scaling_source_cov) / p_sing[i];
+
+    MatrixXd t_V = m_matGainWeighted.transpose() * ((whitener.transpose() * t_U) * t_vecSingInv.asDiagonal());
+
+    printf("\tlargest singular value = %f\n", p_sing.maxCoeff());
+    printf("\tscaling factor to adjust the trace = %f\n", trace_GRGT);
+
+    //
+    // Assemble the operator as MNEInverseOperator::make_inverse_operator does
+    //
+    FiffCov::SDPtr p_source_cov(new FiffCov(m_sourceCov));
+    p_source_cov->data.array() *= scaling_source_cov;
+
+    MNEInverseOperator::SPtr p_pInvOp(new MNEInverseOperator());
+    p_pInvOp->eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(t_U.cols(), t_U.rows(), defaultQStringList, gain_info.ch_names, t_U.transpose()));
+    p_pInvOp->eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(t_V.rows(), t_V.cols(), defaultQStringList, defaultQStringList, t_V));
+    p_pInvOp->sing = p_sing;
+    p_pInvOp->nave = 1;
+    p_pInvOp->depth_prior = p_source_cov;
+    p_pInvOp->source_cov = p_source_cov;
+    p_pInvOp->noise_cov = FiffCov::SDPtr(new FiffCov(t_outNoiseCov));
+    p_pInvOp->orient_prior = m_pOrientPrior;
+    p_pInvOp->projs = m_pFiffInfo->projs;
+    p_pInvOp->eigen_leads_weighted = false;
+    p_pInvOp->source_ori = m_forwardMeg.source_ori;
+    p_pInvOp->mri_head_t = m_forwardMeg.mri_head_t;
+    p_pInvOp->methods = m_iMethods;
+    p_pInvOp->nsource = m_forwardMeg.nsource;
+    p_pInvOp->coord_frame = m_forwardMeg.coord_frame;
+    p_pInvOp->source_nn = m_forwardMeg.source_nn;
+    p_pInvOp->src = m_forwardMeg.src;
+    p_pInvOp->info = m_forwardMeg.info;
+    p_pInvOp->info.bads = m_pFiffInfo->bads;
+
+    m_qCovKey = t_qCovKey;
+    m_pInvOpLast = p_pInvOp;
+
+    return p_pInvOp;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray RtInvOp::forwardCacheKey(const FiffInfo &p_info, const FiffCov &p_noiseCov)
+{
+    QCryptographicHash t_hash(QCryptographicHash::Sha1);
+
+    t_hash.addData(p_info.ch_names.join("\n").toUtf8());
+    t_hash.addData("\t" + p_info.bads.join("\n").toUtf8());
+    t_hash.addData("\t" + p_noiseCov.names.join("\n").toUtf8());
+    t_hash.addData("\t" + p_noiseCov.bads.join("\n").toUtf8());
+
+    for(qint32 i = 0; i < p_info.projs.size(); ++i)
+    {
+        const FiffProj &t_proj = p_info.projs[i];
+        if(!t_proj.active)
+            continue;
+
+        t_hash.addData("\t" + t_proj.desc.toUtf8());
+        if(t_proj.data)
+        {
+            t_hash.addData(t_proj.data->col_names.join("\n").toUtf8());
+            t_hash.addData((const char*)t_proj.data->data.data(), t_proj.data->data.size()*sizeof(double));
+        }
+    }
+
+    return t_hash.result();
+}
+
+
+//*************************************************************************************************************
+
+QByteArray RtInvOp::covarianceKey(const FiffCov &p_noiseCov)
+{
+    QCryptographicHash t_hash(QCryptographicHash::Sha1);
+
+    QByteArray t_qHeader = QString("%1 %2 %3 %4\t").arg(p_noiseCov.kind).arg((int)p_noiseCov.diag).arg(p_noiseCov.dim).arg(p_noiseCov.nfree).toUtf8();
+    t_hash.addData(t_qHeader);
+    t_hash.addData(p_noiseCov.names.join("\n").toUtf8());
+    t_hash.addData((const char*)p_noiseCov.data.data(), p_noiseCov.data.size()*sizeof(double));
+
+    return t_hash.result();
+}
+
+
 //*************************************************************************************************************
 
 void RtInvOp::run()
 {
     m_bIsRunning = true;
 
+    // Restrict forward solution as necessary for MEG
+    m_forwardMeg = m_pFwd->pick_types(true, false);
+    m_qForwardKey.clear();
+    m_qCovKey.clear();
+    m_pInvOpLast.clear();
+
     while(m_bIsRunning)
     {
         if(m_vecNoiseCov.size() > 0)
         {
-            // Restrict forward solution as necessary for MEG
-            MNEForwardSolution t_forwardMeg = m_pFwd->pick_types(true, false);
-
             mutex.lock();
-            MNEInverseOperator::SPtr t_invOpMeg(new MNEInverseOperator(*m_pFiffInfo.data(), t_forwardMeg, m_vecNoiseCov[0], 0.2f, 0.8f));
+            FiffCov t_noiseCov = m_vecNoiseCov[0];
             m_vecNoiseCov.pop_front();
             mutex.unlock();
 
+            MNEInverseOperator::SPtr t_invOpMeg = computeInverseOperator(t_noiseCov);
+
             emit invOperatorCalculated(t_invOpMeg);
         }
     }
@@ -67,6 +67,7 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QByteArray>
 #include <QSharedPointer>
 
 
@@ -169,6 +170,55 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Computes the noise covariance independent part of the inverse operator for the given channel set, i.e.
+    * the depth and orientation priors, the source covariance and the source weighted, unwhitened gain matrix
+    * together with its Gram matrix. The result is cached until the forward cache key changes.
+    *
+    * @param[in] p_gainInfo     Measurement info restricted to the channels which enter the inverse.
+    * @param[in] p_matGain      Unwhitened gain matrix of these channels.
+    */
+    void prepareForward(const FiffInfo &p_gainInfo, const MatrixXd &p_matGain);
+
+    //=========================================================================================================
+    /**
+    * Calculates the inverse operator for a new noise covariance. Only the whitening and the decomposition are
+    * redone; the forward dependent part is taken from the cache. The whitened gain G is never decomposed
+    * directly: the eigendecomposition of the small channel by channel Gram matrix G*G' yields the eigen fields
+    * and singular values, the eigen leads follow from G'*U*diag(1/sing). The result equals the one of
+    * MNEInverseOperator::make_inverse_operator with loose = 0.2 and depth = 0.8.
+    *
+    * @param[in] p_noiseCov     The noise covariance.
+    *
+    * @return the inverse operator.
+    */
+    MNEInverseOperator::SPtr computeInverseOperator(const FiffCov &p_noiseCov);
+
+    //=========================================================================================================
+    /**
+    * Builds the key of the cached forward part. It covers everything which selects the channels or changes
+    * the data the inverse is applied to: the channels and bads of the measurement, the channels and bads of
+    * the noise covariance and the active projectors.
+    *
+    * @param[in] p_info         The measurement information.
+    * @param[in] p_noiseCov     The noise covariance.
+    *
+    * @return the key.
+    */
+    static QByteArray forwardCacheKey(const FiffInfo &p_info, const FiffCov &p_noiseCov);
+
+    //=========================================================================================================
+    /**
+    * Builds the identity of a noise covariance from its kind, dimension, channel names, degrees of freedom
+    * and data. Together with the forward cache key it identifies a complete inverse operator.
+    *
+    * @param[in] p_noiseCov     The noise covariance.
+    *
+    * @return the key.
+    */
+    static QByteArray covarianceKey(const FiffCov &p_noiseCov);
+
     QMutex      mutex;                  /**< Provides access serialization between threads. */
     bool        m_bIsRunning;           /**< Whether RtInv is running. */
 
@@ -176,6 +226,19 @@ private:
 
     FiffInfo::SPtr m_pFiffInfo;         /**< The fiff measurement information. */
     MNEForwardSolution::SPtr m_pFwd;    /**< The forward solution. */
+
+    float       m_fLoose;               /**< Loose orientation constraint. */
+    float       m_fDepth;               /**< Depth weighting exponent. */
+
+    MNEForwardSolution m_forwardMeg;    /**< MEG restricted forward solution, picked once per run. */
+    QByteArray  m_qForwardKey;          /**< Key of the cached forward part, empty if invalid. */
+    QByteArray  m_qCovKey;              /**< Identity of the noise covariance of the last inverse operator. */
+    MNEInverseOperator::SPtr m_pInvOpLast;  /**< Last calculated inverse operator, reused for an identical covariance. */
+    FiffCov     m_sourceCov;            /**< Unscaled source covariance, product of depth and orientation prior. */
+    FiffCov::SDPtr m_pOrientPrior;      /**< Orientation prior. */
+    MatrixXd    m_matGainWeighted;      /**< Unwhitened gain matrix with columns scaled by the source standard deviation. */
+    MatrixXd    m_matGainGram;          /**< Gram matrix m_matGainWeighted * m_matGainWeighted'. */
+    qint32      m_iMethods;             /**< Source estimation methods (MEG, EEG, MEG/EEG). */
 };
 
 //*************************************************************************************************************
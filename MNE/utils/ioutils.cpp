@@ -47,6 +47,7 @@
 //=============================================================================================================
 
 #include <QDataStream>
+#include <QtEndian>
 
 
 //*************************************************************************************************************
@@ -66,6 +67,38 @@ using namespace Eigen;
 using namespace UTILSLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Reads count values of the unsigned integer type UInt's size in one block and converts them from big endian in
+* place. The conversion is a plain loop without aliasing so that the compiler can vectorise the byte swaps.
+*/
+template<typename UInt>
+static bool readBigEndianBlock(QDataStream &p_qStream, void *data, qint64 count)
+{
+    uchar *bytes = static_cast<uchar*>(data);
+    qint64 iNumBytes = count * (qint64)sizeof(UInt);
+
+    if(count <= 0)
+        return count == 0;
+
+    if(p_qStream.readRawData((char*)bytes, (int)iNumBytes) != iNumBytes)
+        return false;
+
+    for(qint64 i = 0; i < iNumBytes; i += sizeof(UInt))
+    {
+        UInt value = qFromBigEndian<UInt>(bytes + i);
+        memcpy(bytes + i, &value, sizeof(UInt));
+    }
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -85,10 +118,15 @@ qint32 IOUtils::fread3(QDataStream &p_qStream)
 
 VectorXi IOUtils::fread3_many(QDataStream &p_qStream, qint32 count)
 {
-    VectorXi res(count);
+    VectorXi res = VectorXi::Zero(count);
 
+    //Read all values at once
+    QByteArray bytes(3 * count, 0);
+    p_qStream.readRawData(bytes.data(), bytes.size());
+
+    const unsigned char *pBytes = (const unsigned char *)bytes.constData();
     for(qint32 i = 0; i < count; ++i)
-        res[i] = IOUtils::fread3(p_qStream);
+        res[i] = (pBytes[3*i] << 16) + (pBytes[3*i+1] << 8) + pBytes[3*i+2];
 
     return res;
 }
@@ -238,3 +276,27 @@ void IOUtils::swap_doublep(double *source)
 }
 
 
+//*************************************************************************************************************
+
+bool IOUtils::read_big_endian_many(QDataStream &p_qStream, qint16 *data, qint64 count)
+{
+    return readBigEndianBlock<quint16>(p_qStream, data, count);
+}
+
+
+//*************************************************************************************************************
+
+bool IOUtils::read_big_endian_many(QDataStream &p_qStream, qint32 *data, qint64 count)
+{
+    return readBigEndianBlock<quint32>(p_qStream, data, count);
+}
+
+
+//*************************************************************************************************************
+
+bool IOUtils::read_big_endian_many(QDataStream &p_qStream, float *data, qint64 count)
+{
+    return readBigEndianBlock<quint32>(p_qStream, data, count);
+}
+
+
@@ -199,6 +199,42 @@ public:
     */
     static void swap_doublep(double *source);
 
+    //=========================================================================================================
+    /**
+    * Reads a block of big endian 16 bit integers with a single read and converts them to the host byte order.
+    *
+    * @param[in] p_qStream  Stream to read from
+    * @param[out] data      Preallocated storage for count values
+    * @param[in] count      Number of values to read
+    *
+    * @return true if all values could be read, false otherwise
+    */
+    static bool read_big_endian_many(QDataStream &p_qStream, qint16 *data, qint64 count);
+
+    //=========================================================================================================
+    /**
+    * Reads a block of big endian 32 bit integers with a single read and converts them to the host byte order.
+    *
+    * @param[in] p_qStream  Stream to read from
+    * @param[out] data      Preallocated storage for count values
+    * @param[in] count      Number of values to read
+    *
+    * @return true if all values could be read, false otherwise
+    */
+    static bool read_big_endian_many(QDataStream &p_qStream, qint32 *data, qint64 count);
+
+    //=========================================================================================================
+    /**
+    * Reads a block of big endian floats with a single read and converts them to the host byte order.
+    *
+    * @param[in] p_qStream  Stream to read from
+    * @param[out] data      Preallocated storage for count values
+    * @param[in] count      Number of values to read
+    *
+    * @return true if all values could be read, false otherwise
+    */
+    static bool read_big_endian_many(QDataStream &p_qStream, float *data, qint64 count);
+
     //=========================================================================================================
     /**
     * Write Eigen Matrix to file
@@ -59,6 +59,9 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QVector>
+#include <QThread>
+#include <QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -69,18 +72,28 @@
 using namespace UTILSLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define KMEANS_BOUND_TOL            1e-10       /**< Relative slack of the pruning bounds, covers rounding errors of the bound updates */
+#define KMEANS_PARALLEL_MIN_WORK    1000000     /**< Minimal number of coordinate differences per iteration before the assignment is split across threads */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
 
-KMeans::KMeans(QString distance, QString start, qint32 replicates, QString emptyact, bool online, qint32 maxit)
+KMeans::KMeans(QString distance, QString start, qint32 replicates, QString emptyact, bool online, qint32 maxit, bool parallel)
 : m_sDistance(distance)
 , m_sStart(start)
 , m_iReps(replicates)
 , m_sEmptyact(emptyact)
 , m_iMaxit(maxit)
 , m_bOnline(online)
+, m_bParallel(parallel)
 , emptyErrCnt(0)
 , iter(0)
 , k(0)
@@ -155,44 +168,44 @@ bool KMeans::calculate( MatrixXd X, qint32 kClusters, VectorXi& idx, MatrixXd& C
     //
     // Done with input argument processing, begin clustering
     //
-    if (m_bOnline)
-    {
-        Del = MatrixXd(n,k);
-        Del.fill(std::numeric_limits<double>::quiet_NaN());// reassignment criterion
-    }
-
     double totsumDBest = std::numeric_limits<double>::max();
     emptyErrCnt = 0;
 
-    VectorXi idxBest;
-    MatrixXd Cbest;
-    VectorXd sumDBest;
-    MatrixXd Dbest;
+    // The bounded batch update works on contiguous points
+    MatrixXd Xt;
+    if(useBoundedUpdate())
+        Xt = X.transpose();
+
+    // Draw all starting centroids up front, the random sequence is then the same for sequential and parallel replicates
+    QVector<Replicate> qVecReps(m_iReps);
 
     for(qint32 rep = 0; rep < m_iReps; ++rep)
     {
+        MatrixXd& C0 = qVecReps[rep].C;
+        C0 = C;
+
         if (m_sStart.compare("uniform") == 0)
         {
-            C = MatrixXd::Zero(k,p);
+            C0 = MatrixXd::Zero(k,p);
             for(qint32 i = 0; i < k; ++i)
                 for(qint32 j = 0; j < p; ++j)
-                    C(i,j) = unifrnd(Xmins[j], Xmaxs[j]);
+                    C0(i,j) = unifrnd(Xmins[j], Xmaxs[j]);
             // For 'cosine' and 'correlation', these are uniform inside a subset
             // of the unit hypersphere.  Still need to center them for
             // 'correlation'.  (Re)normalization for 'cosine'/'correlation' is
             // done at each iteration.
             if (m_sDistance.compare("correlation") == 0)
-                C.array() -= (C.array().rowwise().sum()/p).replicate(1, p).array();
+                C0.array() -= (C0.array().rowwise().sum()/p).replicate(1, p).array();
         }
         else if (m_sStart.compare("sample") == 0)
         {
-            C = MatrixXd::Zero(k,p);
+            C0 = MatrixXd::Zero(k,p);
             for(qint32 i = 0; i < k; ++i)
-                C.block(i,0,1,p) = X.block(rand() % n, 0, 1, p);
-            // DEBUG
-//            C.block(0,0,1,p) = X.block(2, 0, 1, p);
-//            C.block(1,0,1,p) = X.block(7, 0, 1, p);
-//            C.block(2,0,1,p) = X.block(17, 0, 1, p);
+                C0.block(i,0,1,p) = X.block(rand() % n, 0, 1, p);
+        }
+        else if (m_sStart.compare("plus") == 0)
+        {
+            plusplusStart(X, C0);
         }
     //    else if (start.compare("cluster") == 0)
     //    {
@@ -203,130 +216,231 @@ bool KMeans::calculate( MatrixXd X, qint32 kClusters, VectorXi& idx, MatrixXd& C
     //    {
     //        C = CC(:,:,rep);
     //    }
+    }
 
-        // Compute the distance from every point to each cluster centroid and the
-        // initial assignment of points to clusters
-        D = distfun(X, C);//, 0);
-        idx = VectorXi::Zero(D.rows());
-        d = VectorXd::Zero(D.rows());
-
-        for(qint32 i = 0; i < D.rows(); ++i)
-            d[i] = D.row(i).minCoeff(&idx[i]);
-
-        m = VectorXi::Zero(k);
-        for(qint32 i = 0; i < k; ++i)
-            for (qint32 j = 0; j < idx.rows(); ++j)
-                if(idx[j] == i)
-                    ++ m[i];
-
-        try // catch empty cluster errors and move on to next rep
+    if(m_bParallel && m_iReps > 1)
+    {
+        QList<ReplicateChunk> chunks;
+        for(qint32 rep = 0; rep < m_iReps; ++rep)
         {
-            // Begin phase one:  batch reassignments
-            bool converged = batchUpdate(X, C, idx);
+            ReplicateChunk chunk;
+            chunk.pKMeans = this;
+            chunk.pX = &X;
+            chunk.pXt = &Xt;
+            chunk.pReplicate = &qVecReps[rep];
+            chunk.iRep = rep;
+            chunks.append(chunk);
+        }
 
-            // Begin phase two:  single reassignments
-            if (m_bOnline)
-                converged = onlineUpdate(X, C, idx);
+        QtConcurrent::blockingMapped(chunks, &KMeans::computeReplicateChunk);
+    }
+    else
+    {
+        for(qint32 rep = 0; rep < m_iReps; ++rep)
+            qVecReps[rep].bSuccess = runReplicate(X, Xt, rep, qVecReps[rep]);
+    }
 
-            if (!converged)
-                printf("Failed To Converge during replicate %d\n", rep);
+    VectorXi idxBest;
+    MatrixXd Cbest;
+    VectorXd sumDBest;
+    MatrixXd Dbest;
 
-            // Calculate cluster-wise sums of distances
-            VectorXi nonempties = VectorXi::Zero(m.rows());
-            quint32 count = 0;
-            for(qint32 i = 0; i < m.rows(); ++i)
-            {
-                if(m[i] > 0)
-                {
-                    nonempties[i] = 1;
-                    ++count;
-                }
-            }
-            MatrixXd C_tmp(count,C.cols());
-            count = 0;
-            for(qint32 i = 0; i < nonempties.rows(); ++i)
-            {
-                if(nonempties[i])
-                {
-                    C_tmp.row(count) = C.row(i);
-                    ++count;
-                }
-            }
+    for(qint32 rep = 0; rep < m_iReps; ++rep)
+    {
+        const Replicate& t_rep = qVecReps[rep];
 
-            MatrixXd D_tmp = distfun(X, C_tmp);//, iter);
-            count = 0;
-            for(qint32 i = 0; i < nonempties.rows(); ++i)
+        if(!t_rep.bSuccess)
+        {
+            // If an empty cluster error occurred in one of multiple replicates, catch
+            // it, warn, and move on to next replicate.  Error only when all replicates
+            // fail.
+            if (m_iReps == 1)
+                return false;
+            else
             {
-                if(nonempties[i])
+                emptyErrCnt = emptyErrCnt + 1;
+//                printf("Replicate %d terminated: empty cluster created at iteration %d.\n", rep, iter);
+                if (emptyErrCnt == m_iReps)
                 {
-                    D.col(i) = D_tmp.col(count);
-                    C.row(i) = C_tmp.row(count);
-                    ++count;
+//                    error(message('EmptyClusterAllReps'));
+                    return false;
                 }
             }
+            continue;
+        }
+
+        // Save the best solution so far
+        if (t_rep.totsumD < totsumDBest)
+        {
+            totsumDBest = t_rep.totsumD;
+            idxBest = t_rep.idx;
+            Cbest = t_rep.C;
+            sumDBest = t_rep.sumD;
+            Dbest = t_rep.D;
+        }
+    } // replicates
 
-            d = VectorXd::Zero(n);
-            for(qint32 i = 0; i < n; ++i)
-                d[i] += D.array()(idx[i]*n+i);//Colum Major
+    // Return the best solution
+    idx = idxBest;
+    C = Cbest;
+    sumD = sumDBest;
+    D = Dbest;
 
-            sumD = VectorXd::Zero(k);
-            for(qint32 i = 0; i < k; ++i)
-                for (qint32 j = 0; j < idx.rows(); ++j)
-                    if(idx[j] == i)
-                        sumD[i] += d[j];
+//if hadNaNs
+//    idx = statinsertnan(wasnan, idx);
+//end
+    return true;
+}
+
+
+//*************************************************************************************************************
 
-            totsumD = sumD.array().sum();
+bool KMeans::computeReplicateChunk(const ReplicateChunk& chunk)
+{
+    //Each worker needs its own iteration state
+    KMeans t_kMeans(*chunk.pKMeans);
+
+    chunk.pReplicate->bSuccess = t_kMeans.runReplicate(*chunk.pX, *chunk.pXt, chunk.iRep, *chunk.pReplicate);
+
+    return chunk.pReplicate->bSuccess;
+}
+
+
+//*************************************************************************************************************
+
+bool KMeans::runReplicate(const MatrixXd& X, const MatrixXd& Xt, qint32 rep, Replicate& replicate)
+{
+    MatrixXd& C = replicate.C;
+    VectorXi& idx = replicate.idx;
+    VectorXd& sumD = replicate.sumD;
+    MatrixXd& D = replicate.D;
+
+    if (m_bOnline)
+    {
+        Del = MatrixXd(n,k);
+        Del.fill(std::numeric_limits<double>::quiet_NaN());// reassignment criterion
+    }
+
+    // Compute the distance from every point to each cluster centroid and the
+    // initial assignment of points to clusters
+    D = distfun(X, C);//, 0);
+    idx = VectorXi::Zero(D.rows());
+    d = VectorXd::Zero(D.rows());
+
+    for(qint32 i = 0; i < D.rows(); ++i)
+        d[i] = D.row(i).minCoeff(&idx[i]);
+
+    m = VectorXi::Zero(k);
+    for (qint32 j = 0; j < idx.rows(); ++j)
+        ++ m[idx[j]];
 
-//            printf("%d iterations, total sum of distances = %f\n", iter, totsumD);
+    try // catch empty cluster errors and move on to next rep
+    {
+        // Begin phase one:  batch reassignments
+        bool converged = useBoundedUpdate() ? boundedBatchUpdate(X, Xt, C, idx) : batchUpdate(X, C, idx);
+
+        // Begin phase two:  single reassignments
+        if (m_bOnline)
+            converged = onlineUpdate(X, C, idx);
+
+        if (!converged)
+            printf("Failed To Converge during replicate %d\n", rep);
 
-            // Save the best solution so far
-            if (totsumD < totsumDBest)
+        // Calculate cluster-wise sums of distances
+        VectorXi nonempties = VectorXi::Zero(m.rows());
+        quint32 count = 0;
+        for(qint32 i = 0; i < m.rows(); ++i)
+        {
+            if(m[i] > 0)
             {
-                totsumDBest = totsumD;
-                idxBest = idx;
-                Cbest = C;
-                sumDBest = sumD;
-                Dbest = D;
+                nonempties[i] = 1;
+                ++count;
             }
         }
-        catch (int e)
+        MatrixXd C_tmp(count,C.cols());
+        count = 0;
+        for(qint32 i = 0; i < nonempties.rows(); ++i)
         {
-            if(e == 0)
+            if(nonempties[i])
             {
-                // If an empty cluster error occurred in one of multiple replicates, catch
-                // it, warn, and move on to next replicate.  Error only when all replicates
-                // fail.  Rethrow an other kind of error.
-                if (m_iReps == 1)
-                    return false;
-                else
-                {
-                    emptyErrCnt = emptyErrCnt + 1;
-//                    printf("Replicate %d terminated: empty cluster created at iteration %d.\n", rep, iter);
-                    if (emptyErrCnt == m_iReps)
-                    {
-//                        error(message('EmptyClusterAllReps'));
-                        return false;
-                    }
+                C_tmp.row(count) = C.row(i);
+                ++count;
+            }
+        }
 
-                }
+        MatrixXd D_tmp = distfun(X, C_tmp);//, iter);
+        count = 0;
+        for(qint32 i = 0; i < nonempties.rows(); ++i)
+        {
+            if(nonempties[i])
+            {
+                D.col(i) = D_tmp.col(count);
+                C.row(i) = C_tmp.row(count);
+                ++count;
             }
-        } // catch
+        }
 
-    } // replicates
+        d = VectorXd::Zero(n);
+        for(qint32 i = 0; i < n; ++i)
+            d[i] += D.array()(idx[i]*n+i);//Colum Major
 
-    // Return the best solution
-    idx = idxBest;
-    C = Cbest;
-    sumD = sumDBest;
-    D = Dbest;
+        sumD = VectorXd::Zero(k);
+        for (qint32 j = 0; j < idx.rows(); ++j)
+            sumD[idx[j]] += d[j];
+
+        totsumD = sumD.array().sum();
+        replicate.totsumD = totsumD;
+
+//        printf("%d iterations, total sum of distances = %f\n", iter, totsumD);
+    }
+    catch (int e)
+    {
+        // Only empty cluster errors (0) are thrown
+        Q_UNUSED(e);
+        return false;
+    } // catch
 
-//if hadNaNs
-//    idx = statinsertnan(wasnan, idx);
-//end
     return true;
 }
 
 
+//*************************************************************************************************************
+
+void KMeans::plusplusStart(const MatrixXd& X, MatrixXd& C)
+{
+    C = MatrixXd::Zero(k,p);
+    C.row(0) = X.row(rand() % n);
+
+    // Distance of every point to its closest centroid chosen so far
+    VectorXd minD = distfun(X, C.topRows(1)).col(0);
+
+    for(qint32 i = 1; i < k; ++i)
+    {
+        double dSum = minD.sum();
+        qint32 iSample = 0;
+
+        if(dSum > 0)
+        {
+            double dPick = dSum * ((double)rand() / ((double)RAND_MAX + 1.0));
+            double dCumSum = minD[0];
+            while(dCumSum <= dPick && iSample < n - 1)
+            {
+                ++iSample;
+                dCumSum += minD[iSample];
+            }
+        }
+        else
+        {
+            // All points coincide with the chosen centroids
+            iSample = rand() % n;
+        }
+
+        C.row(i) = X.row(iSample);
+        minD = minD.cwiseMin(distfun(X, C.middleRows(i,1)).col(0));
+    }
+}
+
+
 //*************************************************************************************************************
 
 bool KMeans::batchUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
@@ -374,7 +488,7 @@ bool KMeans::batchUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
         // Deal with clusters that have just lost all their members
         VectorXi empties = VectorXi::Zero(changed.rows());
         for(qint32 i = 0; i < changed.rows(); ++i)
-            if(m(i) == 0)
+            if(m(changed[i]) == 0)
                 empties[i] = 1;
 
         if (empties.sum() > 0)
@@ -434,8 +548,11 @@ bool KMeans::batchUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
             MatrixXd C_new;
             VectorXi m_new;
             gcentroids(X, idx, changed, C_new, m_new);
-            C.block(0,0,k,C.cols()) = C_new;
-            m.block(0,0,k,1) = m_new;
+            for(qint32 i = 0; i < changed.rows(); ++i)
+            {
+                C.row(changed[i]) = C_new.row(i);
+                m[changed[i]] = m_new[i];
+            }
             --iter;
             break;
         }
@@ -514,6 +631,259 @@ bool KMeans::batchUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
 } // nested function
 
 
+//*************************************************************************************************************
+
+bool KMeans::boundedBatchUpdate(const MatrixXd& X, const MatrixXd& Xt, MatrixXd& C, VectorXi& idx)
+{
+    const bool bSqEuclidean = m_sDistance.compare("sqeuclidean") == 0;
+
+    // Every point moved, every cluster will need an update
+    qint32 i = 0;
+    VectorXi changed(k);
+    for(i = 0; i < k; ++i)
+        changed[i] = i;
+
+    previdx = VectorXi::Zero(n);
+
+    prevtotsumD = std::numeric_limits<double>::max();//max double
+
+    MatrixXd Ct(p, k);                          // Centroids, one per column
+    MatrixXd matLower = MatrixXd::Zero(k, n);   // Lower bounds of the metric distances, one column per point
+    MatrixXd matCC = MatrixXd::Zero(k, k);      // Metric centroid to centroid distances
+    VectorXd vecAssigned(n);                    // Distance of every point to the centroid of its cluster
+    VectorXi vecChanged(k);
+    RowVectorXd vecCentroid(p);
+
+    //
+    // Begin phase one:  batch reassignments
+    //
+    iter = 0;
+    bool converged = false;
+    while(true)
+    {
+        ++iter;
+
+        // Calculate the new cluster centroids and counts. The lower bounds of a
+        // centroid shrink by the distance it moved (triangle inequality).
+        MatrixXd C_new;
+        VectorXi m_new;
+        gcentroids(X, idx, changed, C_new, m_new);
+
+        vecChanged.setZero();
+        for(i = 0; i < changed.rows(); ++i)
+        {
+            vecCentroid = C_new.row(i);
+            if(iter > 1)
+                matLower.row(changed[i]).array() -= toMetric(pointDistance(Ct.col(changed[i]).data(), vecCentroid.data(), p, bSqEuclidean), bSqEuclidean);
+
+            C.row(changed[i]) = vecCentroid;
+            Ct.col(changed[i]) = vecCentroid.transpose();
+            m[changed[i]] = m_new[i];
+            vecChanged[changed[i]] = 1;
+        }
+
+        // Clusters that have just lost all their members terminate the replicate (emptyact "error")
+        for(i = 0; i < changed.rows(); ++i)
+            if(m[changed[i]] == 0)
+                return converged;
+
+        // Only the points of changed clusters need their own distance updated
+        for(i = 0; i < n; ++i)
+            if(vecChanged[idx[i]])
+                vecAssigned[i] = pointDistance(Xt.col(i).data(), Ct.col(idx[i]).data(), p, bSqEuclidean);
+
+        // Compute the total sum of distances for the current configuration.
+        totsumD = 0;
+        for(i = 0; i < n; ++i)
+            totsumD += vecAssigned[i];
+        // Test for a cycle: if objective is not decreased, back out
+        // the last step and move on to the single update phase
+        if(prevtotsumD <= totsumD)
+        {
+            idx = previdx;
+            gcentroids(X, idx, changed, C_new, m_new);
+            for(i = 0; i < changed.rows(); ++i)
+            {
+                C.row(changed[i]) = C_new.row(i);
+                m[changed[i]] = m_new[i];
+            }
+            --iter;
+            break;
+        }
+
+        if (iter >= m_iMaxit)
+            break;
+
+        // Determine closest cluster for each point and reassign points to clusters
+        previdx = idx;
+        prevtotsumD = totsumD;
+
+        for(i = 0; i < k; ++i)
+            for(qint32 j = i + 1; j < k; ++j)
+                matCC(i,j) = matCC(j,i) = toMetric(pointDistance(Ct.col(i).data(), Ct.col(j).data(), p, bSqEuclidean), bSqEuclidean);
+
+        VectorXi nidx(n);
+
+        qint32 nChunks = 1;
+        if(m_bParallel && (qint64)n * k * p >= KMEANS_PARALLEL_MIN_WORK)
+            nChunks = qMax(1, qMin(n, 4*QThread::idealThreadCount()));
+        qint32 iPointsPerChunk = (n + nChunks - 1) / nChunks;
+
+        QList<AssignChunk> chunks;
+        for(qint32 iFirst = 0; iFirst < n; iFirst += iPointsPerChunk)
+        {
+            AssignChunk chunk;
+            chunk.pXt = &Xt;
+            chunk.pCt = &Ct;
+            chunk.pCC = &matCC;
+            chunk.pIdx = &idx;
+            chunk.pLower = &matLower;
+            chunk.pAssigned = &vecAssigned;
+            chunk.pNewIdx = &nidx;
+            chunk.pMinD = &d;
+            chunk.bSqEuclidean = bSqEuclidean;
+            chunk.iFirst = iFirst;
+            chunk.iLast = qMin(n, iFirst + iPointsPerChunk);
+            chunks.append(chunk);
+        }
+
+        if(chunks.size() > 1)
+            QtConcurrent::blockingMapped(chunks, &KMeans::assignChunk);
+        else
+            assignChunk(chunks.first());
+
+        // Determine which points moved, ties are already resolved in favor of not moving
+        VectorXi moved(n);
+        qint32 count = 0;
+        for(i = 0; i < n; ++i)
+        {
+            if(nidx[i] != previdx[i])
+            {
+                moved[count] = i;
+                ++count;
+            }
+        }
+        moved.conservativeResize(count);
+
+        if (moved.rows() == 0)
+        {
+            converged = true;
+            break;
+        }
+
+        for(i = 0; i < moved.rows(); ++i)
+            idx[ moved[i] ] = nidx[ moved[i] ];
+
+        // Find clusters that gained or lost members
+        std::vector<int> tmp;
+        for(i = 0; i < moved.rows(); ++i)
+            tmp.push_back(idx[moved[i]]);
+        for(i = 0; i < moved.rows(); ++i)
+            tmp.push_back(previdx[moved[i]]);
+
+        std::sort(tmp.begin(),tmp.end());
+
+        std::vector<int>::iterator it;
+        it = std::unique(tmp.begin(),tmp.end());
+        tmp.resize( it - tmp.begin() );
+
+        changed.conservativeResize(tmp.size());
+
+        for(quint32 j = 0; j < tmp.size(); ++j)
+            changed[j] = tmp[j];
+    } // phase one
+    return converged;
+}
+
+
+//*************************************************************************************************************
+
+bool KMeans::assignChunk(const AssignChunk& chunk)
+{
+    const MatrixXd& Xt = *chunk.pXt;
+    const MatrixXd& Ct = *chunk.pCt;
+    const MatrixXd& matCC = *chunk.pCC;
+    const VectorXi& idx = *chunk.pIdx;
+    MatrixXd& matLower = *chunk.pLower;
+
+    const qint32 p = Xt.rows();
+    const qint32 k = Ct.cols();
+
+    for(qint32 i = chunk.iFirst; i < chunk.iLast; ++i)
+    {
+        // Only centroids which are strictly closer than the current one move the point
+        qint32 iBest = idx[i];
+        double dBest = (*chunk.pAssigned)[i];
+        double dBound = toMetric(dBest, chunk.bSqEuclidean);
+        matLower(iBest, i) = dBound;
+        dBound *= 1.0 + KMEANS_BOUND_TOL;
+
+        for(qint32 j = 0; j < k; ++j)
+        {
+            if(j == idx[i] || matLower(j, i) > dBound || 0.5 * matCC(iBest, j) > dBound)
+                continue;
+
+            double dDist = pointDistance(Xt.col(i).data(), Ct.col(j).data(), p, chunk.bSqEuclidean);
+            matLower(j, i) = toMetric(dDist, chunk.bSqEuclidean);
+
+            if(dDist < dBest)
+            {
+                iBest = j;
+                dBest = dDist;
+                dBound = matLower(j, i) * (1.0 + KMEANS_BOUND_TOL);
+            }
+        }
+
+        (*chunk.pNewIdx)[i] = iBest;
+        (*chunk.pMinD)[i] = dBest;
+        (*chunk.pAssigned)[i] = dBest;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+double KMeans::pointDistance(const double* pX, const double* pC, qint32 iDim, bool bSqEuclidean)
+{
+    double dDist = 0.0;
+
+    if(bSqEuclidean)
+    {
+        for(qint32 j = 0; j < iDim; ++j)
+        {
+            double dDiff = pX[j] - pC[j];
+            dDist += dDiff * dDiff;
+        }
+    }
+    else
+    {
+        for(qint32 j = 0; j < iDim; ++j)
+            dDist += fabs(pX[j] - pC[j]);
+    }
+
+    return dDist;
+}
+
+
+//*************************************************************************************************************
+
+double KMeans::toMetric(double dDist, bool bSqEuclidean)
+{
+    return bSqEuclidean ? sqrt(dDist) : dDist;
+}
+
+
+//*************************************************************************************************************
+
+bool KMeans::useBoundedUpdate() const
+{
+    return (m_sDistance.compare("sqeuclidean") == 0 || m_sDistance.compare("cityblock") == 0)
+            && m_sEmptyact.compare("error") == 0;
+}
+
+
 
 //*************************************************************************************************************
 
@@ -626,7 +996,7 @@ bool KMeans::onlineUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
 
                 Del.col(i) = ((double)m[i] / ((double)m[i] + sgn.cast<double>().array()));
 
-                Del.col(i).array() *= (X - C.row(i).replicate(n,1)).array().pow(2).rowwise().sum().array();
+                Del.col(i).array() *= (X.rowwise() - C.row(i)).array().square().rowwise().sum();
             }
         }
         else if (m_sDistance.compare("cityblock") == 0)
@@ -636,26 +1006,26 @@ bool KMeans::onlineUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
                 qint32 i = changed[j];
                 if (m(i) % 2 == 0) // this will never catch singleton clusters
                 {
-                    MatrixXd ldist = Xmid1.row(i).replicate(n,1) - X;
-                    MatrixXd rdist = X - Xmid2.row(i).replicate(n,1);
-                    VectorXd mbrs = VectorXd::Zero(idx.rows());
-
+                    VectorXd sgn = VectorXd::Ones(n); // -1 for members, 1 for nonmembers
                     for(qint32 l = 0; l < idx.rows(); ++l)
                         if(idx[l] == i)
-                            mbrs[l] = 1;
-                    MatrixXd sgn = ((-2*mbrs).array() + 1).replicate(1, p); // -1 for members, 1 for nonmembers
-                    rdist = sgn.array()*rdist.array(); ldist = sgn.array()*ldist.array();
+                            sgn[l] = -1;
 
-                    for(qint32 l = 0; l < idx.rows(); ++l)
+                    // Column by column, without the n x p intermediates
+                    Del.col(i).setZero();
+                    double rdist, ldist;
+                    for(qint32 h = 0; h < p; ++h)
                     {
-                        double sum = 0;
-                        for(qint32 h = 0; h < rdist.cols(); ++h)
-                            sum += rdist(l,h) > ldist(l,h) ? rdist(l,h) < 0 ? 0 : rdist(l,h) : ldist(l,h) < 0 ? 0 : ldist(l,h);
-                        Del(l,i) = sum;
+                        for(qint32 l = 0; l < n; ++l)
+                        {
+                            rdist = sgn[l] * (X(l,h) - Xmid2(i,h));
+                            ldist = sgn[l] * (Xmid1(i,h) - X(l,h));
+                            Del(l,i) += rdist > ldist ? rdist < 0 ? 0 : rdist : ldist < 0 ? 0 : ldist;
+                        }
                     }
                 }
                 else
-                    Del.col(i) = ((X - C.row(i).replicate(n,1)).array().abs()).rowwise().sum();
+                    Del.col(i) = (X.rowwise() - C.row(i)).array().abs().rowwise().sum();
             }
         }
         else if (m_sDistance.compare("cosine") == 0 || m_sDistance.compare("correlation") == 0)
@@ -881,7 +1251,7 @@ bool KMeans::onlineUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx)
 
 //*************************************************************************************************************
 //DISTFUN Calculate point to cluster centroid distances.
-MatrixXd KMeans::distfun(const MatrixXd& X, MatrixXd& C)//, qint32 iter)
+MatrixXd KMeans::distfun(const MatrixXd& X, const MatrixXd& C)//, qint32 iter)
 {
     MatrixXd D = MatrixXd::Zero(n,C.rows());
     qint32 nclusts = C.rows();
@@ -890,10 +1260,10 @@ MatrixXd KMeans::distfun(const MatrixXd& X, MatrixXd& C)//, qint32 iter)
     {
         for(qint32 i = 0; i < nclusts; ++i)
         {
-            D.col(i) = (X.col(0).array() - C(i,0)).pow(2);
+            D.col(i) = (X.col(0).array() - C(i,0)).square();
 
             for(qint32 j = 1; j < p; ++j)
-                D.col(i) = D.col(i).array() + (X.col(j).array() - C(i,j)).pow(2);
+                D.col(i) = D.col(i).array() + (X.col(j).array() - C(i,j)).square();
         }
     }
     else if (m_sDistance.compare("cityblock") == 0)
@@ -90,7 +90,7 @@ public:
     typedef QSharedPointer<const KMeans> ConstSPtr; /**< Const shared pointer type for KMeans. */
 
     //distance {'sqeuclidean','cityblock','cosine','correlation','hamming'};
-    //startNames = {'uniform','sample','cluster'};
+    //startNames = {'uniform','sample','cluster','plus'};
     //emptyactNames = {'error','drop','singleton'};
 
     //=========================================================================================================
@@ -98,13 +98,14 @@ public:
     * Constructs a KMeans algorithm object.
     *
     * @param[in] distance   (optional) K-Means distance measure: "sqeuclidean" (default), "cityblock" , "cosine", "correlation", "hamming"
-    * @param[in] start      (optional) Cluster initialization: "sample" (default), "uniform", "cluster"
+    * @param[in] start      (optional) Cluster initialization: "sample" (default), "uniform", "cluster", "plus" (k-means++ seeding)
     * @param[in] replicates (optional) Number of K-Means replicates, which are generated. Best is returned.
     * @param[in] emptyact   (optional) What happens if a cluster wents empty: "error" (default), "drop", "singleton"
     * @param[in] online     (optional) If centroids should be updated during iterations: true (default), false
     * @param[in] maxit      (optional) maximal number of iterations per replicate; 100 by default
+    * @param[in] parallel   (optional) If replicates and distance computations should be spread across threads: false (default), true
     */
-    explicit KMeans(QString distance = QString("sqeuclidean") , QString start = QString("sample"), qint32 replicates = 1, QString emptyact = QString("error"), bool online = true, qint32 maxit = 100);
+    explicit KMeans(QString distance = QString("sqeuclidean") , QString start = QString("sample"), qint32 replicates = 1, QString emptyact = QString("error"), bool online = true, qint32 maxit = 100, bool parallel = false);
 
     //=========================================================================================================
     /**
@@ -121,6 +122,82 @@ public:
 
 
 private:
+    //=========================================================================================================
+    /**
+    * Result of one replicate
+    */
+    struct Replicate {
+        MatrixXd    C;          /**< Starting centroids on input, final centroids on output */
+        VectorXi    idx;        /**< The cluster indeces to which cluster the input points belong to */
+        VectorXd    sumD;       /**< Summation of the distances to the centroid within one cluster */
+        MatrixXd    D;          /**< Cluster distances to the centroid */
+        double      totsumD;    /**< Total sum of centroid distances */
+        bool        bSuccess;   /**< False if the replicate was terminated by an empty cluster */
+    };
+
+    //=========================================================================================================
+    /**
+    * One replicate to be calculated by a worker thread
+    */
+    struct ReplicateChunk {
+        const KMeans*   pKMeans;    /**< The KMeans object holding the settings, each worker clusters on its own copy */
+        const MatrixXd* pX;         /**< Input data */
+        const MatrixXd* pXt;        /**< Transposed input data, used by the bounded batch update */
+        Replicate*      pReplicate; /**< The replicate to calculate */
+        qint32          iRep;       /**< Number of the replicate */
+    };
+
+    //=========================================================================================================
+    /**
+    * Range of points to be assigned to their closest centroid by a worker thread
+    */
+    struct AssignChunk {
+        const MatrixXd* pXt;        /**< Points, one per column */
+        const MatrixXd* pCt;        /**< Centroids, one per column */
+        const MatrixXd* pCC;        /**< Metric centroid to centroid distances */
+        const VectorXi* pIdx;       /**< Current cluster indeces */
+        MatrixXd*       pLower;     /**< Lower bounds of the metric point to centroid distances, one column per point */
+        VectorXd*       pAssigned;  /**< Distance of each point to the centroid of its cluster */
+        VectorXi*       pNewIdx;    /**< Closest cluster of each point */
+        VectorXd*       pMinD;      /**< Distance of each point to its closest centroid */
+        bool            bSqEuclidean;   /**< Squared euclidean distance if true, cityblock otherwise */
+        qint32          iFirst;     /**< First point of the chunk */
+        qint32          iLast;      /**< One past the last point of the chunk */
+    };
+
+    //=========================================================================================================
+    /**
+    * Calculates one replicate on a copy of the KMeans object. Used by calculate in parallel mode.
+    *
+    * @param[in] chunk      The replicate to calculate.
+    *
+    * @return true if the replicate finished, false if it was terminated by an empty cluster
+    */
+    static bool computeReplicateChunk(const ReplicateChunk& chunk);
+
+    //=========================================================================================================
+    /**
+    * Clusters the input data starting from the centroids of the given replicate.
+    *
+    * @param[in] X              Input data (rows = points; cols = p dimensional space)
+    * @param[in] Xt             Transposed input data, only needed by the bounded batch update
+    * @param[in] rep            Number of the replicate
+    * @param[in, out] replicate Starting centroids on input, clustering result on output
+    *
+    * @return true if the replicate finished, false if it was terminated by an empty cluster
+    */
+    bool runReplicate(const MatrixXd& X, const MatrixXd& Xt, qint32 rep, Replicate& replicate);
+
+    //=========================================================================================================
+    /**
+    * k-means++ seeding: the first centroid is a random sample, every further centroid is sampled with a
+    * probability proportional to the distance to the closest centroid chosen so far.
+    *
+    * @param[in] X      Input data
+    * @param[out] C     The starting centroids
+    */
+    void plusplusStart(const MatrixXd& X, MatrixXd& C);
+
     //=========================================================================================================
     /**
     * Calculate point to cluster centroid distances.
@@ -130,7 +207,51 @@ private:
     *
     * @return Cluster centroid distances
     */
-    MatrixXd distfun(const MatrixXd& X, MatrixXd& C);//, qint32 iter);
+    MatrixXd distfun(const MatrixXd& X, const MatrixXd& C);//, qint32 iter);
+
+    //=========================================================================================================
+    /**
+    * Distance of one point to one centroid, in the units of distfun.
+    *
+    * @param[in] pX             The point coordinates
+    * @param[in] pC             The centroid coordinates
+    * @param[in] iDim           Dimension of the space
+    * @param[in] bSqEuclidean   Squared euclidean distance if true, cityblock otherwise
+    *
+    * @return The distance
+    */
+    static double pointDistance(const double* pX, const double* pC, qint32 iDim, bool bSqEuclidean);
+
+    //=========================================================================================================
+    /**
+    * Converts a distance of pointDistance to a metric, for which the triangle inequality holds.
+    *
+    * @param[in] dDist          The distance
+    * @param[in] bSqEuclidean   Squared euclidean distance if true, cityblock otherwise
+    *
+    * @return The metric distance
+    */
+    static double toMetric(double dDist, bool bSqEuclidean);
+
+    //=========================================================================================================
+    /**
+    * Assigns a range of points to their closest centroid. Candidates which are excluded by the lower
+    * bounds or by the centroid to centroid distances (triangle inequality) are not evaluated.
+    *
+    * @param[in] chunk      The range of points.
+    *
+    * @return true when done
+    */
+    static bool assignChunk(const AssignChunk& chunk);
+
+    //=========================================================================================================
+    /**
+    * Whether the batch update can prune distance computations with the triangle inequality. This is the case
+    * for the "sqeuclidean" and "cityblock" distances when an empty cluster terminates the replicate.
+    *
+    * @return true if boundedBatchUpdate is used
+    */
+    bool useBoundedUpdate() const;
 
     //=========================================================================================================
     /**
@@ -144,6 +265,20 @@ private:
     */
     bool batchUpdate(const MatrixXd& X, MatrixXd& C, VectorXi& idx);
 
+    //=========================================================================================================
+    /**
+    * Updates clusters when points moved, same as batchUpdate but keeps lower bounds of the point to centroid
+    * distances (Elkan) to skip distance computations which can not change the assignment.
+    *
+    * @param[in] X          Input data
+    * @param[in] Xt         Transposed input data
+    * @param[in, out] C     Cluster centroids
+    * @param[in, out] idx   The cluster indeces to which cluster the input points belong to
+    *
+    * @return true if converged, false otherwise
+    */
+    bool boundedBatchUpdate(const MatrixXd& X, const MatrixXd& Xt, MatrixXd& C, VectorXi& idx);
+
     //=========================================================================================================
     /**
     * Centroids and counts stratified by group.
@@ -188,6 +323,7 @@ private:
     QString m_sEmptyact;    /**< What should be done if a cluster wents empty: "error" (default), "drop", "singleton" */
     qint32 m_iMaxit;        /**< Maximal number of iterations per replicate */
     bool m_bOnline;         /**< If online update should be performed */
+    bool m_bParallel;       /**< If replicates and distance computations are spread across threads */
 
     qint32 emptyErrCnt;     /**< Counts the occurence of empty errors */
 
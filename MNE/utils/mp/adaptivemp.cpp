@@ -87,8 +87,9 @@ using namespace UTILSLIB;
 // DEFINE MEMBER METHODS
 //=============================================================================================================
 
-AdaptiveMp::AdaptiveMp()
-: it(0)
+AdaptiveMp::AdaptiveMp(bool parallel)
+: parallel(parallel)
+, it(0)
 , max_it(0)
 , signal_energy(0)
 , current_energy(0)
@@ -129,6 +130,32 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
     }
     std::cout << "absolute energy of signal: " << residuum_energy << "\n";
 
+    //the dyadic scales, their modulations and envelope spectra are the same in every iteration
+    QList<qreal> scales;
+    QList<QVector<qreal> > scale_modulations;
+    QList<VectorXcd> fft_envelopes;
+    {
+        qreal s = 1;
+        qint32 j = 1;
+        while(s < sample_count)
+        {
+            QVector<qreal> modulations;
+            for(qreal k = 0; k < sample_count/2; k += pow(2.0,(-j))*sample_count/2)
+                modulations.append(k);
+
+            VectorXd envelope = GaborAtom::gauss_function(sample_count, s, floor(sample_count / 2));
+            VectorXcd fft_envelope = RowVectorXcd::Zero(sample_count);
+            fft.fwd(fft_envelope, envelope);
+
+            scales.append(s);
+            scale_modulations.append(modulations);
+            fft_envelopes.append(fft_envelope);
+
+            j++;
+            s = pow(2.0,j);
+        }
+    }
+
     while(it < max_iterations && (energy_threshold < residuum_energy) && sample_count > 1)
     {
         channel_count = channel_count * (boost / 100.0); //reducing the number of observed channels in the algorithm to increase speed performance
@@ -144,58 +171,19 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
         GaborAtom *gabor_Atom = new GaborAtom();
         gabor_Atom->sample_count = sample_count;
         gabor_Atom->energy = 0;
-        qreal phase = 0;
 
-        while(s < sample_count)
+        for(qint32 scale_idx = 0; scale_idx < scales.size(); scale_idx++)
         {
-            k = 0;                               //for modulation 2*pi*k/N
-            p = floor(sample_count / 2);         //translation
-            VectorXd envelope = GaborAtom::gauss_function(sample_count, s, p);
-            VectorXcd fft_envelope = RowVectorXcd::Zero(sample_count);
-            fft.fwd(fft_envelope, envelope);
+            const QVector<qreal>& modulations = scale_modulations.at(scale_idx);
+            MatrixXd candidates = search_candidates(residuum, &fft_envelopes.at(scale_idx), modulations, scales.at(scale_idx),
+                                                    channel_count, fix_phase);
 
-            while(k < sample_count/2)
+            //compare in the order of the sequential search: modulations outer, channels inner
+            for(qint32 mod_idx = 0; mod_idx < modulations.size(); mod_idx++)
             {
-                p = floor(sample_count/2);
-                VectorXcd modulation = modulation_function(sample_count, k);
-                VectorXcd modulated_resid = VectorXcd::Zero(sample_count);
-                VectorXcd fft_modulated_resid = VectorXcd::Zero(sample_count);
-                VectorXcd fft_m_e_resid = VectorXcd::Zero(sample_count);
-                VectorXd corr_coeffs = VectorXd::Zero(sample_count);
-
-                //iteration for multichannel, depending on boost setting
                 for(qint32 chn = 0; chn < channel_count; chn++)
                 {
-                    qint32 max_index = 0;
-                    qreal maximum = 0;
-                    phase = 0;
-                    p = floor(sample_count/2);//here is difference to dr. gratkowski´s code (he didn´t reset parameter p)
-
-                    //complex correlation of signal and sinus-modulated gaussfunction
-                    for(qint32 l = 0; l< sample_count; l++)
-                        modulated_resid[l] = residuum(l, chn) * modulation[l];
-
-                    fft.fwd(fft_modulated_resid, modulated_resid);
-
-                    for( qint32 m = 0; m < sample_count; m++)
-                        fft_m_e_resid[m] = fft_modulated_resid[m] * conj(fft_envelope[m]);
-
-                    fft.inv(corr_coeffs, fft_m_e_resid);
-                    maximum = corr_coeffs[0];
-
-                    //find index of maximum correlation-coefficient to use in translation
-                    for(qint32 i = 1; i < corr_coeffs.rows(); i++)
-                        if(maximum < corr_coeffs[i])
-                        {
-                            maximum = corr_coeffs[i];
-                            max_index = i;
-                        }
-
-                    //adapting translation p to create atomtranslation correctly
-                    if(max_index >= p) p = max_index - p + 1;
-                    else p = max_index + p;
-
-                    VectorXd atom_parameters = calculate_atom(sample_count, s, p, k, chn, residuum, RETURNPARAMETERS, fix_phase);
+                    VectorXd atom_parameters = candidates.col(chn * modulations.size() + mod_idx);
                     qreal temp_scalar_product = 0;
                     if(trial_separation) temp_scalar_product = max_scalar_product[chn];
                     else temp_scalar_product = max_scalar_product[0];
@@ -223,13 +211,8 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
                             max_scalar_product[0]      = atom_parameters[4];
 
                     }
-
                 }
-                k += pow(2.0,(-j))*sample_count/2;
-
             }
-            j++;
-            s = pow(2.0,j);
         }
         std::cout << "\n" << "===============" << " found parameters " << it + 1 << "===============" << ":\n\n"<<
                      "scale: " << gabor_Atom->scale << " trans: " << gabor_Atom->translation <<
@@ -240,16 +223,19 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
         s = sample_count;
         p = floor(sample_count / 2);
         j = floor(log10(sample_count)/log10(2));//log(sample_count) / log(2));
-        phase = 0;
+
+        QVector<qreal> modulations;
+        for(k = 0; k < sample_count / 2; k += pow(2.0,(-j))*sample_count/2)
+            modulations.append(k);
+
+        MatrixXd candidates = search_candidates(residuum, NULL, modulations, s, channel_count, fix_phase);
 
         //iteration for multichannel, depending on boost setting
         for(qint32 chn = 0; chn < channel_count; chn++)
         {
-            k = 0;
-
-            while(k < sample_count / 2)
+            for(qint32 mod_idx = 0; mod_idx < modulations.size(); mod_idx++)
             {
-                VectorXd parameters_no_envelope = calculate_atom(sample_count, s, p, k, chn, residuum, RETURNPARAMETERS, fix_phase);
+                VectorXd parameters_no_envelope = candidates.col(chn * modulations.size() + mod_idx);
 
                 qreal temp_scalar_product = 0;
                 if(trial_separation) temp_scalar_product = max_scalar_product[chn];
@@ -274,10 +260,7 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
                         max_scalar_product[0]      = parameters_no_envelope[4];
 
                 }
-                k += pow(2.0,(-j))*sample_count/2;
-
             }
-
         }
         std::cout << "      after comparison to NoEnvelope " << ":\n"<< "scale: " << gabor_Atom->scale << " trans: " << gabor_Atom->translation <<
                      " modu: " << gabor_Atom->modulation << " phase: " << gabor_Atom->phase << " sclr_prdct: " << gabor_Atom->max_scalar_product << "\n\n";
@@ -399,7 +382,7 @@ VectorXcd AdaptiveMp::modulation_function(qint32 N, qreal k)
 
 //*************************************************************************************************************
 
-VectorXd AdaptiveMp::calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, MatrixXd residuum, ReturnValue return_value = RETURNATOM, bool fix_phase = false)
+VectorXd AdaptiveMp::calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, const MatrixXd &residuum, ReturnValue return_value = RETURNATOM, bool fix_phase = false)
 {
     GaborAtom *gabor_Atom = new GaborAtom();
     qreal phase = 0;
@@ -463,7 +446,7 @@ VectorXd AdaptiveMp::calculate_atom(qint32 sample_count, qreal scale, qint32 tra
 //*************************************************************************************************************
 
 void AdaptiveMp::simplex_maximisation(qint32 simplex_it, qreal simplex_reflection, qreal simplex_expansion, qreal simplex_contraction, qreal simplex_full_contraction,
-                                      GaborAtom *gabor_Atom, VectorXd max_scalar_product, qint32 sample_count, bool fix_phase, MatrixXd residuum, bool trial_separation, qint32 chn)
+                                      GaborAtom *gabor_Atom, const VectorXd &max_scalar_product, qint32 sample_count, bool fix_phase, const MatrixXd &residuum, bool trial_separation, qint32 chn)
 {
     //Maximisation Simplex Algorithm implemented by Botao Jia, adapted to the MP Algorithm by Martin Henfling. Copyright (C) 2010 Botao Jia
     //ToDo: change to clean use of EIGEN, @present its mixed with Namespace std and <vector>
@@ -694,6 +677,241 @@ void AdaptiveMp::simplex_maximisation(qint32 simplex_it, qreal simplex_reflectio
 
 //*************************************************************************************************************
 
+MatrixXd AdaptiveMp::search_candidates(const MatrixXd &residuum, const VectorXcd *fft_envelope, const QVector<qreal> &modulations, qreal scale,
+                                       qint32 channel_count, bool fix_phase) const
+{
+    MatrixXd candidates(5, channel_count * modulations.size());
+
+    //the phase of fix phase atoms is taken from the mean inner product of all channels, i.e. from the sum of the channels
+    VectorXd residuum_sum;
+    if(fix_phase)
+        residuum_sum = residuum.rowwise().sum();
+
+    //every chunk rebuilds the modulation vectors, so use no more chunks than threads
+    qint32 chunk_count = parallel ? qMax(1, qMin(channel_count, QThread::idealThreadCount())) : 1;
+
+    QList<SearchChunk> chunks;
+    for(qint32 i = 0; i < chunk_count; i++)
+    {
+        SearchChunk chunk;
+        chunk.residuum = &residuum;
+        chunk.residuum_sum = &residuum_sum;
+        chunk.fft_envelope = fft_envelope;
+        chunk.modulations = &modulations;
+        chunk.candidates = &candidates;
+        chunk.sample_count = residuum.rows();
+        chunk.scale = scale;
+        chunk.fix_phase = fix_phase;
+        chunk.first_channel = i * channel_count / chunk_count;
+        chunk.last_channel = (i + 1) * channel_count / chunk_count;
+        chunks.append(chunk);
+    }
+
+    if(chunks.size() == 1)
+        search_chunk(chunks[0]);
+    else
+        QtConcurrent::blockingMapped(chunks, &AdaptiveMp::search_chunk);
+
+    return candidates;
+}
+
+//*************************************************************************************************************
+
+bool AdaptiveMp::search_chunk(const SearchChunk &chunk)
+{
+    if(chunk.fft_envelope)
+        search_envelope_chunk(chunk);
+    else
+        search_no_envelope_chunk(chunk);
+
+    return true;
+}
+
+//*************************************************************************************************************
+
+void AdaptiveMp::search_envelope_chunk(const SearchChunk &chunk)
+{
+    //Eigen::FFT caches its plans and must not be shared between threads
+    Eigen::FFT<double> fft;
+    const MatrixXd &residuum = *chunk.residuum;
+    qint32 sample_count = chunk.sample_count;
+    qint32 modulation_count = chunk.modulations->size();
+
+    //gaussian window for every distance to the translation, it underflows to zero beyond 16 scales
+    VectorXd gauss_table(2 * sample_count - 1);
+    for(qint32 d = -(sample_count - 1); d < sample_count; d++)
+    {
+        qreal t = qreal(d) / chunk.scale;
+        gauss_table[d + sample_count - 1] = exp( -PI * pow(t, 2.0));
+    }
+    qint32 window = qMin(sample_count, qint32(ceil(16 * chunk.scale)));
+
+    VectorXcd modulated_resid = VectorXcd::Zero(sample_count);
+    VectorXcd fft_modulated_resid = VectorXcd::Zero(sample_count);
+    VectorXcd fft_m_e_resid = VectorXcd::Zero(sample_count);
+    VectorXd corr_coeffs = VectorXd::Zero(sample_count);
+    VectorXd cos_mod(sample_count);
+    VectorXd sin_mod(sample_count);
+
+    for(qint32 mod_idx = 0; mod_idx < modulation_count; mod_idx++)
+    {
+        qreal k = chunk.modulations->at(mod_idx);
+        VectorXcd modulation = modulation_function(sample_count, k);
+        for(qint32 i = 0; i < sample_count; i++)
+        {
+            qreal arg = 2 * PI * k / qreal(sample_count) * qreal(i);
+            cos_mod[i] = cos(arg);
+            sin_mod[i] = sin(arg);
+        }
+
+        for(qint32 chn = chunk.first_channel; chn < chunk.last_channel; chn++)
+        {
+            qint32 max_index = 0;
+            qreal maximum = 0;
+            qint32 p = floor(sample_count / 2);
+
+            //complex correlation of signal and sinus-modulated gaussfunction
+            for(qint32 l = 0; l< sample_count; l++)
+                modulated_resid[l] = residuum(l, chn) * modulation[l];
+
+            fft.fwd(fft_modulated_resid, modulated_resid);
+
+            for( qint32 m = 0; m < sample_count; m++)
+                fft_m_e_resid[m] = fft_modulated_resid[m] * conj((*chunk.fft_envelope)[m]);
+
+            fft.inv(corr_coeffs, fft_m_e_resid);
+            maximum = corr_coeffs[0];
+
+            //find index of maximum correlation-coefficient to use in translation
+            for(qint32 i = 1; i < corr_coeffs.rows(); i++)
+                if(maximum < corr_coeffs[i])
+                {
+                    maximum = corr_coeffs[i];
+                    max_index = i;
+                }
+
+            //adapting translation p to create atomtranslation correctly
+            if(max_index >= p) p = max_index - p + 1;
+            else p = max_index + p;
+
+            //inner products of the residuum with the enveloped cosine and sine, as calculate_atom would do it
+            qint32 first = qMax(0, p - window);
+            qint32 last = qMin(sample_count, p + window + 1);
+            const double *envelope = gauss_table.data() + sample_count - 1 - p;
+
+            qreal cos_product = 0, sin_product = 0, cos_cos = 0, cos_sin = 0, sin_sin = 0, sum_cos_product = 0, sum_sin_product = 0;
+            for(qint32 i = first; i < last; i++)
+            {
+                qreal e_cos = envelope[i] * cos_mod[i];
+                qreal e_sin = envelope[i] * sin_mod[i];
+                cos_product += residuum(i, chn) * e_cos;
+                sin_product += residuum(i, chn) * e_sin;
+                cos_cos += e_cos * e_cos;
+                cos_sin += e_cos * e_sin;
+                sin_sin += e_sin * e_sin;
+                if(chunk.fix_phase)
+                {
+                    sum_cos_product += (*chunk.residuum_sum)[i] * e_cos;
+                    sum_sin_product += (*chunk.residuum_sum)[i] * e_sin;
+                }
+            }
+
+            if(chunk.fix_phase)
+                chunk.candidates->col(chn * modulation_count + mod_idx) = atom_parameters(chunk.scale, p, k, sum_cos_product, sum_sin_product,
+                                                                                          cos_product, sin_product, cos_cos, cos_sin, sin_sin);
+            else
+                chunk.candidates->col(chn * modulation_count + mod_idx) = atom_parameters(chunk.scale, p, k, cos_product, sin_product,
+                                                                                          cos_product, sin_product, cos_cos, cos_sin, sin_sin);
+        }
+    }
+}
+
+//*************************************************************************************************************
+
+void AdaptiveMp::search_no_envelope_chunk(const SearchChunk &chunk)
+{
+    Eigen::FFT<double> fft;
+    const MatrixXd &residuum = *chunk.residuum;
+    qint32 sample_count = chunk.sample_count;
+    qint32 modulation_count = chunk.modulations->size();
+    qint32 p = floor(sample_count / 2);
+
+    //the modulations are the multiples of sample_count / 2^(j+1), so all inner products of one channel are the bins of
+    //one zero padded DFT of length 2^(j+1)
+    qint32 j = floor(log10(sample_count)/log10(2));
+    qint32 dft_length = pow(2.0, j + 1);
+
+    VectorXd padded = VectorXd::Zero(dft_length);
+    VectorXcd spectrum(dft_length);
+
+    //sums of cos(2x) and sin(2x) over the signal for the norm of the real atoms
+    padded.head(sample_count).setOnes();
+    VectorXcd window_spectrum(dft_length);
+    fft.fwd(window_spectrum, padded);
+
+    VectorXcd sum_spectrum;
+    if(chunk.fix_phase)
+    {
+        padded.head(sample_count) = *chunk.residuum_sum;
+        fft.fwd(sum_spectrum, padded);
+    }
+
+    for(qint32 chn = chunk.first_channel; chn < chunk.last_channel; chn++)
+    {
+        padded.head(sample_count) = residuum.col(chn);
+        fft.fwd(spectrum, padded);
+
+        for(qint32 mod_idx = 0; mod_idx < modulation_count; mod_idx++)
+        {
+            std::complex<double> double_mod = window_spectrum[(2 * mod_idx) % dft_length];
+            qreal cos_cos = 0.5 * (sample_count + double_mod.real());
+            qreal sin_sin = 0.5 * (sample_count - double_mod.real());
+            qreal cos_sin = -0.5 * double_mod.imag();
+
+            qreal cos_product = spectrum[mod_idx].real();
+            qreal sin_product = -spectrum[mod_idx].imag();
+
+            if(chunk.fix_phase)
+                chunk.candidates->col(chn * modulation_count + mod_idx) = atom_parameters(chunk.scale, p, chunk.modulations->at(mod_idx),
+                                                                                          sum_spectrum[mod_idx].real(), -sum_spectrum[mod_idx].imag(),
+                                                                                          cos_product, sin_product, cos_cos, cos_sin, sin_sin);
+            else
+                chunk.candidates->col(chn * modulation_count + mod_idx) = atom_parameters(chunk.scale, p, chunk.modulations->at(mod_idx),
+                                                                                          cos_product, sin_product,
+                                                                                          cos_product, sin_product, cos_cos, cos_sin, sin_sin);
+        }
+    }
+}
+
+//*************************************************************************************************************
+
+VectorXd AdaptiveMp::atom_parameters(qreal scale, qint32 translation, qreal modulation, qreal phase_cos_product, qreal phase_sin_product,
+                                     qreal cos_product, qreal sin_product, qreal cos_cos, qreal cos_sin, qreal sin_sin)
+{
+    //the inner product with the complex atom is cos_product - i*sin_product, up to a positive factor
+    qreal phase = std::arg(std::complex<double>(phase_cos_product, -phase_sin_product));
+    if (phase < 0) phase = 2 * PI - phase;
+
+    //real atom envelope * cos(modulation + phase), expanded by the addition theorem
+    qreal cos_phase = cos(phase);
+    qreal sin_phase = sin(phase);
+    qreal scalar_product = cos_phase * cos_product - sin_phase * sin_product;
+    qreal norm = cos_phase * cos_phase * cos_cos - 2 * cos_phase * sin_phase * cos_sin + sin_phase * sin_phase * sin_sin;
+    if(norm > 0)
+        scalar_product /= sqrt(norm);
+
+    VectorXd parameters(5);
+    parameters[0] = scale;
+    parameters[1] = translation;
+    parameters[2] = modulation;
+    parameters[3] = phase;
+    parameters[4] = scalar_product;
+
+    return parameters;
+}
+
+//*************************************************************************************************************
+
 void AdaptiveMp::recieve_input(Eigen::MatrixXd signal, qint32 max_iterations, qreal epsilon, bool fix_phase = false, qint32 boost = 0, qint32 simplex_it = 1E3,
                                qreal simplex_reflection = 1.0, qreal simplex_expansion = 0.2, qreal simplex_contraction = 0.5, qreal simplex_full_contraction = 0.5, bool trial_separation = false)
 {
@@ -65,6 +65,7 @@
 //=============================================================================================================
 
 #include <QThread>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -108,8 +109,9 @@ public:
     *
     * constructs adaptiveMP class
     *
+    * @param[in] parallel   whether the atom search is distributed over the channels in parallel threads
     */
-    AdaptiveMp();
+    AdaptiveMp(bool parallel = false);
 
     //=========================================================================================================
     /**
@@ -132,6 +134,7 @@ public:
     typedef Eigen::MatrixXd MatrixXd;
 
     bool fix_phase;
+    bool parallel;
     qreal signal_energy;
     qreal current_energy;
     qreal epsilon;
@@ -173,7 +176,7 @@ public:
     *
     * @return complex modulationvector
     */
-    VectorXcd modulation_function(qint32 N, qreal k);
+    static VectorXcd modulation_function(qint32 N, qreal k);
 
     //=========================================================================================================
     /**
@@ -193,7 +196,7 @@ public:
     *
     * @return depending on returnValue returning the real atom calculated or the manipulated parameters: scale, translation, modulation, phase, scalarproduct
     */
-    static VectorXd calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, MatrixXd residuum, ReturnValue return_value, bool fix_phase);
+    static VectorXd calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, const MatrixXd &residuum, ReturnValue return_value, bool fix_phase);
 
     //=========================================================================================================
     /**
@@ -217,7 +220,7 @@ public:
     * @return depending on returnValue returning the real atom calculated or the manipulated parameters: scale, translation, modulation, phase, scalarproduct
     */
     void simplex_maximisation(qint32 simplex_it, qreal simplex_reflection, qreal simplex_expansion, qreal simplex_contraction, qreal simplex_full_contraction,
-                              GaborAtom *gabor_Atom, VectorXd max_scalar_product, qint32 sample_count, bool fix_phase, MatrixXd residuum, bool trial_separation, qint32 chn);
+                              GaborAtom *gabor_Atom, const VectorXd &max_scalar_product, qint32 sample_count, bool fix_phase, const MatrixXd &residuum, bool trial_separation, qint32 chn);
 
     //=========================================================================================================
 
@@ -240,6 +243,100 @@ signals:
 
     void send_warning(qint32 warning);
 
+private:
+
+    /**
+    * Candidate search of a range of channels for one scale
+    */
+    struct SearchChunk
+    {
+        const MatrixXd *residuum;
+        const VectorXd *residuum_sum;       /**< sum of all channels, only set for fix phase */
+        const VectorXcd *fft_envelope;      /**< NULL for atoms without envelope */
+        const QVector<qreal> *modulations;
+        MatrixXd *candidates;
+        qint32 sample_count;
+        qreal scale;
+        bool fix_phase;
+        qint32 first_channel;
+        qint32 last_channel;
+    };
+
+    //=========================================================================================================
+    /**
+    * adaptiveMP_search_candidates
+    *
+    * finds the best matching translation for every modulation of one scale in every channel and calculates the
+    * parameters of the resulting atoms, distributed over the channels if parallel is set
+    *
+    * @param[in] residuum       the signalresiduum of the current MP Algorithm iterationstep
+    * @param[in] fft_envelope   spectrum of the gaussian envelope of the scale centered in the signal, NULL for
+    *                           atoms without envelope (scale == sample_count, translation in the middle)
+    * @param[in] modulations    modulations to search
+    * @param[in] scale          scale of the atoms
+    * @param[in] channel_count  number of channels to search
+    * @param[in] fix_phase      whether fix phase or varying
+    *
+    * @return atom parameters scale, translation, modulation, phase, scalarproduct in the column
+    *         chn * modulations.size() + modulation index
+    */
+    MatrixXd search_candidates(const MatrixXd &residuum, const VectorXcd *fft_envelope, const QVector<qreal> &modulations, qreal scale,
+                               qint32 channel_count, bool fix_phase) const;
+
+    //=========================================================================================================
+    /**
+    * adaptiveMP_search_chunk
+    *
+    * runs the candidate search of one chunk of channels
+    *
+    * @param[in] chunk      the chunk to process
+    *
+    * @return true when done
+    */
+    static bool search_chunk(const SearchChunk &chunk);
+
+    //=========================================================================================================
+    /**
+    * adaptiveMP_search_envelope_chunk
+    *
+    * finds the translation of every modulation by correlation with the envelope and evaluates the atoms
+    *
+    * @param[in] chunk      the chunk to process
+    */
+    static void search_envelope_chunk(const SearchChunk &chunk);
+
+    //=========================================================================================================
+    /**
+    * adaptiveMP_search_no_envelope_chunk
+    *
+    * evaluates the atoms without envelope of all modulations with one DFT per channel
+    *
+    * @param[in] chunk      the chunk to process
+    */
+    static void search_no_envelope_chunk(const SearchChunk &chunk);
+
+    //=========================================================================================================
+    /**
+    * adaptiveMP_atom_parameters
+    *
+    * calculates the parameters calculate_atom returns from the inner products of the residuum with the enveloped
+    * cosine and sine of the modulation
+    *
+    * @param[in] scale              scale of atom
+    * @param[in] translation        translation of atom
+    * @param[in] modulation         modulation of atom
+    * @param[in] phase_cos_product  cosine inner product the phase is taken from
+    * @param[in] phase_sin_product  sine inner product the phase is taken from
+    * @param[in] cos_product        cosine inner product of the channel
+    * @param[in] sin_product        sine inner product of the channel
+    * @param[in] cos_cos            energy of the enveloped cosine
+    * @param[in] cos_sin            inner product of the enveloped cosine and sine
+    * @param[in] sin_sin            energy of the enveloped sine
+    *
+    * @return scale, translation, modulation, phase, scalarproduct
+    */
+    static VectorXd atom_parameters(qreal scale, qint32 translation, qreal modulation, qreal phase_cos_product, qreal phase_sin_product,
+                                    qreal cos_product, qreal sin_product, qreal cos_cos, qreal cos_sin, qreal sin_sin);
 };
 
 }   // NAMESPACE
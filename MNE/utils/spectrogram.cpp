@@ -50,6 +50,15 @@
 #include <unsupported/Eigen/FFT>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QtConcurrent>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -78,35 +87,89 @@ VectorXd Spectrogram::gauss_window (qint32 sample_count, qreal scale, quint32 tr
 
 //-----------------------------------------------------------------------------------------------------------------
 
-MatrixXd Spectrogram::make_spectrogram(VectorXd signal, qint32 window_size = 0)
+MatrixXd Spectrogram::make_spectrogram(const VectorXd &signal, qint32 window_size, qint32 hop_size, qint32 fft_length)
 {
+    qint32 sample_count = signal.rows();
+
     if(window_size == 0)
-        window_size = signal.rows()/4;
+        window_size = sample_count/4;
+    if(hop_size < 1)
+        hop_size = 1;
+    if(fft_length == 0)
+        fft_length = sample_count;
 
-    Eigen::FFT<double> fft;
-    MatrixXd tf_matrix = MatrixXd::Zero(signal.rows()/2, signal.rows());
+    qint32 frame_count = (sample_count + hop_size - 1) / hop_size;
+    MatrixXd tf_matrix = MatrixXd::Zero(fft_length/2, frame_count);
+
+    if(sample_count == 0 || window_size <= 0 || fft_length < 2)
+        return tf_matrix;
+
+    //the window is shift invariant, compute it once and cut it off where exp(-3.14*t^2) drops below 1e-8
+    qint32 half_length = qMin(qint32(ceil(2.5 * window_size)), sample_count - 1);
+    VectorXd window = gauss_window(2 * half_length + 1, window_size, half_length);
+
+    //every chunk creates its own FFT plan, so use no more chunks than threads
+    qint32 chunk_count = qMax(1, qMin(frame_count, QThread::idealThreadCount()));
 
-    for(qint32 translate = 0; translate < signal.rows(); translate++)
+    QList<FrameChunk> chunks;
+    for(qint32 i = 0; i < chunk_count; i++)
     {
-        VectorXd envelope = gauss_window(signal.rows(), window_size, translate);
+        FrameChunk chunk;
+        chunk.signal = &signal;
+        chunk.window = &window;
+        chunk.tf_matrix = &tf_matrix;
+        chunk.hop_size = hop_size;
+        chunk.fft_length = fft_length;
+        chunk.first_frame = i * frame_count / chunk_count;
+        chunk.last_frame = (i + 1) * frame_count / chunk_count;
+        chunks.append(chunk);
+    }
 
-        VectorXd windowed_sig = VectorXd::Zero(signal.rows());
-        VectorXcd fft_win_sig = VectorXcd::Zero(signal.rows());
+    if(chunks.size() == 1)
+        compute_frames(chunks[0]);
+    else
+        QtConcurrent::blockingMapped(chunks, &Spectrogram::compute_frames);
 
-        VectorXd real_coeffs = VectorXd::Zero(signal.rows()/2);
+    return tf_matrix;
+}
 
-        for(qint32 sample = 0; sample < signal.rows(); sample++)
-            windowed_sig[sample] = signal[sample] * envelope[sample];
+//-----------------------------------------------------------------------------------------------------------------
 
-        fft.fwd(fft_win_sig, windowed_sig);
+bool Spectrogram::compute_frames(const FrameChunk &chunk)
+{
+    const VectorXd &signal = *chunk.signal;
+    const VectorXd &window = *chunk.window;
+    qint32 sample_count = signal.rows();
+    qint32 half_length = (window.rows() - 1) / 2;
 
-        for(qint32 i= 0; i<signal.rows()/2; i++)
+    //the input is real, so only the first half of the spectrum is needed
+    Eigen::FFT<double> fft;
+    fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+
+    VectorXd windowed_sig = VectorXd::Zero(chunk.fft_length);
+    VectorXcd fft_win_sig;
+
+    for(qint32 frame = chunk.first_frame; frame < chunk.last_frame; frame++)
+    {
+        qint32 translate = frame * chunk.hop_size;
+        qint32 first = qMax(0, translate - half_length);
+        qint32 last = qMin(sample_count, translate + half_length + 1);
+
+        //keep the part of the window around its center which fits into one FFT
+        if(last - first > chunk.fft_length)
         {
-            qreal value = pow(abs(fft_win_sig[i]), 2.0);
-            real_coeffs[i] = value;
+            first = qMax(first, translate - chunk.fft_length/2);
+            last = qMin(last, first + chunk.fft_length);
         }
 
-        tf_matrix.col(translate) = real_coeffs;
+        //the power spectrum does not depend on where the windowed segment lies in the FFT buffer
+        windowed_sig.setZero();
+        windowed_sig.head(last - first) = signal.segment(first, last - first).cwiseProduct(window.segment(first - translate + half_length, last - first));
+
+        fft.fwd(fft_win_sig, windowed_sig);
+
+        chunk.tf_matrix->col(frame) = fft_win_sig.head(chunk.fft_length/2).cwiseAbs2();
     }
-    return tf_matrix;
+
+    return true;
 }
@@ -78,14 +78,46 @@ public:
     *
     * calculates the spectrogram (tf-representation) of a given signal
     *
+    * The gaussean window is placed at every hop_size-th sample, its negligible tails are cut off and the frames
+    * are transformed with real-to-complex FFTs in parallel. With a hop size of 1 and the signal length as FFT
+    * length the result equals the sample by sample spectrogram.
+    *
     * @param[in] signal         input-signal to calculate spectrogram of
-    * @param[in] window_size    size of the window which is used (resolution in time an frequency is depending on it)
+    * @param[in] window_size    size of the window which is used (resolution in time an frequency is depending on it), 0 uses a quarter of the signal length
+    * @param[in] hop_size       number of samples between two frames (resolution in time)
+    * @param[in] fft_length     number of FFT points per frame (resolution in frequency), 0 uses the signal length
     *
-    * @return spectrogram-matrix (tf-representation of the input signal)
+    * @return spectrogram-matrix (tf-representation of the input signal) with fft_length/2 rows and one column per frame
     */
-    static MatrixXd make_spectrogram(VectorXd signal, qint32 window_size);
+    static MatrixXd make_spectrogram(const VectorXd &signal, qint32 window_size = 0, qint32 hop_size = 1, qint32 fft_length = 0);
 
 private:
+    //=========================================================================================================
+    /**
+    * Frames of the spectrogram which are computed by one thread.
+    */
+    struct FrameChunk
+    {
+        const VectorXd *signal;
+        const VectorXd *window;         /**< precomputed window centered at its middle sample */
+        MatrixXd *tf_matrix;
+        qint32 hop_size;
+        qint32 fft_length;
+        qint32 first_frame;
+        qint32 last_frame;
+    };
+
+    //=========================================================================================================
+    /**
+    * Spectrogram_compute_frames
+    *
+    * windows and transforms the frames of one chunk and stores their power spectra
+    *
+    * @param[in] chunk      the chunk to process
+    *
+    * @return true when done
+    */
+    static bool compute_frames(const FrameChunk &chunk);
 
     //=========================================================================================================
     /**
@@ -1932,7 +1932,7 @@ void MainWindow::calc_thread_finished()
 
 void MainWindow::calc_adaptiv_mp(MatrixXd signal, truncation_criterion criterion)
 {
-    adaptive_Mp = new AdaptiveMp();
+    adaptive_Mp = new AdaptiveMp(true);
     qreal res_energy = ui->dsb_energy->value();
 
     //threading
@@ -3290,7 +3290,9 @@ void MainWindow::on_actionTFplot_triggered()
             }
         }
         */
-        tf_sum = Spectrogram::make_spectrogram(_signal_matrix.col(0), 0);
+        //one frame per pixel column of the plot is enough, more samples than pixels are not visible anyway
+        qint32 hop_size = qMax(1, qint32(_signal_matrix.rows() / qMax(1, ui->tabWidget->width())));
+        tf_sum = Spectrogram::make_spectrogram(_signal_matrix.col(0), 0, hop_size);
 
         TFplot *tfplot = new TFplot(tf_sum, _sample_rate, 0, 600, Jet);
         ui->tabWidget->addTab(tfplot, "TF-Overview 0-500Hz");
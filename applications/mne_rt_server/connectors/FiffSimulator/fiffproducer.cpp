@@ -138,9 +138,8 @@ void FiffProducer::run()
 //    for(qint32 i = 0; i < nchan; ++i)
 //        inv_calsMat.insert(i, i) = 1.0f/m_pFiffSimulator->m_RawInfo.info.chs[i].cal;
 
-    //Not good cause production time is not accurate
-    //loading and thread sleep is longer than thread sleep time - better to have a extra loading thread
-    // ToDo restructure this producer as laoding buffer --> and thread sleep to simulator buffer
+    //The producer only reads ahead, pacing is done by the simulator with absolute deadlines.
+    //The raw matrix buffer holds the prefetched buffers, push blocks as soon as it is full.
     fiff_int_t t_iDiff;
     bool t_bRestart = false;
 
@@ -78,6 +78,7 @@
 #include <QFile>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 
 
 //*************************************************************************************************************
@@ -99,6 +100,9 @@ const QString FiffSimulator::Commands::GETBUFSIZE   = "getbufsize";
 const QString FiffSimulator::Commands::ACCEL        = "accel";
 const QString FiffSimulator::Commands::GETACCEL     = "getaccel";
 const QString FiffSimulator::Commands::SIMFILE      = "simfile";
+const QString FiffSimulator::Commands::PACING       = "pacing";
+const QString FiffSimulator::Commands::PREFETCH     = "prefetch";
+const QString FiffSimulator::Commands::GETSTATS     = "getstats";
 
 
 //*************************************************************************************************************
@@ -112,6 +116,12 @@ FiffSimulator::FiffSimulator()
 , m_uiBufferSampleSize(100)//(4)
 , m_AccelerationFactor(1.0)
 , m_TrueSamplingRate(0.0)
+, m_pacingMode(CatchUp)
+, m_iPrefetchSize(RAW_BUFFFER_SIZE)
+, m_uiSentBuffers(0)
+, m_uiLateBuffers(0)
+, m_uiSkippedBuffers(0)
+, m_iElapsedNs(0)
 , m_pRawMatrixBuffer(NULL)
 , m_bIsRunning(false)
 {
@@ -285,6 +295,113 @@ void FiffSimulator::comSimfile(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffSimulator::comPacing(Command p_command)
+{
+    QString t_sMode = p_command.pValues()[0].toString().toLower();
+
+    PacingMode t_pacingMode;
+    if(t_sMode == "catchup")
+        t_pacingMode = CatchUp;
+    else if(t_sMode == "skip")
+        t_pacingMode = Skip;
+    else if(t_sMode == "maxspeed")
+        t_pacingMode = MaxSpeed;
+    else
+    {
+        m_commandManager[Commands::PACING].reply("Pacing mode not set, use catchup, skip or maxspeed\r\n");
+        return;
+    }
+
+    bool t_bWasRunning = m_bIsRunning;
+
+    if(m_bIsRunning)
+    {
+        m_pFiffProducer->stop();
+        this->stop();
+    }
+
+    m_pacingMode = t_pacingMode;
+
+    if(t_bWasRunning)
+        this->start();
+
+    QString str = QString("\tSet pacing mode to %1\r\n\n").arg(t_sMode);
+
+    m_commandManager[Commands::PACING].reply(str);
+}
+
+
+//*************************************************************************************************************
+
+void FiffSimulator::comPrefetch(Command p_command)
+{
+    qint32 t_iPrefetchSize = p_command.pValues()[0].toInt();
+
+    if(t_iPrefetchSize > 0)
+    {
+        bool t_bWasRunning = m_bIsRunning;
+
+        if(m_bIsRunning)
+        {
+            m_pFiffProducer->stop();
+            this->stop();
+        }
+
+        m_iPrefetchSize = t_iPrefetchSize;
+
+        if(t_bWasRunning)
+            this->start();
+
+        QString str = QString("\tSet prefetch size to %1 buffers\r\n\n").arg(t_iPrefetchSize);
+
+        m_commandManager[Commands::PREFETCH].reply(str);
+    }
+    else
+        m_commandManager[Commands::PREFETCH].reply("Prefetch size not set\r\n");
+}
+
+
+//*************************************************************************************************************
+
+void FiffSimulator::comGetStats(Command p_command)
+{
+    m_qMutexStats.lock();
+    quint64 t_uiSentBuffers = m_uiSentBuffers;
+    quint64 t_uiLateBuffers = m_uiLateBuffers;
+    quint64 t_uiSkippedBuffers = m_uiSkippedBuffers;
+    qint64 t_iElapsedNs = m_iElapsedNs;
+    m_qMutexStats.unlock();
+
+    //The first buffer is sent at time zero
+    double t_dAchievedRate = t_iElapsedNs > 0 && t_uiSentBuffers > 1 ? (double)((t_uiSentBuffers-1)*m_uiBufferSampleSize) / ((double)t_iElapsedNs * 1.0e-9) : 0.0;
+
+    bool t_bCommandIsJson = p_command.isJson();
+    if(t_bCommandIsJson)
+    {
+        //
+        //create JSON help object
+        //
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert("sent", QJsonValue((double)t_uiSentBuffers));
+        t_qJsonObjectRoot.insert("late", QJsonValue((double)t_uiLateBuffers));
+        t_qJsonObjectRoot.insert("skipped", QJsonValue((double)t_uiSkippedBuffers));
+        t_qJsonObjectRoot.insert("rate", QJsonValue(t_dAchievedRate));
+        t_qJsonObjectRoot.insert("sfreq", QJsonValue((double)m_RawInfo.info.sfreq));
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        m_commandManager[Commands::GETSTATS].reply(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        QString str = QString("\tsent buffers: %1\r\n\tlate buffers: %2\r\n\tskipped buffers: %3\r\n\tachieved rate: %4 Hz (requested %5 Hz)\r\n\n")
+                .arg(t_uiSentBuffers).arg(t_uiLateBuffers).arg(t_uiSkippedBuffers).arg(t_dAchievedRate, 0, 'f', 2).arg(m_RawInfo.info.sfreq, 0, 'f', 2);
+        m_commandManager[Commands::GETSTATS].reply(str);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void FiffSimulator::connectCommandManager()
@@ -295,6 +412,9 @@ void FiffSimulator::connectCommandManager()
     QObject::connect(&m_commandManager[Commands::ACCEL], &Command::executed, this, &FiffSimulator::comAccel);
     QObject::connect(&m_commandManager[Commands::GETACCEL], &Command::executed, this, &FiffSimulator::comGetAccel);
     QObject::connect(&m_commandManager[Commands::SIMFILE], &Command::executed, this, &FiffSimulator::comSimfile);
+    QObject::connect(&m_commandManager[Commands::PACING], &Command::executed, this, &FiffSimulator::comPacing);
+    QObject::connect(&m_commandManager[Commands::PREFETCH], &Command::executed, this, &FiffSimulator::comPrefetch);
+    QObject::connect(&m_commandManager[Commands::GETSTATS], &Command::executed, this, &FiffSimulator::comGetStats);
 }
 
 
@@ -353,7 +473,7 @@ void FiffSimulator::init()
     m_pRawMatrixBuffer = NULL;
 
     if(!m_RawInfo.isEmpty())
-        m_pRawMatrixBuffer = new RawMatrixBuffer(RAW_BUFFFER_SIZE, m_RawInfo.info.nchan, this->m_uiBufferSampleSize);
+        m_pRawMatrixBuffer = new RawMatrixBuffer(m_iPrefetchSize, m_RawInfo.info.nchan, this->m_uiBufferSampleSize);
 }
 
 
@@ -505,7 +625,7 @@ bool FiffSimulator::readRawInfo()
         //
         if(m_pRawMatrixBuffer)
             delete m_pRawMatrixBuffer;
-        m_pRawMatrixBuffer = new RawMatrixBuffer(10, m_RawInfo.info.nchan, m_uiBufferSampleSize);
+        m_pRawMatrixBuffer = new RawMatrixBuffer(m_iPrefetchSize, m_RawInfo.info.nchan, m_uiBufferSampleSize);
 
         mutex.unlock();
     }
@@ -514,6 +634,24 @@ bool FiffSimulator::readRawInfo()
 }
 
 
+//*************************************************************************************************************
+
+void FiffSimulator::waitForConsumers()
+{
+    while(m_bIsRunning)
+    {
+        for(qint32 i = m_qListInFlight.size()-1; i >= 0; --i)
+            if(m_qListInFlight[i].isNull())
+                m_qListInFlight.removeAt(i);
+
+        if(m_qListInFlight.size() < m_iPrefetchSize)
+            return;
+
+        usleep(100);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void FiffSimulator::run()
@@ -523,17 +661,66 @@ void FiffSimulator::run()
     float t_fSamplingFrequency = m_RawInfo.info.sfreq;
     float t_fBuffSampleSize = (float)m_uiBufferSampleSize;
 
-    quint32 uiSamplePeriod = (unsigned int) ((t_fBuffSampleSize/t_fSamplingFrequency)*1000000.0f);
+    //Absolute deadlines on the monotonic clock, so processing and socket time do not accumulate as drift
+    qint64 t_iSamplePeriodNs = (qint64)(((double)t_fBuffSampleSize/(double)t_fSamplingFrequency)*1.0e9);
+    qint64 t_iDeadlineNs = 0;
+
+    m_qMutexStats.lock();
+    m_uiSentBuffers = 0;
+    m_uiLateBuffers = 0;
+    m_uiSkippedBuffers = 0;
+    m_iElapsedNs = 0;
+    m_qMutexStats.unlock();
+
+    m_qListInFlight.clear();
 
-//    quint32 count = 0;
+    QElapsedTimer t_timer;
 
     while(m_bIsRunning)
     {
         QSharedPointer<Eigen::MatrixXf> t_pRawBuffer(new Eigen::MatrixXf(m_pRawMatrixBuffer->pop()));
-//        ++count;
-//        printf("%d raw buffer (%d x %d) generated\r\n", count, t_pRawBuffer->rows(), t_pRawBuffer->cols());
+
+        //The schedule starts with the first buffer the producer delivered
+        if(!t_timer.isValid())
+            t_timer.start();
+
+        if(m_pacingMode == MaxSpeed)
+        {
+            waitForConsumers();
+            m_qListInFlight.append(t_pRawBuffer.toWeakRef());
+        }
+        else
+        {
+            qint64 t_iNowNs = t_timer.nsecsElapsed();
+
+            if(t_iNowNs < t_iDeadlineNs)
+            {
+                usleep((unsigned long)((t_iDeadlineNs - t_iNowNs)/1000));
+            }
+            else if(t_iNowNs - t_iDeadlineNs >= t_iSamplePeriodNs)
+            {
+                //Missed the slot by at least one period
+                m_qMutexStats.lock();
+                ++m_uiLateBuffers;
+                if(m_pacingMode == Skip)
+                    ++m_uiSkippedBuffers;
+                m_qMutexStats.unlock();
+
+                if(m_pacingMode == Skip)
+                {
+                    t_iDeadlineNs += t_iSamplePeriodNs;
+                    continue;
+                }
+            }
+
+            t_iDeadlineNs += t_iSamplePeriodNs;
+        }
 
         emit remitRawBuffer(t_pRawBuffer);
-        usleep(uiSamplePeriod);
+
+        m_qMutexStats.lock();
+        ++m_uiSentBuffers;
+        m_iElapsedNs = t_timer.nsecsElapsed();
+        m_qMutexStats.unlock();
     }
 }
@@ -61,6 +61,8 @@
 
 #include <QString>
 #include <QMutex>
+#include <QList>
+#include <QWeakPointer>
 
 
 //*************************************************************************************************************
@@ -111,6 +113,18 @@ public:
         static const QString ACCEL;
         static const QString GETACCEL;
         static const QString SIMFILE;
+        static const QString PACING;
+        static const QString PREFETCH;
+        static const QString GETSTATS;
+    };
+
+    /**
+    * How buffers are paced when they are sent.
+    */
+    enum PacingMode {
+        CatchUp,    /**< Absolute deadlines, late buffers are sent back to back until the schedule is met again. */
+        Skip,       /**< Absolute deadlines, buffers which missed their slot by a full period are dropped. */
+        MaxSpeed    /**< No deadlines, buffers are sent as fast as the slowest client consumes them. */
     };
 
     //=========================================================================================================
@@ -183,6 +197,30 @@ private:
     */
     void comSimfile(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Sets the pacing mode (catchup, skip or maxspeed)
+    *
+    * @param[in] p_command  The pacing mode command.
+    */
+    void comPacing(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of buffers which are read ahead by the producer
+    *
+    * @param[in] p_command  The prefetch command.
+    */
+    void comPrefetch(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Returns the pacing statistics (sent, late and skipped buffers and the achieved sampling rate)
+    *
+    * @param[in] p_command  The statistics command.
+    */
+    void comGetStats(Command p_command);
+
     //////////
 
     //=========================================================================================================
@@ -193,7 +231,16 @@ private:
 
     bool readRawInfo();
 
+    //=========================================================================================================
+    /**
+    * Waits until the number of emitted buffers which are still in use drops below the prefetch size. The
+    * server keeps a buffer alive until every client handed the corresponding raw block to its socket (or
+    * dropped it), so the max speed mode replays as fast as the slowest client consumes.
+    */
+    void waitForConsumers();
+
     QMutex mutex;
+    QMutex m_qMutexStats;                   /**< Guards the pacing statistics.*/
 
     FiffProducer*   m_pFiffProducer;        /**< Holds the DataProducer.*/
     FiffRawData     m_RawInfo;              /**< Holds the fiff raw measurement information. */
@@ -201,6 +248,15 @@ private:
     quint32         m_uiBufferSampleSize;   /**< Sample size of the buffer */
     float           m_AccelerationFactor;   /**< Acceleration factor to simulate different sampling rates. */
     float           m_TrueSamplingRate;     /**< The true sampling rate of the fif file. */
+    PacingMode      m_pacingMode;           /**< The pacing mode. */
+    qint32          m_iPrefetchSize;        /**< Number of buffers which are read ahead by the producer. */
+
+    quint64         m_uiSentBuffers;        /**< Number of buffers sent since the last start. */
+    quint64         m_uiLateBuffers;        /**< Number of buffers which missed their deadline by at least one period. */
+    quint64         m_uiSkippedBuffers;     /**< Number of buffers dropped in skip mode. */
+    qint64          m_iElapsedNs;           /**< Time since the last start in ns, updated with every sent buffer. */
+
+    QList<QWeakPointer<Eigen::MatrixXf> > m_qListInFlight;  /**< Emitted buffers which are possibly not yet consumed by all clients. */
 
     RawMatrixBuffer* m_pRawMatrixBuffer;    /**< The Circular Raw Matrix Buffer. */
 
@@ -44,6 +44,15 @@
 #include "mne_rt_server.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// Fiff INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_constants.h>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // STL INCLUDES
@@ -69,6 +78,8 @@ using namespace FIFFLIB;
 FiffStreamServer::FiffStreamServer(QObject *parent)
 : QTcpServer(parent)
 , m_iNextClientId(0)
+, m_iClientQueueSize(100)
+, m_iSlowClientPolicy(DropOldest)
 {
 
 }
@@ -88,11 +99,11 @@ void FiffStreamServer::comClist(Command p_command)
 {
     //ToDo JSON
     QString t_sOutput("");
-    t_sOutput.append("\tID\tAlias\r\n");
+    t_sOutput.append("\tID\tAlias\tQueue\tDropped\r\n");
     QMap<qint32, FiffStreamThread*>::iterator i;
     for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
     {
-        QString str = QString("\t%1\t%2\r\n").arg(i.key()).arg(i.value()->getAlias());
+        QString str = QString("\t%1\t%2\t%3\t%4\r\n").arg(i.key()).arg(i.value()->getAlias()).arg(i.value()->getQueueDepth()).arg(i.value()->getDroppedBlocks());
         t_sOutput.append(str);
     }
     t_sOutput.append("\n");
@@ -173,6 +184,45 @@ void FiffStreamServer::comStopAll(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffStreamServer::comClientQueue(Command p_command)
+{
+    qint32 t_iQueueSize = p_command.pValues()[0].toInt();
+
+    QString str;
+    if(t_iQueueSize > 0)
+    {
+        m_iClientQueueSize.storeRelease(t_iQueueSize);
+        str = QString("\tSet client queue size to %1 raw blocks\r\n\n").arg(t_iQueueSize);
+    }
+    else
+        str = QString("\tClient queue size not set\r\n\n");
+
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["clientqueue"].reply(str);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::comSlowClient(Command p_command)
+{
+    QString t_sPolicy = p_command.pValues()[0].toString().toLower();
+
+    QString str = QString("\tSet slow client policy to %1\r\n\n").arg(t_sPolicy);
+    if(t_sPolicy == "drop")
+        m_iSlowClientPolicy.storeRelease(DropOldest);
+    else if(t_sPolicy == "disconnect")
+        m_iSlowClientPolicy.storeRelease(Disconnect);
+    else if(t_sPolicy == "block")
+        m_iSlowClientPolicy.storeRelease(Block);
+    else
+        str = QString("\tSlow client policy not set, use drop, disconnect or block\r\n\n");
+
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["slowclient"].reply(str);
+}
+
+
 //*************************************************************************************************************
 
 void FiffStreamServer::connectCommands()
@@ -185,6 +235,8 @@ void FiffStreamServer::connectCommands()
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &FiffStreamServer::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop"], &Command::executed, this, &FiffStreamServer::comStop);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &FiffStreamServer::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["clientqueue"], &Command::executed, this, &FiffStreamServer::comClientQueue);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["slowclient"], &Command::executed, this, &FiffStreamServer::comSlowClient);
 
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("clist"), this, &FiffStreamServer::comClist);
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("measinfo"), this, &FiffStreamServer::comMeasinfo);
@@ -373,10 +425,18 @@ void FiffStreamServer::forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo)
 
 
 //*************************************************************************************************************
-//ToDo increase preformance --> try inline
+
 void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
 {
-    emit remitRawBuffer(m_pMatRawData);
+    //Serialise the buffer once, the resulting block is implicitly shared by all clients. The buffer itself is
+    //handed on as well, it stays alive until every client wrote the block, which lets the connector pace on it.
+    QByteArray t_qRawBlock;
+    {
+        FiffStream t_FiffStreamOut(&t_qRawBlock, QIODevice::WriteOnly);
+        t_FiffStreamOut.write_float(FIFF_DATA_BUFFER,m_pMatRawData->data(),m_pMatRawData->rows()*m_pMatRawData->cols());
+    }
+
+    emit remitRawBlock(t_qRawBlock, m_pMatRawData);
 }
 
 
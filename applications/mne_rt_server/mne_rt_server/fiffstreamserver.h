@@ -52,6 +52,7 @@
 
 #include <QStringList>
 #include <QTcpServer>
+#include <QAtomicInt>
 
 
 //*************************************************************************************************************
@@ -91,6 +92,14 @@ class FiffStreamServer : public QTcpServer//, public ICommandParser //OLD remove
     friend class FiffStreamThread;
 
 public:
+    /**
+    * What happens to a client which does not keep up with the raw data stream.
+    */
+    enum SlowClientPolicy {
+        DropOldest,     /**< The oldest queued raw block of the client is dropped. */
+        Disconnect,     /**< The client is disconnected. */
+        Block           /**< No block is dropped. Queued blocks keep the buffer of the connector alive, which throttles a connector pacing on its buffers. Disconnects at twice the queue size. */
+    };
 
     FiffStreamServer(QObject *parent = 0);
 
@@ -132,7 +141,7 @@ signals:
     void stopMeasFiffStreamClient(qint32 ID);
 
     void remitMeasInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
-    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>);
+    void remitRawBlock(const QByteArray& p_qRawBlock, QSharedPointer<Eigen::MatrixXf> p_pRawBuffer);
 
     void closeFiffStreamServer();
 
@@ -181,10 +190,28 @@ private:
     */
     void comStopAll(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Sets the maximal number of raw blocks which are queued per client
+    *
+    * @param[in] p_command  The client queue size command.
+    */
+    void comClientQueue(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Sets the policy for clients which do not keep up (drop, disconnect or block)
+    *
+    * @param[in] p_command  The slow client policy command.
+    */
+    void comSlowClient(Command p_command);
+
     QByteArray parseToId(QString& p_sRawId, qint32& p_iParsedId);
 
     QMap<qint32, FiffStreamThread*> m_qClientList;
     qint32                          m_iNextClientId;
+    QAtomicInt                      m_iClientQueueSize;     /**< Maximal number of queued raw blocks per client. */
+    QAtomicInt                      m_iSlowClientPolicy;    /**< Policy for clients with a full queue, a SlowClientPolicy. */
 
 };
 
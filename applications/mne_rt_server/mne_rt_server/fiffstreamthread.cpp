@@ -82,6 +82,7 @@ FiffStreamThread::FiffStreamThread(qint32 id, int socketDescriptor, QObject *par
 , m_iDataClientId(id)
 , m_sDataClientAlias(QString(""))
 , m_iSocketDescriptor(socketDescriptor)
+, m_uiDroppedBlocks(0)
 , m_bIsSendingRawBuffer(false)
 , m_bIsRunning(false)
 {
@@ -112,7 +113,7 @@ void FiffStreamThread::startMeas(qint32 ID)
 
         m_qMutex.lock();
         // ToDo send start meas
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly | QIODevice::Append);
         t_FiffStreamOut.start_block(FIFFB_RAW_DATA);
         m_bIsSendingRawBuffer = true;
         m_qMutex.unlock();
@@ -130,7 +131,12 @@ void FiffStreamThread::stopMeas(qint32 ID)
         qDebug() << "stop raw buffer sending.";
 
         m_qMutex.lock();
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        //Raw blocks which are still queued have to precede the end of the raw data block
+        while(!m_qQueueRawBlocks.isEmpty())
+            m_qSendBlock.append(m_qQueueRawBlocks.dequeue().qBlock);
+
+        //Append, a plain write only device would start at the front and overwrite the pending data
+        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly | QIODevice::Append);
         t_FiffStreamOut.end_block(FIFFB_RAW_DATA);
         m_bIsSendingRawBuffer = false;
         m_qMutex.unlock();
@@ -178,24 +184,69 @@ void FiffStreamThread::parseCommand(FiffTag::SPtr p_pTag)
 
 //*************************************************************************************************************
 
-void FiffStreamThread::sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
+void FiffStreamThread::sendRawBlock(const QByteArray& p_qRawBlock, QSharedPointer<Eigen::MatrixXf> p_pRawBuffer)
 {
+    FiffStreamServer* t_pParentServer = qobject_cast<FiffStreamServer*>(this->parent());
+    if(!t_pParentServer)
+        return;
+
+    m_qMutex.lock();
+
     if(m_bIsSendingRawBuffer)
     {
-//        qDebug() << "Send RawBuffer to client";
+        //Apply the slow client policy if the queue is full. This slot runs in the thread of the server,
+        //so it must never wait for the client. With Block the back pressure is applied through the queued
+        //connector buffers instead, only a connector which ignores it runs into the hard limit.
+        qint32 t_iPolicy = t_pParentServer->m_iSlowClientPolicy.loadAcquire();
+        qint32 t_iQueueSize = t_pParentServer->m_iClientQueueSize.loadAcquire();
+        if(t_iPolicy == FiffStreamServer::Block)
+            t_iQueueSize *= 2;
+
+        while(m_bIsRunning && m_qQueueRawBlocks.size() >= t_iQueueSize)
+        {
+            if(t_iPolicy == FiffStreamServer::DropOldest)
+            {
+                m_qQueueRawBlocks.dequeue();
+                ++m_uiDroppedBlocks;
+            }
+            else
+            {
+                printf("FiffStreamClient (ID %d): too slow, disconnecting\r\n\n", m_iDataClientId);
+                m_uiDroppedBlocks += m_qQueueRawBlocks.size() + 1;
+                m_qQueueRawBlocks.clear();
+                m_bIsRunning = false;
+            }
+        }
 
-        m_qMutex.lock();
+        //The block is implicitly shared, no data is copied
+        if(m_bIsRunning)
+        {
+            RawBlock t_rawBlock;
+            t_rawBlock.qBlock = p_qRawBlock;
+            t_rawBlock.pBuffer = p_pRawBuffer;
+            m_qQueueRawBlocks.enqueue(t_rawBlock);
+        }
+    }
 
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
-        t_FiffStreamOut.write_float(FIFF_DATA_BUFFER,m_pMatRawData->data(),m_pMatRawData->rows()*m_pMatRawData->cols());
+    m_qMutex.unlock();
+}
 
-        m_qMutex.unlock();
 
-    }
-//    else
-//    {
-//        qDebug() << "Send RawBuffer is not activated";
-//    }
+//*************************************************************************************************************
+
+qint32 FiffStreamThread::getQueueDepth()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_qQueueRawBlocks.size();
+}
+
+
+//*************************************************************************************************************
+
+quint64 FiffStreamThread::getDroppedBlocks()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_uiDroppedBlocks;
 }
 
 
@@ -227,7 +278,7 @@ void FiffStreamThread::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo
     {
         m_qMutex.lock();
 
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly | QIODevice::Append);
 
 //        qint32 init_info[2];
 //        init_info[0] = FIFF_MNE_RT_CLIENT_ID;
@@ -249,7 +300,9 @@ void FiffStreamThread::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo
 
 void FiffStreamThread::writeClientId()
 {
-    FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+    QMutexLocker t_locker(&m_qMutex);
+
+    FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly | QIODevice::Append);
 
     t_FiffStreamOut.write_int(FIFF_MNE_RT_CLIENT_ID, &m_iDataClientId);
 }
@@ -302,8 +355,8 @@ void FiffStreamThread::run()
 
     connect(t_pParentServer, &FiffStreamServer::remitMeasInfo,
             this, &FiffStreamThread::sendMeasurementInfo);
-    connect(t_pParentServer, &FiffStreamServer::remitRawBuffer,
-            this, &FiffStreamThread::sendRawBuffer);
+    connect(t_pParentServer, &FiffStreamServer::remitRawBlock,
+            this, &FiffStreamThread::sendRawBlock);
     connect(t_pParentServer, &FiffStreamServer::startMeasFiffStreamClient,
             this, &FiffStreamThread::startMeas);
     connect(t_pParentServer, &FiffStreamServer::stopMeasFiffStreamClient,
@@ -331,26 +384,48 @@ void FiffStreamThread::run()
         // Write available data
         //
         m_qMutex.lock();
+        //Only hand raw blocks to the socket once it drained, otherwise its unbounded write buffer would take over the queue
+        bool t_bSocketDrained = t_qTcpSocket.bytesToWrite() == 0;
         qint32 t_iBlockSize = m_qSendBlock.size();
 //        qDebug() << "data available" << t_iBlockSize;
         if(t_iBlockSize > 0)
         {
             qint32 t_iBytesWritten = t_qTcpSocket.write(m_qSendBlock);
 //            qDebug() << ++i<< "[wrote bytes] " << t_iBytesWritten;
-            t_qTcpSocket.waitForBytesWritten();
             if(t_iBytesWritten == t_iBlockSize)
             {
                 m_qSendBlock.clear();
             }
-            else
+            else if(t_iBytesWritten > 0)
             {
                 //we have to store bytes which were not written to the socket, due to writing limit
                 //m_qSendBlock = m_qSendBlock.mid(t_iBytesWritten, t_iBlockSize-t_iBytesWritten);
                 m_qSendBlock.remove(0,t_iBytesWritten); //higher performance then mid
             }
         }
+        if(t_bSocketDrained && m_qSendBlock.isEmpty())
+        {
+            while(!m_qQueueRawBlocks.isEmpty())
+            {
+                const QByteArray &t_qBlock = m_qQueueRawBlocks.head().qBlock;
+                qint64 t_iBytesWritten = t_qTcpSocket.write(t_qBlock);
+                if(t_iBytesWritten < 0)
+                    break;
+
+                //Keep the remainder of a partially written block in front of everything else
+                if(t_iBytesWritten < t_qBlock.size())
+                    m_qSendBlock = t_qBlock.mid(t_iBytesWritten);
+                m_qQueueRawBlocks.dequeue();
+
+                if(!m_qSendBlock.isEmpty())
+                    break;
+            }
+        }
         m_qMutex.unlock();
 
+        if(t_qTcpSocket.bytesToWrite() > 0)
+            t_qTcpSocket.waitForBytesWritten();
+
         //
         // Read: Wait 10ms for incomming tag header, read and continue
         //
@@ -381,6 +456,12 @@ void FiffStreamThread::run()
         }
     }
 
+    //Stop queueing raw blocks for this client
+    m_qMutex.lock();
+    m_bIsRunning = false;
+    m_qQueueRawBlocks.clear();
+    m_qMutex.unlock();
+
     t_qTcpSocket.disconnectFromHost();
     if(t_qTcpSocket.state() != QAbstractSocket::UnconnectedState)
         t_qTcpSocket.waitForDisconnected();
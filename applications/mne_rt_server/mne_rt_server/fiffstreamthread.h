@@ -53,6 +53,8 @@
 #include <QThread>
 #include <QTcpSocket>
 #include <QMutex>
+#include <QQueue>
+#include <QByteArray>
 #include <QSharedPointer>
 
 
@@ -91,6 +93,18 @@ public:
 
     inline QString getAlias();
 
+    //=========================================================================================================
+    /**
+    * Returns the number of raw blocks which are queued for this client and not yet written to the socket.
+    */
+    qint32 getQueueDepth();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of raw blocks which were dropped for this client because its queue was full.
+    */
+    quint64 getDroppedBlocks();
+
 //    void deactivateRawBufferSending();
 
 
@@ -112,6 +126,19 @@ private:
     QMutex m_qMutex;
     QByteArray m_qSendBlock;
 
+    //=========================================================================================================
+    /**
+    * A queued raw block together with the connector buffer it was serialised from.
+    */
+    struct RawBlock
+    {
+        QByteArray qBlock;                      /**< Pre-serialised raw block, shared with all other clients. */
+        QSharedPointer<Eigen::MatrixXf> pBuffer;/**< Connector buffer, kept alive until the block left the queue. */
+    };
+
+    QQueue<RawBlock> m_qQueueRawBlocks;     /**< Raw blocks which are not yet handed to the socket. */
+    quint64 m_uiDroppedBlocks;              /**< Number of raw blocks dropped due to a full queue. */
+
     bool m_bIsSendingRawBuffer;
 
     bool m_bIsRunning;
@@ -122,7 +149,7 @@ private:
 
     void sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo);
 
-    void sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
+    void sendRawBlock(const QByteArray& p_qRawBlock, QSharedPointer<Eigen::MatrixXf> p_pRawBuffer);
     //void readToBuffer1();
 //    void readProc(QTcpSocket& p_qTcpSocket);
 };
@@ -320,6 +320,15 @@ void MNERTServer::init()
             "           \"description\": \"Prints and sends all available FiffStreamClients.\","
             "           \"parameters\": {}"
             "        },"
+            "       \"clientqueue\": {"
+            "           \"description\": \"Sets the maximal number of raw blocks which are queued per FiffStreamClient.\","
+            "           \"parameters\": {"
+            "               \"blocks\": {"
+            "                   \"description\": \"Number of raw blocks\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"close\": {"
             "           \"description\": \"Closes mne_rt_server.\","
             "           \"parameters\": {}"
@@ -350,6 +359,15 @@ void MNERTServer::init()
             "               }"
             "           }"
             "        },"
+            "       \"slowclient\": {"
+            "           \"description\": \"Sets what happens to FiffStreamClients with a full queue: drop (oldest block), disconnect or block (throttle the connector, disconnect at twice the queue size).\","
+            "           \"parameters\": {"
+            "               \"policy\": {"
+            "                   \"description\": \"drop/disconnect/block\","
+            "                   \"type\": \"QString\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"start\": {"
             "           \"description\": \"Adds specified FiffStreamClient to raw data buffer receivers. If acquisition is not already started, it is triggered.\","
             "           \"parameters\": {"
@@ -0,0 +1,186 @@
+//=============================================================================================================
+/**
+* @file     minmaxpyramid.cpp
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the MinMaxPyramid Class.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "minmaxpyramid.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCDISPLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MinMaxPyramid::MinMaxPyramid()
+: m_iRows(0)
+, m_iCols(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::resize(int iRows, int iCols)
+{
+    m_iRows = iRows;
+    m_iCols = iCols;
+
+    m_vecMin.clear();
+    m_vecMax.clear();
+
+    if(iRows <= 0 || iCols <= 0)
+        return;
+
+    //Halve the number of bins until a single bin covers the whole row
+    int iBins = (iCols + 1) / 2;
+
+    while(true) {
+        m_vecMin.append(MatrixXfR::Zero(iRows, iBins));
+        m_vecMax.append(MatrixXfR::Zero(iRows, iBins));
+
+        if(iBins <= 1)
+            break;
+
+        iBins = (iBins + 1) / 2;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::rebuild(const MatrixXdR& matData)
+{
+    if(matData.rows() != m_iRows || matData.cols() != m_iCols)
+        resize(matData.rows(), matData.cols());
+
+    update(matData, 0, m_iCols);
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::update(const MatrixXdR& matData, int iFirstCol, int iNumCols)
+{
+    if(matData.rows() != m_iRows || matData.cols() != m_iCols) {
+        //rebuild calls update with the full range once the sizes match
+        rebuild(matData);
+        return;
+    }
+
+    int iLastCol = qMin(iFirstCol + iNumCols, m_iCols);
+    iFirstCol = qMax(iFirstCol, 0);
+
+    if(m_vecMin.isEmpty() || iLastCol <= iFirstCol)
+        return;
+
+    //Level 0 - compute the touched bins from the samples
+    int iFirstBin = iFirstCol / 2;
+    int iLastBin = (iLastCol - 1) / 2;
+
+    for(int r = 0; r < m_iRows; ++r) {
+        const double* pData = matData.data() + r*m_iCols;
+        float* pMin = m_vecMin[0].data() + r*m_vecMin[0].cols();
+        float* pMax = m_vecMax[0].data() + r*m_vecMax[0].cols();
+
+        for(int k = iFirstBin; k <= iLastBin; ++k) {
+            int j = 2*k;
+            double dMin = pData[j];
+            double dMax = pData[j];
+
+            if(j + 1 < m_iCols) {
+                dMin = qMin(dMin, pData[j+1]);
+                dMax = qMax(dMax, pData[j+1]);
+            }
+
+            pMin[k] = (float)dMin;
+            pMax[k] = (float)dMax;
+        }
+    }
+
+    //Higher levels - combine the two child bins of the level below
+    for(int l = 1; l < m_vecMin.size(); ++l) {
+        iFirstBin /= 2;
+        iLastBin /= 2;
+
+        int iChildBins = m_vecMin[l-1].cols();
+
+        for(int r = 0; r < m_iRows; ++r) {
+            const float* pChildMin = m_vecMin[l-1].data() + r*iChildBins;
+            const float* pChildMax = m_vecMax[l-1].data() + r*iChildBins;
+            float* pMin = m_vecMin[l].data() + r*m_vecMin[l].cols();
+            float* pMax = m_vecMax[l].data() + r*m_vecMax[l].cols();
+
+            for(int k = iFirstBin; k <= iLastBin; ++k) {
+                int c = 2*k;
+
+                if(c + 1 < iChildBins) {
+                    pMin[k] = qMin(pChildMin[c], pChildMin[c+1]);
+                    pMax[k] = qMax(pChildMax[c], pChildMax[c+1]);
+                } else {
+                    pMin[k] = pChildMin[c];
+                    pMax[k] = pChildMax[c];
+                }
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+int MinMaxPyramid::levelForSamplesPerPixel(double dSamplesPerPixel) const
+{
+    //Below two samples per pixel the full resolution path is not denser than a min/max pair per pixel
+    if(m_vecMin.isEmpty() || dSamplesPerPixel < 2.0)
+        return -1;
+
+    int iLevel = 0;
+
+    while(iLevel < m_vecMin.size() - 1 && binSize(iLevel) < dSamplesPerPixel)
+        ++iLevel;
+
+    return iLevel;
+}
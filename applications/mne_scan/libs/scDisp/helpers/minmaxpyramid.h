@@ -0,0 +1,267 @@
+//=============================================================================================================
+/**
+* @file     minmaxpyramid.h
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the MinMaxPyramid Class.
+*
+*/
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../scdisp_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCDISPLIB
+//=============================================================================================================
+
+namespace SCDISPLIB
+{
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS MinMaxPyramid
+*
+* @brief The MinMaxPyramid class holds a per channel min/max envelope of a row major data matrix at several levels
+*        of detail. Level l combines 2^(l+1) neighbouring samples into one bin, each level halves the number of bins
+*        of the level below. The pyramid is kept up to date incrementally, only the bins covering a written column
+*        range are recomputed.
+*/
+class SCDISPSHARED_EXPORT MinMaxPyramid
+{
+public:
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXdR;    /**< Row major data matrix the pyramid is built from. */
+    typedef Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXfR;     /**< Row major storage of one pyramid level. */
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty pyramid.
+    */
+    MinMaxPyramid();
+
+    //=========================================================================================================
+    /**
+    * Allocates all levels for a data matrix of the given size. All bins are set to zero.
+    *
+    * @param[in] iRows      number of channels
+    * @param[in] iCols      number of samples per channel
+    */
+    void resize(int iRows, int iCols);
+
+    //=========================================================================================================
+    /**
+    * Recomputes all levels from the given data matrix, resizing the pyramid if necessary.
+    *
+    * @param[in] matData    the data matrix
+    */
+    void rebuild(const MatrixXdR& matData);
+
+    //=========================================================================================================
+    /**
+    * Recomputes the bins which cover the given column range of the data matrix. Columns outside the data matrix
+    * are ignored. The pyramid is rebuilt if its size does not match the data matrix.
+    *
+    * @param[in] matData    the data matrix
+    * @param[in] iFirstCol  first column which was written
+    * @param[in] iNumCols   number of columns which were written
+    */
+    void update(const MatrixXdR& matData, int iFirstCol, int iNumCols);
+
+    //=========================================================================================================
+    /**
+    * Returns the finest level whose bin size is at least the given number of samples per pixel, so that at most one
+    * bin, i.e. one min/max pair, falls on each pixel.
+    *
+    * @param[in] dSamplesPerPixel   number of samples which fall on one horizontal pixel
+    *
+    * @return the level to draw from, -1 if the samples should be drawn at full resolution
+    */
+    int levelForSamplesPerPixel(double dSamplesPerPixel) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of levels.
+    *
+    * @return the number of levels
+    */
+    inline int levelCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of channels.
+    *
+    * @return the number of channels
+    */
+    inline int rows() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples per channel the pyramid was built for.
+    *
+    * @return the number of samples per channel
+    */
+    inline int cols() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples combined into one bin at the given level.
+    *
+    * @param[in] iLevel     the level
+    *
+    * @return the bin size
+    */
+    inline static int binSize(int iLevel);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of bins at the given level. The last bin may cover fewer than binSize(iLevel) samples.
+    *
+    * @param[in] iLevel     the level
+    *
+    * @return the number of bins
+    */
+    inline int binCount(int iLevel) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the bin minima of one channel at the given level.
+    *
+    * @param[in] iLevel     the level
+    * @param[in] iRow       the channel
+    *
+    * @return pointer to binCount(iLevel) minima
+    */
+    inline const float* minRow(int iLevel, int iRow) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the bin maxima of one channel at the given level.
+    *
+    * @param[in] iLevel     the level
+    * @param[in] iRow       the channel
+    *
+    * @return pointer to binCount(iLevel) maxima
+    */
+    inline const float* maxRow(int iLevel, int iRow) const;
+
+private:
+    int                 m_iRows;        /**< Number of channels. */
+    int                 m_iCols;        /**< Number of samples per channel. */
+
+    QVector<MatrixXfR>  m_vecMin;       /**< Bin minima, one matrix per level. */
+    QVector<MatrixXfR>  m_vecMax;       /**< Bin maxima, one matrix per level. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int MinMaxPyramid::levelCount() const
+{
+    return m_vecMin.size();
+}
+
+
+//*************************************************************************************************************
+
+inline int MinMaxPyramid::rows() const
+{
+    return m_iRows;
+}
+
+
+//*************************************************************************************************************
+
+inline int MinMaxPyramid::cols() const
+{
+    return m_iCols;
+}
+
+
+//*************************************************************************************************************
+
+inline int MinMaxPyramid::binSize(int iLevel)
+{
+    return 2 << iLevel;
+}
+
+
+//*************************************************************************************************************
+
+inline int MinMaxPyramid::binCount(int iLevel) const
+{
+    return m_vecMin[iLevel].cols();
+}
+
+
+//*************************************************************************************************************
+
+inline const float* MinMaxPyramid::minRow(int iLevel, int iRow) const
+{
+    return m_vecMin[iLevel].data() + iRow*m_vecMin[iLevel].cols();
+}
+
+
+//*************************************************************************************************************
+
+inline const float* MinMaxPyramid::maxRow(int iLevel, int iRow) const
+{
+    return m_vecMax[iLevel].data() + iRow*m_vecMax[iLevel].cols();
+}
+
+} // NAMESPACE SCDISPLIB
+
+#endif // MINMAXPYRAMID_H
@@ -72,6 +72,7 @@ RealTimeMultiSampleArrayDelegate::RealTimeMultiSampleArrayDelegate(QObject *pare
 , m_fMaxValue(0.0)
 , m_fScaleY(0.0)
 , m_iActiveRow(0)
+, m_bUseMinMaxPyramid(true)
 {
 
 }
@@ -445,6 +446,14 @@ QSize RealTimeMultiSampleArrayDelegate::sizeHint(const QStyleOptionViewItem &opt
 }
 
 
+//*************************************************************************************************************
+
+void RealTimeMultiSampleArrayDelegate::setMinMaxPyramidEnabled(bool state)
+{
+    m_bUseMinMaxPyramid = state;
+}
+
+
 //*************************************************************************************************************
 
 void RealTimeMultiSampleArrayDelegate::markerMoved(QPoint position, int activeRow)
@@ -556,6 +565,79 @@ void RealTimeMultiSampleArrayDelegate::createPlotPath(const QModelIndex &index,
 
     float val;
 
+    //Draw one min/max pair per pixel from the pyramid if more than two samples fall on one pixel
+    const MinMaxPyramid& pyramid = t_pModel->getMinMaxPyramid();
+    qint32 iRow = t_pModel->getIdxSelMap().value(index.row(),0);
+    int iLevel = -1;
+
+    if(m_bUseMinMaxPyramid && fDx > 0 && pyramid.cols() == data.second && iRow < pyramid.rows())
+        iLevel = pyramid.levelForSamplesPerPixel(1.0/fDx);
+
+    if(iLevel >= 0) {
+        qint32 iBinSize = MinMaxPyramid::binSize(iLevel);
+        const float* pMin = pyramid.minRow(iLevel, iRow);
+        const float* pMax = pyramid.maxRow(iLevel, iRow);
+        float x0 = path.currentPosition().x();
+        float fLastY = y_base;
+        double dFirstValue = *(data.first);
+
+        for(qint32 k = 0; k < pyramid.binCount(iLevel); ++k) {
+            qint32 iStart = k*iBinSize;
+            qint32 iEnd = qMin(iStart+iBinSize, data.second);
+            double dMin, dMax;
+
+            if(iEnd <= currentSampleIndex) {
+                dMin = pMin[k] - dFirstValue;
+                dMax = pMax[k] - dFirstValue;
+            } else if(iStart >= currentSampleIndex) {
+                dMin = pMin[k] - lastFirstValue;
+                dMax = pMax[k] - lastFirstValue;
+            } else {
+                //The offset changes within this bin, compute it from the samples
+                dMin = dMax = *(data.first+iStart) - dFirstValue;
+
+                for(qint32 j = iStart+1; j < iEnd; ++j) {
+                    double dVal = j < currentSampleIndex ? *(data.first+j) - dFirstValue : *(data.first+j) - lastFirstValue;
+                    dMin = qMin(dMin, dVal);
+                    dMax = qMax(dMax, dVal);
+                }
+            }
+
+            //Sample j is drawn at x0+(j+1)*fDx, place the bin at the center of its samples
+            float fX = x0 + 0.5f*(iStart+iEnd+1)*fDx;
+            float fYMin = y_base-dMin*fScaleY;
+            float fYMax = y_base-dMax*fScaleY;
+
+            //Visit the extreme closer to the previous point first to avoid needless diagonals
+            if(qAbs(fYMax-fLastY) < qAbs(fYMin-fLastY)) {
+                path.lineTo(fX, fYMax);
+                path.lineTo(fX, fYMin);
+                fLastY = fYMin;
+            } else {
+                path.lineTo(fX, fYMin);
+                path.lineTo(fX, fYMax);
+                fLastY = fYMax;
+            }
+        }
+
+        //Create ellipse position
+        qint32 j = (qint32)(m_markerPosition.x()/fDx);
+
+        if(j >= 0 && j < data.second) {
+            if(j<currentSampleIndex)
+                val = *(data.first+j) - *(data.first);
+            else
+                val = *(data.first+j) - lastFirstValue;
+
+            ellipsePos.setX(x0+(j+2)*fDx);
+            ellipsePos.setY(y_base-val*fScaleY);
+
+            amplitude = QString::number(*(data.first+j));
+        }
+
+        return;
+    }
+
     for(qint32 j=0; j < data.second; ++j)
     {
         if(j<currentSampleIndex)
@@ -36,6 +36,14 @@
 #ifndef REALTIMEMULTISAMPLEARRAYDELEGATE_H
 #define REALTIMEMULTISAMPLEARRAYDELEGATE_H
 
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../scdisp_global.h"
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // QT INCLUDES
@@ -87,7 +95,7 @@ using namespace Eigen;
 *
 * @brief The RealTimeMultiSampleArrayDelegate class represents a RTMSA delegate which creates the plot paths
 */
-class RealTimeMultiSampleArrayDelegate : public QAbstractItemDelegate
+class SCDISPSHARED_EXPORT RealTimeMultiSampleArrayDelegate : public QAbstractItemDelegate
 {
     Q_OBJECT
 public:
@@ -131,6 +139,15 @@ public:
     */
     virtual QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const;
 
+    //=========================================================================================================
+    /**
+    * Sets whether the data is drawn from the min/max pyramid of the model when more than two samples fall on one
+    * pixel. Otherwise every sample is drawn.
+    *
+    * @param[in] state      whether to draw from the min/max pyramid
+    */
+    void setMinMaxPyramidEnabled(bool state);
+
     //=========================================================================================================
     /**
     * markerMoved is called whenever user moves the mouse inside of the table view viewport
@@ -232,9 +249,10 @@ private:
 //    QSettings m_qSettings;
 
     // Scaling
-    float       m_fMaxValue;        /**< Maximum value of the data to plot. */
-    float       m_fScaleY;          /**< Maximum amplitude of plot (max is m_dPlotHeight/2). */
-    int         m_iActiveRow;       /**< The current row which the mouse is moved over. */
+    float       m_fMaxValue;            /**< Maximum value of the data to plot. */
+    float       m_fScaleY;              /**< Maximum amplitude of plot (max is m_dPlotHeight/2). */
+    int         m_iActiveRow;           /**< The current row which the mouse is moved over. */
+    bool        m_bUseMinMaxPyramid;    /**< Whether to draw from the min/max pyramid of the model. */
 
     QPoint              m_markerPosition;   /**< Current mouse position used to draw the marker in the plot. */
     QList<QPainterPath> m_painterPaths;     /**< List of all current painter paths for each row. */
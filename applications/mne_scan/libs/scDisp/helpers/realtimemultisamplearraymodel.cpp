@@ -325,6 +325,9 @@ void RealTimeMultiSampleArrayModel::setFiffInfo(FiffInfo::SPtr& p_pFiffInfo)
         m_matDataFiltered.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxSamples);
         m_matDataFiltered.setZero();
 
+        m_pyramidRaw.resize(m_pFiffInfo->chs.size(), m_iMaxSamples);
+        m_pyramidFiltered.resize(m_pFiffInfo->chs.size(), m_iMaxSamples);
+
         m_vecLastBlockFirstValuesFiltered.conservativeResize(m_pFiffInfo->chs.size());
         m_vecLastBlockFirstValuesFiltered.setZero();
 
@@ -390,6 +393,8 @@ void RealTimeMultiSampleArrayModel::setSamplingInfo(float sps, int T)
     //Resize data matrix without touching the stored values
     m_matDataRaw.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxSamples);
     m_matDataFiltered.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxSamples);
+    m_pyramidRaw.rebuild(m_matDataRaw);
+    m_pyramidFiltered.rebuild(m_matDataFiltered);
     m_vecLastBlockFirstValuesRaw.conservativeResize(m_pFiffInfo->chs.size());
     m_vecLastBlockFirstValuesFiltered.conservativeResize(m_pFiffInfo->chs.size());
 
@@ -455,6 +460,8 @@ void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
                 }
             }
 
+            m_pyramidRaw.update(m_matDataRaw, m_iCurrentSample, m_iResidual);
+
             m_iCurrentSample = 0;
 
             if(!m_bIsFreezed) {
@@ -523,6 +530,21 @@ void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
             }
         }
 
+        //Update the min/max pyramids for the written columns. The overlap add also touches up to one filter length
+        //in front of and behind the new block, and the back of the matrix when the block starts at its beginning.
+        m_pyramidRaw.update(m_matDataRaw, m_iCurrentSample, nCol);
+
+        if(!m_filterData.isEmpty()) {
+            m_pyramidFiltered.update(m_matDataFiltered, m_iCurrentSample-m_iMaxFilterLength, nCol+2*m_iMaxFilterLength);
+
+            if(m_iCurrentSample-m_iMaxFilterLength < 0) {
+                int iTail = m_iResidual+m_iMaxFilterLength;
+                m_pyramidFiltered.update(m_matDataFiltered, m_matDataFiltered.cols()-iTail, iTail);
+            }
+        } else {
+            m_pyramidFiltered.update(m_matDataFiltered, m_iCurrentSample, nCol);
+        }
+
         m_iCurrentSample += nCol;
         m_iCurrentBlockSize = nCol;
 
@@ -660,6 +682,8 @@ void RealTimeMultiSampleArrayModel::toggleFreeze(const QModelIndex &)
     if(m_bIsFreezed) {
         m_matDataRawFreeze = m_matDataRaw;
         m_matDataFilteredFreeze = m_matDataFiltered;
+        m_pyramidRawFreeze = m_pyramidRaw;
+        m_pyramidFilteredFreeze = m_pyramidFiltered;
         m_qMapDetectedTriggerFreeze = m_qMapDetectedTrigger;
         m_qMapDetectedTriggerOldFreeze = m_qMapDetectedTriggerOld;
 
@@ -1179,6 +1203,8 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently()
     for(int i = 0; i < notFilterChannelIndex.size(); ++i)
         m_matDataFiltered.row(notFilterChannelIndex.at(i)) = m_matDataRaw.row(notFilterChannelIndex.at(i));
 
+    m_pyramidFiltered.rebuild(m_matDataFiltered);
+
     if(!m_bIsFreezed) {
         m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
     }
@@ -1312,6 +1338,10 @@ void RealTimeMultiSampleArrayModel::clearModel()
     m_matDataFiltered.setZero();
     m_matDataRawFreeze.setZero();
     m_matDataFilteredFreeze.setZero();
+    m_pyramidRaw.rebuild(m_matDataRaw);
+    m_pyramidFiltered.rebuild(m_matDataFiltered);
+    m_pyramidRawFreeze.rebuild(m_matDataRawFreeze);
+    m_pyramidFilteredFreeze.rebuild(m_matDataFilteredFreeze);
     m_vecLastBlockFirstValuesFiltered.setZero();
     m_vecLastBlockFirstValuesRaw.setZero();
     m_matOverlap.setZero();
@@ -42,6 +42,9 @@
 // INCLUDES
 //=============================================================================================================
 
+#include "../scdisp_global.h"
+#include "minmaxpyramid.h"
+
 #include <scMeas/realtimesamplearraychinfo.h>
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_info.h>
@@ -108,7 +111,7 @@ typedef Matrix<double,Dynamic,Dynamic,RowMajor> MatrixXdR;
 *
 * @brief The RealTimeMultiSampleArrayModel class implements the data access model for a real-time multi sample array data stream
 */
-class RealTimeMultiSampleArrayModel : public QAbstractTableModel
+class SCDISPSHARED_EXPORT RealTimeMultiSampleArrayModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
@@ -255,6 +258,15 @@ public:
     */
     inline double getLastBlockFirstValue(int row) const;
 
+    //=========================================================================================================
+    /**
+    * Returns the min/max pyramid of the data which is currently displayed, i.e. of the raw or filtered and the
+    * streamed or freezed data. Its rows correspond to the data rows, see getIdxSelMap.
+    *
+    * @return the min/max pyramid of the displayed data
+    */
+    inline const MinMaxPyramid& getMinMaxPyramid() const;
+
     //=========================================================================================================
     /**
     * Returns a map which conatins the channel idx and its corresponding selection status
@@ -573,6 +585,11 @@ private:
     MatrixXdR                           m_matDataFilteredFreeze;                    /**< The raw filtered data in freeze mode */
     MatrixXd                            m_matOverlap;                               /**< Last overlap block for the back */
 
+    MinMaxPyramid                       m_pyramidRaw;                               /**< Min/max pyramid of m_matDataRaw */
+    MinMaxPyramid                       m_pyramidFiltered;                          /**< Min/max pyramid of m_matDataFiltered */
+    MinMaxPyramid                       m_pyramidRawFreeze;                         /**< Min/max pyramid of m_matDataRawFreeze */
+    MinMaxPyramid                       m_pyramidFilteredFreeze;                    /**< Min/max pyramid of m_matDataFilteredFreeze */
+
     Eigen::VectorXi                     m_vecIndicesFirstVV;                        /**< The indices of the channels to pick for the first SPHARA operator in case of a VectorView system.*/
     Eigen::VectorXi                     m_vecIndicesSecondVV;                       /**< The indices of the channels to pick for the second SPHARA operator in case of a VectorView system.*/
     Eigen::VectorXi                     m_vecIndicesFirstBabyMEG;                   /**< The indices of the channels to pick for the first SPHARA operator in case of a BabyMEG system.*/
@@ -674,6 +691,17 @@ inline double RealTimeMultiSampleArrayModel::getLastBlockFirstValue(int row) con
 }
 
 
+//*************************************************************************************************************
+
+inline const MinMaxPyramid& RealTimeMultiSampleArrayModel::getMinMaxPyramid() const
+{
+    if(m_bIsFreezed)
+        return m_filterData.isEmpty() ? m_pyramidRawFreeze : m_pyramidFilteredFreeze;
+
+    return m_filterData.isEmpty() ? m_pyramidRaw : m_pyramidFiltered;
+}
+
+
 //*************************************************************************************************************
 
 inline const QMap<qint32,qint32>& RealTimeMultiSampleArrayModel::getIdxSelMap() const
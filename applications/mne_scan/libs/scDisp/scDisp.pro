@@ -104,6 +104,7 @@ SOURCES += \
     helpers/realtimebutterflyplot.cpp \
     helpers/realtimemultisamplearraymodel.cpp \
     helpers/realtimemultisamplearraydelegate.cpp \
+    helpers/minmaxpyramid.cpp \
     helpers/realtimeevokedmodel.cpp \
     helpers/realtimeevokedsetmodel.cpp \
     helpers/covmodalitywidget.cpp \
@@ -126,6 +127,7 @@ HEADERS += \
     frequencyspectrumwidget.h \
     helpers/realtimemultisamplearraymodel.h \
     helpers/realtimemultisamplearraydelegate.h \
+    helpers/minmaxpyramid.h \
     helpers/realtimeevokedmodel.h \
     helpers/realtimeevokedsetmodel.h \
     helpers/realtimebutterflyplot.h \
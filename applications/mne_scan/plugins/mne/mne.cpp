@@ -258,7 +258,8 @@ void MNE::doClustering()
 
     m_qMutex.lock();
     m_bFinishedClustering = false;
-    m_pClusteredFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(m_pFwd->cluster_forward_solution(*m_pAnnotationSet.data(), 40)));
+    MNEOperatorCache t_operatorCache;
+    m_pClusteredFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(t_operatorCache.cluster_forward_solution(*m_pFwd.data(), *m_pAnnotationSet.data(), 40)));
     //m_pClusteredFwd = m_pFwd;
     m_pRTSEOutput->data()->setFwdSolution(m_pClusteredFwd);
 
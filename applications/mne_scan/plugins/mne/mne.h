@@ -52,6 +52,7 @@
 #include <fiff/fiff_info.h>
 #include <fiff/fiff_evoked.h>
 #include <mne/mne_forwardsolution.h>
+#include <mne/mne_operator_cache.h>
 #include <mne/mne_sourceestimate.h>
 #include <inverse/minimumNorm/minimumnorm.h>
 #include <rtProcessing/rtinvop.h>
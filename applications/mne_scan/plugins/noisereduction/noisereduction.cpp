@@ -41,6 +41,14 @@
 #include "noisereduction.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define OPERATOR_DENSE_FILL_RATIO 0.1   /**< Fill ratio above which the compiled operator is applied as dense matrix. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -71,6 +79,10 @@ NoiseReduction::NoiseReduction()
 , m_bFilterActivated(false)
 , m_bProjActivated(false)
 , m_bCompActivated(false)
+, m_bOperatorChanged(true)
+, m_bOperatorIdentity(true)
+, m_bOperatorDense(false)
+, m_bPostFilterOperator(false)
 , m_sCurrentSystem("VectorView")
 , m_pRTMSA(NewRealTimeMultiSampleArray::SPtr(new NewRealTimeMultiSampleArray()))
 , m_pFilterWindow(Q_NULLPTR)
@@ -309,6 +321,7 @@ void NoiseReduction::setSpharaMode(bool state)
 {
     m_mutex.lock();
     m_bSpharaActive = state;
+    m_bOperatorChanged = true;
     m_mutex.unlock();
 }
 
@@ -389,6 +402,8 @@ void NoiseReduction::updateProjection()
         m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
 
         m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+
+        m_bOperatorChanged = true;
         m_mutex.unlock();
     }
 }
@@ -403,6 +418,8 @@ void NoiseReduction::updateCompensator(int to)
     //
     if(m_pFiffInfo)
     {
+        QMutexLocker locker(&m_mutex);
+
         if(to == 0) {
             m_bCompActivated = false;
         } else {
@@ -448,6 +465,8 @@ void NoiseReduction::updateCompensator(int to)
         m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
 
         m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+
+        m_bOperatorChanged = true;
     }
 }
 
@@ -456,6 +475,8 @@ void NoiseReduction::updateCompensator(int to)
 
 void NoiseReduction::setFilterChannelType(QString sType)
 {
+    QMutexLocker locker(&m_mutex);
+
     m_sFilterChannelType = sType;
 
     //This version is for when all channels of a type are to be filtered (not only the visible ones).
@@ -474,6 +495,8 @@ void NoiseReduction::setFilterChannelType(QString sType)
             }
         }
     }
+
+    m_bOperatorChanged = true;
 }
 
 
@@ -496,7 +519,10 @@ void NoiseReduction::filterChanged(QList<FilterData> filterData)
 
 void NoiseReduction::filterActivated(bool state)
 {
+    m_mutex.lock();
     m_bFilterActivated = state;
+    m_bOperatorChanged = true;
+    m_mutex.unlock();
 }
 
 
@@ -708,10 +734,102 @@ void NoiseReduction::createSpharaOperator()
 
     m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
 
+    m_bOperatorChanged = true;
+
     m_mutex.unlock();
 }
 
 
+//*************************************************************************************************************
+
+void NoiseReduction::compileOperator()
+{
+    const int nchan = m_pFiffInfo->chs.size();
+
+    //SSP's and compensators
+    SparseMatrix<double> matPre(nchan, nchan);
+    matPre.setIdentity();
+
+    if(m_bCompActivated) {
+        if(m_bProjActivated) {
+            matPre = m_matSparseProjCompMult;
+        } else {
+            matPre = m_matSparseCompMult;
+        }
+    } else if(m_bProjActivated) {
+        matPre = m_matSparseProjMult;
+    }
+
+    //SPHARA including bad channel masking, so bad channels do not get smeared into
+    SparseMatrix<double> matPost(nchan, nchan);
+    matPost.setIdentity();
+
+    m_qListOperatorBads = m_pFiffInfo->bads;
+
+    if(m_bSpharaActive) {
+        VectorXd vecGood = VectorXd::Ones(nchan);
+        for(int i = 0; i < m_qListOperatorBads.size(); ++i) {
+            int index = m_pFiffInfo->ch_names.indexOf(m_qListOperatorBads.at(i));
+            if(index >= 0 && index < nchan) {
+                vecGood(index) = 0.0;
+            }
+        }
+
+        matPost = m_matSparseSpharaMult * vecGood.asDiagonal();
+    }
+
+    //The temporal filter treats every channel the same way (filtered or delayed). Hence SPHARA can be moved in
+    //front of the filter as long as it does not mix filtered with non filtered channels.
+    m_bPostFilterOperator = false;
+
+    if(m_bSpharaActive && m_bFilterActivated) {
+        QVector<bool> vecFiltered(nchan, false);
+        for(int i = 0; i < m_lFilterChannelList.size(); ++i) {
+            if(m_lFilterChannelList.at(i) >= 0 && m_lFilterChannelList.at(i) < nchan) {
+                vecFiltered[m_lFilterChannelList.at(i)] = true;
+            }
+        }
+
+        for(int k = 0; k < matPost.outerSize() && !m_bPostFilterOperator; ++k) {
+            for(SparseMatrix<double>::InnerIterator it(matPost, k); it; ++it) {
+                if(it.value() != 0.0 && vecFiltered.at(it.row()) != vecFiltered.at(it.col())) {
+                    m_bPostFilterOperator = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    SparseMatrix<double> matOperator;
+
+    if(m_bPostFilterOperator) {
+        matOperator = matPre;
+        m_matSparsePostFilterOperator = matPost;
+    } else {
+        matOperator = matPost * matPre;
+        m_matSparsePostFilterOperator = SparseMatrix<double>();
+    }
+
+    matOperator.prune(0.0);
+
+    m_bOperatorIdentity = !m_bCompActivated && !m_bProjActivated && (!m_bSpharaActive || m_bPostFilterOperator);
+
+    //Choose the cheaper representation
+    double dFillRatio = nchan > 0 ? double(matOperator.nonZeros()) / (double(nchan) * double(nchan)) : 0.0;
+    m_bOperatorDense = dFillRatio > OPERATOR_DENSE_FILL_RATIO;
+
+    if(m_bOperatorDense) {
+        m_matDenseOperator = MatrixXd(matOperator);
+        m_matSparseOperator = SparseMatrix<double>();
+    } else {
+        m_matSparseOperator = matOperator;
+        m_matDenseOperator = MatrixXd();
+    }
+
+    m_bOperatorChanged = false;
+}
+
+
 //*************************************************************************************************************
 
 void NoiseReduction::run()
@@ -737,41 +855,28 @@ void NoiseReduction::run()
 
         m_mutex.lock();
 
-        //Do SSP's and compensators here
-        if(m_bCompActivated) {
-            if(m_bProjActivated) {
-                //Comp + Proj
-                t_mat = m_matSparseProjCompMult * t_mat;
-            } else {
-                //Comp
-                t_mat = m_matSparseCompMult * t_mat;
-            }
-        } else {
-            if(m_bProjActivated) {
-                //Proj
-                t_mat = m_matSparseProjMult * t_mat;
+        //Rebuild the compiled operator only if the settings or the bad channels changed
+        if(m_bOperatorChanged || m_qListOperatorBads != m_pFiffInfo->bads) {
+            compileOperator();
+        }
+
+        //Do SSP's, compensators and SPHARA here
+        if(!m_bOperatorIdentity) {
+            if(m_bOperatorDense) {
+                t_mat = m_matDenseOperator * t_mat;
             } else {
-                //None - Raw
+                t_mat = m_matSparseOperator * t_mat;
             }
         }
 
         //Do temporal filtering here
         if(m_bFilterActivated) {
-            t_mat = m_pRtFilter->filterChannelsConcurrently(t_mat, m_iMaxFilterLength, m_lFilterChannelList, m_filterData);
+            t_mat = m_pRtFilter->filterChannelsOverlapSave(t_mat, m_lFilterChannelList, m_filterData);
         }
 
-//        qDebug()<<"t_mat dim:"<<t_mat.rows()<<"x"<<t_mat.cols();
-//        qDebug()<<"m_lFilterChannelList.size():"<<m_lFilterChannelList.size();
-//        qDebug()<<"m_filterData.size():"<<m_filterData.size();
-
-        //Do SPHARA here
-        if(m_bSpharaActive) {
-            //Set bad channels to zero so they do not get smeared into
-            for(int i = 0; i < m_pFiffInfo->bads.size(); ++i) {
-                t_mat.row(m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(i))).setZero();
-            }
-
-            t_mat = m_matSparseSpharaMult * t_mat;
+        //Do SPHARA here in case it could not be merged into the operator above
+        if(m_bPostFilterOperator) {
+            t_mat = m_matSparsePostFilterOperator * t_mat;
         }
 
 //        //Common average
@@ -249,6 +249,16 @@ protected:
     */
     void createSpharaOperator();
 
+    //=========================================================================================================
+    /**
+    * Compiles the currently active spatial operators (compensator, SSP, bad channel masking and SPHARA) into a
+    * single operator which is applied with one multiplication per block. The operator is stored dense or sparse
+    * depending on its fill ratio. If SPHARA mixes filtered with non filtered channels the SPHARA part can not be
+    * moved in front of the temporal filter and is kept as a separate post filter operator.
+    * Must be called with m_mutex locked.
+    */
+    void compileOperator();
+
     //=========================================================================================================
     /**
     * IAlgorithm function
@@ -263,6 +273,10 @@ private:
     bool                            m_bSpharaActive;                            /**< Flag whether thread is running.*/
     bool                            m_bProjActivated;                           /**< Projections activated */
     bool                            m_bFilterActivated;                         /**< Projections activated */
+    bool                            m_bOperatorChanged;                         /**< Flag whether the compiled operator needs to be rebuilt.*/
+    bool                            m_bOperatorIdentity;                        /**< Flag whether the compiled operator is the identity and can be skipped.*/
+    bool                            m_bOperatorDense;                           /**< Flag whether the compiled operator is applied as dense matrix.*/
+    bool                            m_bPostFilterOperator;                      /**< Flag whether the SPHARA part has to be applied after the temporal filter.*/
 
     int                             m_iNBaseFctsFirst;                          /**< The number of grad/inner base functions to use for calculating the sphara opreator.*/
     int                             m_iNBaseFctsSecond;                         /**< The number of grad/outer base functions to use for calculating the sphara opreator.*/
@@ -286,6 +300,9 @@ private:
     Eigen::SparseMatrix<double>     m_matSparseProjMult;                        /**< The final sparse SSP projector */
     Eigen::SparseMatrix<double>     m_matSparseCompMult;                        /**< The final sparse compensator matrix */
     Eigen::SparseMatrix<double>     m_matSparseFull;                            /**< The final sparse full multiplication matrix  */
+    Eigen::SparseMatrix<double>     m_matSparseOperator;                        /**< The compiled operator in case it is sparse enough.*/
+    Eigen::SparseMatrix<double>     m_matSparsePostFilterOperator;              /**< The SPHARA operator in case it can not be applied before the temporal filter.*/
+    Eigen::MatrixXd                 m_matDenseOperator;                         /**< The compiled operator in case it is too dense for sparse multiplication.*/
 
     Eigen::MatrixXd                 m_matSpharaVVGradLoaded;                    /**< The loaded VectorView gradiometer basis functions.*/
     Eigen::MatrixXd                 m_matSpharaVVMagLoaded;                     /**< The loaded VectorView magnetometer basis functions.*/
@@ -294,6 +311,7 @@ private:
     Eigen::MatrixXd                 m_matSpharaEEGLoaded;                       /**< The loaded EEG basis functions.*/
 
     QVector<int>                    m_lFilterChannelList;                       /**< The indices of the channels to be filtered.*/
+    QStringList                     m_qListOperatorBads;                        /**< The bad channels the compiled operator was built with.*/
 
     FIFFLIB::FiffInfo::SPtr                         m_pFiffInfo;                /**< Fiff measurement info.*/
 
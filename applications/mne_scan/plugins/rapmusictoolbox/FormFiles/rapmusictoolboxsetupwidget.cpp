@@ -91,11 +91,17 @@ RapMusicToolboxSetupWidget::RapMusicToolboxSetupWidget(RapMusicToolbox* toolbox,
     else
         ui.m_qLabel_surfaceStat->setText("loaded");
 
+    ui.m_qCheckBox_Hierarchical->setChecked(m_pRapMusicToolbox->m_bHierarchicalSearch);
+    ui.m_qSpinBox_BeamWidth->setValue(m_pRapMusicToolbox->m_iBeamWidth);
+    ui.m_qSpinBox_BeamWidth->setEnabled(m_pRapMusicToolbox->m_bHierarchicalSearch);
+
     connect(ui.m_qPushButton_About, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showAboutDialog);
     connect(ui.m_qPushButton_FwdFileDialog, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showFwdFileDialog);
     connect(ui.m_qPushButton_AtlasDirDialog, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showAtlasDirDialog);
     connect(ui.m_qPushButton_SurfaceDirDialog, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showSurfaceDirDialog);
     connect(ui.m_qPushButonStartClustering, &QPushButton::released, this, &RapMusicToolboxSetupWidget::clusteringTriggered);
+    connect(ui.m_qCheckBox_Hierarchical, &QCheckBox::stateChanged, this, &RapMusicToolboxSetupWidget::onHierarchicalSearchChanged);
+    connect(ui.m_qSpinBox_BeamWidth, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &RapMusicToolboxSetupWidget::onBeamWidthChanged);
 }
 
 
@@ -220,3 +226,25 @@ void RapMusicToolboxSetupWidget::showSurfaceDirDialog()
         ui.m_qLabel_surfaceStat->setText("not loaded");
     }
 }
+
+
+//*************************************************************************************************************
+
+void RapMusicToolboxSetupWidget::onHierarchicalSearchChanged(int state)
+{
+    m_pRapMusicToolbox->m_qMutex.lock();
+    m_pRapMusicToolbox->m_bHierarchicalSearch = (state == Qt::Checked);
+    m_pRapMusicToolbox->m_qMutex.unlock();
+
+    ui.m_qSpinBox_BeamWidth->setEnabled(state == Qt::Checked);
+}
+
+
+//*************************************************************************************************************
+
+void RapMusicToolboxSetupWidget::onBeamWidthChanged(int value)
+{
+    m_pRapMusicToolbox->m_qMutex.lock();
+    m_pRapMusicToolbox->m_iBeamWidth = value;
+    m_pRapMusicToolbox->m_qMutex.unlock();
+}
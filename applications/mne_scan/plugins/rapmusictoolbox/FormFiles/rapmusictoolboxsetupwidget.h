@@ -149,6 +149,22 @@ private:
     */
     void showSurfaceDirDialog();
 
+    //=========================================================================================================
+    /**
+    * Switches between the exhaustive and the coarse-to-fine dipole pair search
+    *
+    * @param [in] state     the check state of the coarse-to-fine check box
+    */
+    void onHierarchicalSearchChanged(int state);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of coarse pairs which are refined by the coarse-to-fine search
+    *
+    * @param [in] value     the new beam width
+    */
+    void onBeamWidthChanged(int value);
+
 
     RapMusicToolbox* m_pRapMusicToolbox;            /**< Holds a pointer to corresponding DummyToolbox.*/
 
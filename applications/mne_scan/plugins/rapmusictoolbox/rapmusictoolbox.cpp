@@ -73,6 +73,8 @@ RapMusicToolbox::RapMusicToolbox()
 , m_bReceiveData(false)
 , m_bProcessData(false)
 , m_bFinishedClustering(false)
+, m_bHierarchicalSearch(false)
+, m_iBeamWidth(16)
 , m_qFileFwdSolution("./MNE-sample-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif")
 , m_sAtlasDir("./MNE-sample-data/subjects/sample/label")
 , m_sSurfaceDir("./MNE-sample-data/subjects/sample/surf")
@@ -172,7 +174,20 @@ void RapMusicToolbox::doClustering()
 
     m_qMutex.lock();
     m_bFinishedClustering = false;
-    m_pClusteredFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(m_pFwd->cluster_forward_solution(*m_pAnnotationSet.data(), 40)));
+    MatrixXd t_matD;
+    m_pClusteredFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(m_pFwd->cluster_forward_solution(*m_pAnnotationSet.data(), 40, t_matD)));
+
+    //Coarse level for the hierarchical search, the weights of both clusterings are combined to map clustered onto coarse sources
+    if(m_bHierarchicalSearch)
+    {
+        MatrixXd t_matDCoarse;
+        m_pCoarseFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(m_pFwd->cluster_forward_solution(*m_pAnnotationSet.data(), 160, t_matDCoarse)));
+
+        SparseMatrix<double> t_matDSparse = t_matD.sparseView();
+        SparseMatrix<double> t_matDCoarseSparse = t_matDCoarse.sparseView();
+        SparseMatrix<double> t_matDCombined = t_matDSparse.transpose() * t_matDCoarseSparse;
+        m_matCoarseD = MatrixXd(t_matDCombined);
+    }
     m_qMutex.unlock();
 
     finishedClustering();
@@ -315,9 +330,12 @@ void RapMusicToolbox::run()
         msleep(10);// Wait for fiff Info
     }
 
-    m_pPwlRapMusic.reset();
+    m_pRapMusic.reset();
+
+    m_pRapMusic = RapMusic::SPtr(new RapMusic(*m_pClusteredFwd, false, numDipolePairs));
 
-    m_pPwlRapMusic = RapMusic::SPtr(new RapMusic(*m_pClusteredFwd, false, numDipolePairs));
+    if(m_bHierarchicalSearch && m_pCoarseFwd)
+        m_pRapMusic->setHierarchicalSearch(*m_pCoarseFwd, m_matCoarseD, m_iBeamWidth, true);
 
     //
     // start processing data
@@ -341,17 +359,17 @@ void RapMusicToolbox::run()
 
         if(t_evokedSize > 0)
         {
-            if(m_pPwlRapMusic && ((skip_count % 10) == 0))
+            if(m_pRapMusic && ((skip_count % 10) == 0))
             {
                 m_qMutex.lock();
                 FiffEvoked t_fiffEvoked = m_qVecFiffEvoked[0];
-                m_pPwlRapMusic->setStcAttr(t_fiffEvoked.data.cols()/4.0,0.0);
+                m_pRapMusic->setStcAttr(t_fiffEvoked.data.cols()/4.0,0.0);
                 m_qVecFiffEvoked.pop_front();
                 m_qMutex.unlock();
 
                 qDebug() << "m_pRapMusic->calculateInverse";
 
-                MNESourceEstimate sourceEstimate = m_pPwlRapMusic->calculateInverse(t_fiffEvoked);
+                MNESourceEstimate sourceEstimate = m_pRapMusic->calculateInverse(t_fiffEvoked);
                 m_pRTSEOutput->data()->setValue(sourceEstimate);
             }
             else
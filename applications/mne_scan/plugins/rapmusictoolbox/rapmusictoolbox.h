@@ -53,7 +53,7 @@
 #include <fiff/fiff_evoked.h>
 #include <mne/mne_forwardsolution.h>
 #include <mne/mne_sourceestimate.h>
-#include <inverse/rapMusic/pwlrapmusic.h>
+#include <inverse/rapMusic/rapmusic.h>
 
 #include <scMeas/realtimesourceestimate.h>
 #include <scMeas/realtimeevoked.h>
@@ -199,6 +199,11 @@ private:
     QFile                       m_qFileFwdSolution; /**< File to forward solution. */
     MNEForwardSolution::SPtr    m_pFwd;             /**< Forward solution. */
     MNEForwardSolution::SPtr    m_pClusteredFwd;    /**< Clustered forward solution. */
+    MNEForwardSolution::SPtr    m_pCoarseFwd;       /**< Coarser clustered forward solution for the hierarchical search. */
+    MatrixXd                    m_matCoarseD;       /**< Weights which map the clustered onto the coarser clustered forward solution. */
+
+    bool                        m_bHierarchicalSearch;  /**< Whether the dipole pairs are searched coarse-to-fine instead of exhaustively (approximate, off by default). */
+    qint32                      m_iBeamWidth;           /**< Number of coarse pairs which are refined. */
 
     bool m_bFinishedClustering;                     /**< If clustered forward solution is available. */
 
@@ -213,7 +218,7 @@ private:
 
     QStringList                 m_qListPickChannels;        /**< Channels to pick */
 
-    PwlRapMusic::SPtr           m_pPwlRapMusic;     /**< Powell RAP MUSIC. */
+    RapMusic::SPtr              m_pRapMusic;        /**< RAP MUSIC, exhaustive or coarse-to-fine pair search. */
     qint32                      m_iDownSample;      /**< Sampling rate */
 
 //    RealTimeSourceEstimate::SPtr m_pRTSE_MNE; /**< Source Estimate output channel. */
@@ -47,6 +47,7 @@
 
 #include <fiff/fiff_evoked.h>
 #include <mne/mne_sourceestimate.h>
+#include <mne/mne_operator_cache.h>
 #include <inverse/minimumNorm/minimumnorm.h>
 
 #include <disp3D/view3D.h>
@@ -170,9 +171,10 @@ int main(int argc, char *argv[])
     noise_cov = noise_cov.regularize(evoked.info, 0.05, 0.05, 0.1, true);
 
     //
-    // Cluster forward solution;
+    // Cluster forward solution, reusing the result of previous runs;
     //
-    MNEForwardSolution t_clusteredFwd = t_Fwd.cluster_forward_solution(t_annotationSet, 20);//40);
+    MNEOperatorCache t_operatorCache;
+    MNEForwardSolution t_clusteredFwd = t_operatorCache.cluster_forward_solution(t_Fwd, t_annotationSet, 20);//40);
 
 //    std::cout << "Size " << t_clusteredFwd.sol->data.rows() << " x " << t_clusteredFwd.sol->data.cols() << std::endl;
 //    std::cout << "Clustered Fwd:\n" << t_clusteredFwd.sol->data.row(0) << std::endl;
@@ -182,7 +184,7 @@ int main(int argc, char *argv[])
     //
     FiffInfo info = evoked.info;
 
-    MNEInverseOperator inverse_operator(info, t_clusteredFwd, noise_cov, 0.2f, 0.8f);
+    MNEInverseOperator inverse_operator = t_operatorCache.make_inverse_operator(info, t_clusteredFwd, noise_cov, 0.2f, 0.8f);
 
     //
     // save clustered inverse
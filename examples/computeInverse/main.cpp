@@ -65,6 +65,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QCommandLineParser>
+#include <QElapsedTimer>
 
 
 //*************************************************************************************************************
@@ -105,12 +106,14 @@ int main(int argc, char *argv[])
     QCommandLineOption snrOption("snr", "The <snr> value used for computation.", "snr", "1.0");
     QCommandLineOption methodOption("method", "Inverse estimation <method>, i.e., 'MNE', 'dSPM' or 'sLORETA'.", "method", "dSPM");
     QCommandLineOption stcFileOption("stcOut", "Path to stc <file>, which is to be written.", "file", "");
+    QCommandLineOption benchOption("bench", "Compare per-call and batched inverse computation for <count> copies of the evoked data.", "count", "0");
 
     parser.addOption(evokedFileOption);
     parser.addOption(invFileOption);
     parser.addOption(snrOption);
     parser.addOption(methodOption);
     parser.addOption(stcFileOption);
+    parser.addOption(benchOption);
     parser.process(app);
 
     QFile t_fileEvoked(parser.value(evokedFileOption));
@@ -119,6 +122,7 @@ int main(int argc, char *argv[])
     float snr = parser.value(snrOption).toFloat();
     QString method(parser.value(methodOption));
     QString t_sFileNameStc(parser.value(stcFileOption));
+    qint32 iBenchCount = parser.value(benchOption).toInt();
 
     double lambda2 = 1.0 / pow(snr, 2);
     qDebug() << "Start calculation with: SNR" << snr << "; Lambda" << lambda2 << "; Method" << method << "; stc:" << t_sFileNameStc;
@@ -150,6 +154,44 @@ int main(int argc, char *argv[])
     printf("tmin = %f s\n", sourceEstimate.tmin);
     printf("tstep = %f s\n", sourceEstimate.tstep);
 
+    //
+    // Benchmark: per-call against batched application of the kernel
+    //
+    if(iBenchCount > 0)
+    {
+        FiffEvoked t_evokedPicked = evoked.pick_channels(minimumNorm.getPreparedInverseOperator().noise_cov->names);
+        float tmin = ((float)t_evokedPicked.first) / t_evokedPicked.info.sfreq;
+        float tstep = 1.0f / t_evokedPicked.info.sfreq;
+
+        QList<MatrixXd> t_qListData;
+        QList<float> t_qListTmin;
+        for(qint32 i = 0; i < iBenchCount; ++i)
+        {
+            t_qListData.append(t_evokedPicked.data);
+            t_qListTmin.append(tmin);
+        }
+
+        QElapsedTimer timer;
+
+        timer.start();
+        for(qint32 i = 0; i < iBenchCount; ++i)
+            minimumNorm.calculateInverse(t_qListData[i], t_qListTmin[i], tstep);
+        qint64 iPerCallMs = timer.elapsed();
+
+        timer.start();
+        QList<MNESourceEstimate> t_qListStc = minimumNorm.calculateInverse(t_qListData, t_qListTmin, tstep);
+        qint64 iBatchedMs = timer.elapsed();
+
+        timer.start();
+        QList<MNESourceEstimate> t_qListStcFloat = minimumNorm.calculateInverse(t_qListData, t_qListTmin, tstep, true);
+        qint64 iBatchedFloatMs = timer.elapsed();
+
+        printf("\n%d data blocks: per-call %lld ms, batched %lld ms, batched (float) %lld ms\n", iBenchCount, iPerCallMs, iBatchedMs, iBatchedFloatMs);
+        printf("max deviation batched %g, batched (float) %g\n",
+               (t_qListStc[0].data - sourceEstimate.data).cwiseAbs().maxCoeff(),
+               (t_qListStcFloat[0].data - sourceEstimate.data).cwiseAbs().maxCoeff());
+    }
+
 
     if(!t_sFileNameStc.isEmpty())
     {
@@ -107,6 +107,12 @@ int main(int argc, char *argv[])
     //
     FiffRawData raw(t_fileIn);
 
+    //
+    //   Map the file into memory, raw buffers are then decoded directly from the mapped file
+    //
+    if(raw.file)
+        raw.file->map_file();
+
     //
     //   Set up pick list: MEG + STI 014 - bad channels
     //
@@ -0,0 +1,374 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Benchmarks random access reads of raw data segments. Reads random windows from a raw file and
+*           reports the latency percentiles. Run it against a build without the raw directory index to get the
+*           reference numbers.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff.h>
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <limits>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Prints the latency percentiles of the given timings
+*
+* @param [in] p_sLabel      label of the printed line
+* @param [in] p_vecTimes    the measured latencies in ms
+*/
+void printPercentiles(const char* p_sLabel, std::vector<double> p_vecTimes)
+{
+    if(p_vecTimes.empty())
+        return;
+
+    std::sort(p_vecTimes.begin(), p_vecTimes.end());
+
+    size_t n = p_vecTimes.size();
+    printf("%-12s n = %5d | p50 %9.3f ms | p90 %9.3f ms | p99 %9.3f ms | max %9.3f ms\n", p_sLabel, (int)n,
+           p_vecTimes[n*50/100], p_vecTimes[n*90/100], p_vecTimes[std::min(n-1, n*99/100)], p_vecTimes[n-1]);
+}
+
+
+//*************************************************************************************************************
+/**
+* Redirects stdout to the null device, so that the console output of the readers is not timed
+*
+* @return the duplicated original stdout descriptor to pass to restoreStdout
+*/
+int silenceStdout()
+{
+    fflush(stdout);
+    int iSaved = dup(fileno(stdout));
+    int iNull = open(NULL_DEVICE, O_WRONLY);
+    if(iNull < 0)
+    {
+        close(iSaved);
+        return -1;
+    }
+    dup2(iNull, fileno(stdout));
+    close(iNull);
+    return iSaved;
+}
+
+
+//*************************************************************************************************************
+/**
+* Restores stdout after silenceStdout
+*
+* @param [in] p_iSaved      the descriptor returned by silenceStdout
+*/
+void restoreStdout(int p_iSaved)
+{
+    if(p_iSaved < 0)
+        return;
+    fflush(stdout);
+    dup2(p_iSaved, fileno(stdout));
+    close(p_iSaved);
+}
+
+
+//*************************************************************************************************************
+/**
+* Baseline reader as before the raw directory index: the raw directory is scanned linearly from the beginning,
+* every buffer is read into a newly allocated tag and decoded completely before the samples are picked.
+* Only calibration is applied, all channels are read.
+*
+* @param [in] p_raw     the raw data
+* @param [out] p_data   the calibrated data of the segment
+* @param [in] p_iFrom   first sample
+* @param [in] p_iTo     last sample
+*/
+void readRawSegmentBaseline(FiffRawData& p_raw, MatrixXd& p_data, fiff_int_t p_iFrom, fiff_int_t p_iTo)
+{
+    qint32 nchan = p_raw.info.nchan;
+    p_data.resize(nchan, p_iTo - p_iFrom + 1);
+
+    if (!p_raw.file->device()->isOpen())
+        p_raw.file->device()->open(QIODevice::ReadOnly);
+
+    MatrixXd one;
+    qint32 dest = 0;
+    for(qint32 k = 0; k < p_raw.rawdir.size(); ++k)
+    {
+        FiffRawDir thisRawDir = p_raw.rawdir[k];
+        if (thisRawDir.last < p_iFrom)
+            continue;
+
+        if (thisRawDir.ent.kind == -1)
+        {
+            one.setZero(nchan, thisRawDir.nsamp);
+        }
+        else
+        {
+            FiffTag::SPtr t_pTag;
+            FiffTag::read_tag(p_raw.file.data(), t_pTag, thisRawDir.ent.pos);
+
+            if (t_pTag->type == FIFFT_DAU_PACK16)
+                one = p_raw.cals.transpose().asDiagonal()*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
+            else if(t_pTag->type == FIFFT_INT)
+                one = p_raw.cals.transpose().asDiagonal()*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
+            else if(t_pTag->type == FIFFT_FLOAT)
+                one = p_raw.cals.transpose().asDiagonal()*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
+            else
+                one.setZero(nchan, thisRawDir.nsamp);
+        }
+
+        fiff_int_t first_pick = p_iFrom > thisRawDir.first ? p_iFrom - thisRawDir.first : 0;
+        fiff_int_t last_pick = p_iTo < thisRawDir.last ? p_iTo - thisRawDir.first : thisRawDir.nsamp - 1;
+        fiff_int_t picksamp = last_pick - first_pick + 1;
+
+        if (picksamp > 0)
+        {
+            p_data.block(0, dest, nchan, picksamp) = one.block(0, first_pick, nchan, picksamp);
+            dest += picksamp;
+        }
+
+        if (thisRawDir.last >= p_iTo)
+            break;
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Raw Segment Seek Benchmark");
+    QCoreApplication::setApplicationVersion("Revision 1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Raw Segment Seek Benchmark");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption rawFileOption(QStringList() << "raw" << "raw-file",
+            QCoreApplication::translate("main", "The raw MEG data <file>."),
+            QCoreApplication::translate("main", "file"),
+            "./MNE-sample-data/MEG/sample/sample_audvis_raw.fif");
+    parser.addOption(rawFileOption);
+
+    QCommandLineOption numReadsOption(QStringList() << "n" << "num-reads",
+            QCoreApplication::translate("main", "The <number> of random windows to read."),
+            QCoreApplication::translate("main", "number"),
+            "200");
+    parser.addOption(numReadsOption);
+
+    QCommandLineOption windowOption(QStringList() << "w" << "window",
+            QCoreApplication::translate("main", "The window <length> in seconds."),
+            QCoreApplication::translate("main", "length"),
+            "1.0");
+    parser.addOption(windowOption);
+
+    QCommandLineOption seedOption(QStringList() << "seed",
+            QCoreApplication::translate("main", "The random <seed>."),
+            QCoreApplication::translate("main", "seed"),
+            "42");
+    parser.addOption(seedOption);
+
+    parser.process(app);
+
+    QFile t_fileRaw(parser.value(rawFileOption));
+    qint32 numReads = parser.value(numReadsOption).toInt();
+    float fWindow = parser.value(windowOption).toFloat();
+    srand(parser.value(seedOption).toUInt());
+
+    FiffRawData raw(t_fileRaw);
+    if(raw.isEmpty())
+    {
+        printf("Could not read raw data from %s\n", t_fileRaw.fileName().toUtf8().constData());
+        return 1;
+    }
+
+    fiff_int_t iWindow = (fiff_int_t)(fWindow*raw.info.sfreq);
+    fiff_int_t iRange = raw.last_samp - raw.first_samp - iWindow;
+    if(iRange <= 0)
+    {
+        printf("File is shorter than the requested window\n");
+        return 1;
+    }
+
+    //
+    // Read random windows with the baseline and the indexed reader, the timings of the indexed reader are split by
+    // the position in the file to show the seek dependency. The console output of the readers is not timed.
+    //
+    std::vector<fiff_int_t> vecOffsets(numReads);
+    for(qint32 i = 0; i < numReads; ++i)
+        vecOffsets[i] = (fiff_int_t)(((double)rand() / RAND_MAX) * iRange);
+
+    std::vector<double> vecBaseline, vecAll, vecBegin, vecMiddle, vecEnd;
+    MatrixXd data, dataBaseline, times;
+    QElapsedTimer timer;
+    double dMaxDiff = 0.0;
+
+    int iStdout = silenceStdout();
+
+    for(qint32 i = 0; i < numReads; ++i)
+    {
+        fiff_int_t offset = vecOffsets[i];
+        fiff_int_t from = raw.first_samp + offset;
+
+        timer.start();
+        readRawSegmentBaseline(raw, dataBaseline, from, from + iWindow - 1);
+        vecBaseline.push_back(timer.nsecsElapsed() / 1000000.0);
+
+        timer.start();
+        raw.read_raw_segment(data, times, from, from + iWindow - 1);
+        double dTime = timer.nsecsElapsed() / 1000000.0;
+
+        vecAll.push_back(dTime);
+        if(offset < iRange / 3)
+            vecBegin.push_back(dTime);
+        else if(offset < 2 * iRange / 3)
+            vecMiddle.push_back(dTime);
+        else
+            vecEnd.push_back(dTime);
+
+        if(data.rows() == dataBaseline.rows() && data.cols() == dataBaseline.cols())
+            dMaxDiff = std::max(dMaxDiff, (data - dataBaseline).cwiseAbs().maxCoeff() / std::max(dataBaseline.cwiseAbs().maxCoeff(), std::numeric_limits<double>::min()));
+        else
+            dMaxDiff = std::numeric_limits<double>::infinity();
+    }
+
+    restoreStdout(iStdout);
+
+    printf("\nFile %s: %d channels, %d buffers, %.1f s, window %.3f s\n", t_fileRaw.fileName().toUtf8().constData(),
+           raw.info.nchan, raw.rawdir.size(), (raw.last_samp - raw.first_samp + 1)/raw.info.sfreq, fWindow);
+    printPercentiles("baseline", vecBaseline);
+    printPercentiles("indexed", vecAll);
+    printPercentiles("first third", vecBegin);
+    printPercentiles("mid third", vecMiddle);
+    printPercentiles("last third", vecEnd);
+
+    std::vector<double> vecSpeedup(numReads);
+    for(qint32 i = 0; i < numReads; ++i)
+        vecSpeedup[i] = vecAll[i] > 0.0 ? vecBaseline[i] / vecAll[i] : 0.0;
+    std::sort(vecSpeedup.begin(), vecSpeedup.end());
+    if(numReads > 0)
+        printf("median speedup %.2fx, max relative deviation from baseline %g\n", vecSpeedup[numReads/2], dMaxDiff);
+
+    if(dMaxDiff > 1e-12)
+    {
+        printf("Indexed reader differs from the baseline\n");
+        return 1;
+    }
+
+    //
+    // Check that the memory mapped read path is taken and reads the same data as the tag based path
+    //
+    fiff_int_t fromCheck = raw.first_samp + iRange / 2;
+    MatrixXd dataTag, dataMapped;
+    raw.read_raw_segment(dataTag, times, fromCheck, fromCheck + iWindow - 1);
+
+    if(!raw.file->map_file() || !raw.file->is_mapped())
+    {
+        printf("Mapping %s failed\n", t_fileRaw.fileName().toUtf8().constData());
+        return 1;
+    }
+    for(qint32 k = 0; k < raw.rawdir.size(); ++k)
+    {
+        const FiffRawDir& t_rawDir = raw.rawdir[k];
+        if(t_rawDir.ent.kind != -1 && !raw.file->mapped_data(t_rawDir.ent.pos, FIFFC_DATA_OFFSET + t_rawDir.ent.size))
+        {
+            printf("Raw buffer %d is not accessible in the mapped file\n", k);
+            return 1;
+        }
+    }
+
+    raw.read_raw_segment(dataMapped, times, fromCheck, fromCheck + iWindow - 1);
+    raw.file->unmap_file();
+
+    if(dataMapped.rows() != dataTag.rows() || dataMapped.cols() != dataTag.cols() || dataMapped != dataTag)
+    {
+        printf("Mapped and tag based reads differ\n");
+        return 1;
+    }
+    printf("mapped read path verified\n");
+
+    return 0;
+}
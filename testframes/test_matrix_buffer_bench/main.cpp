@@ -0,0 +1,246 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Compares throughput and latency of the CircularMatrixBuffer and the LockFreeCircularMatrixBuffer.
+*           One producer pushes 400 channel blocks paced at 1 kHz and 5 kHz sampling, one consumer pops them.
+*           Additionally the unpaced throughput is measured.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <generics/circularmatrixbuffer.h>
+#include <generics/lockfreecircularmatrixbuffer.h>
+
+#include <algorithm>
+#include <vector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBUFFER;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Pops a matrix, either by copying or, if supported by the buffer, via the zero-copy peek/commit API.
+*/
+template<typename BufferType>
+inline double consume(BufferType& buffer, MatrixXd& matTmp, bool bPeek)
+{
+    Q_UNUSED(bPeek);
+    matTmp = buffer.pop();
+    return matTmp(0,0);
+}
+
+template<>
+inline double consume(LockFreeCircularMatrixBuffer<double>& buffer, MatrixXd& matTmp, bool bPeek)
+{
+    if(bPeek)
+    {
+        double dValue = buffer.peekPop()(0,0);
+        buffer.commitPop();
+        return dValue;
+    }
+
+    buffer.pop(matTmp);
+    return matTmp(0,0);
+}
+
+
+//*************************************************************************************************************
+/**
+* Runs one producer and one consumer on the buffer and prints the achieved throughput and the latency percentiles
+* between push and pop.
+*
+* @param [in] p_sLabel      label of the printed line
+* @param [in] buffer        the buffer to test
+* @param [in] iNumBlocks    number of blocks to transfer
+* @param [in] dPeriodNs     pacing of the producer in ns, 0 pushes as fast as possible
+* @param [in] bPeek         use the zero-copy API for popping when available
+*/
+template<typename BufferType>
+void runBenchmark(const char* p_sLabel, BufferType& buffer, qint32 iNumBlocks, double dPeriodNs, bool bPeek = false)
+{
+    std::vector<qint64> vecPushTime(iNumBlocks), vecPopTime(iNumBlocks);
+    MatrixXd matBlock = MatrixXd::Random(buffer.rows(), buffer.cols());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFuture<void> producer = QtConcurrent::run([&]() {
+        for(qint32 i = 0; i < iNumBlocks; ++i)
+        {
+            if(dPeriodNs > 0)
+                while(timer.nsecsElapsed() < (qint64)(i * dPeriodNs))
+                    QThread::yieldCurrentThread();
+
+            matBlock(0,0) = i;
+            vecPushTime[i] = timer.nsecsElapsed();
+            buffer.push(&matBlock);
+        }
+    });
+
+    MatrixXd matTmp(buffer.rows(), buffer.cols());
+    qint32 iErrors = 0;
+    for(qint32 i = 0; i < iNumBlocks; ++i)
+    {
+        if(consume(buffer, matTmp, bPeek) != i)
+            ++iErrors;
+        vecPopTime[i] = timer.nsecsElapsed();
+    }
+    double dTotalSec = timer.nsecsElapsed() / 1e9;
+
+    producer.waitForFinished();
+
+    std::vector<double> vecLatency(iNumBlocks);
+    for(qint32 i = 0; i < iNumBlocks; ++i)
+        vecLatency[i] = (vecPopTime[i] - vecPushTime[i]) / 1000.0;
+    std::sort(vecLatency.begin(), vecLatency.end());
+
+    size_t n = vecLatency.size();
+    printf("%-28s %9.0f blocks/s | latency us p50 %8.1f p99 %8.1f p99.9 %8.1f max %8.1f | errors %d\n", p_sLabel,
+           iNumBlocks / dTotalSec, vecLatency[n*50/100], vecLatency[n*99/100], vecLatency[std::min(n-1, n*999/1000)], vecLatency[n-1], iErrors);
+}
+
+
+//*************************************************************************************************************
+/**
+* Runs all buffer variants with the given setup.
+*/
+void runAll(quint32 uiNumChannels, quint32 uiBlockSize, quint32 uiNumSlots, qint32 iNumBlocks, double dPeriodNs)
+{
+    CircularMatrixBuffer<double> semaphoreBuffer(uiNumSlots, uiNumChannels, uiBlockSize);
+    runBenchmark("semaphore", semaphoreBuffer, iNumBlocks, dPeriodNs);
+
+    LockFreeCircularMatrixBuffer<double> spinBuffer(uiNumSlots, uiNumChannels, uiBlockSize, LockFreeCircularMatrixBuffer<double>::Spin);
+    runBenchmark("lock-free spin", spinBuffer, iNumBlocks, dPeriodNs);
+
+    LockFreeCircularMatrixBuffer<double> yieldBuffer(uiNumSlots, uiNumChannels, uiBlockSize, LockFreeCircularMatrixBuffer<double>::Yield);
+    runBenchmark("lock-free yield", yieldBuffer, iNumBlocks, dPeriodNs);
+
+    LockFreeCircularMatrixBuffer<double> blockBuffer(uiNumSlots, uiNumChannels, uiBlockSize, LockFreeCircularMatrixBuffer<double>::Block);
+    runBenchmark("lock-free block", blockBuffer, iNumBlocks, dPeriodNs);
+
+    LockFreeCircularMatrixBuffer<double> peekBuffer(uiNumSlots, uiNumChannels, uiBlockSize, LockFreeCircularMatrixBuffer<double>::Block);
+    runBenchmark("lock-free block peek/commit", peekBuffer, iNumBlocks, dPeriodNs, true);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Matrix Buffer Benchmark");
+    QCoreApplication::setApplicationVersion("Revision 1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Matrix Buffer Benchmark");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption channelsOption(QStringList() << "c" << "channels",
+            QCoreApplication::translate("main", "The <number> of channels."),
+            QCoreApplication::translate("main", "number"),
+            "400");
+    parser.addOption(channelsOption);
+
+    QCommandLineOption blockSizeOption(QStringList() << "b" << "block-size",
+            QCoreApplication::translate("main", "The number of <samples> per block."),
+            QCoreApplication::translate("main", "samples"),
+            "10");
+    parser.addOption(blockSizeOption);
+
+    QCommandLineOption durationOption(QStringList() << "d" << "duration",
+            QCoreApplication::translate("main", "The <duration> in seconds of the paced runs."),
+            QCoreApplication::translate("main", "duration"),
+            "5");
+    parser.addOption(durationOption);
+
+    parser.process(app);
+
+    quint32 uiNumChannels = parser.value(channelsOption).toUInt();
+    quint32 uiBlockSize = parser.value(blockSizeOption).toUInt();
+    double dDuration = parser.value(durationOption).toDouble();
+    quint32 uiNumSlots = 16;
+
+    QList<double> lSampleRates;
+    lSampleRates << 1000.0 << 5000.0;
+
+    for(qint32 i = 0; i < lSampleRates.size(); ++i)
+    {
+        double dBlocksPerSec = lSampleRates[i] / uiBlockSize;
+        printf("\n%d channels, %d samples per block, paced at %.0f Hz sampling (%.1f blocks/s)\n", uiNumChannels, uiBlockSize, lSampleRates[i], dBlocksPerSec);
+        runAll(uiNumChannels, uiBlockSize, uiNumSlots, (qint32)(dDuration * dBlocksPerSec), 1e9 / dBlocksPerSec);
+    }
+
+    printf("\n%d channels, %d samples per block, unpaced\n", uiNumChannels, uiBlockSize);
+    runAll(uiNumChannels, uiBlockSize, uiNumSlots, 20000, 0);
+
+    return 0;
+}
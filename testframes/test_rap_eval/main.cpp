@@ -184,6 +184,18 @@ int main(int argc, char *argv[])
             "0.2");
     parser.addOption(tMaxOption);
 
+    // Cluster size
+    QCommandLineOption clusterSizeOption(QStringList() << "cs" << "cluster-size",
+            QCoreApplication::translate("main", "The number of sources per cluster <size> of the clustered forward solution."),
+            QCoreApplication::translate("main", "size"),
+            "20");
+    parser.addOption(clusterSizeOption);
+
+    // Benchmark
+    QCommandLineOption benchOption(QStringList() << "bench" << "benchmark",
+            QCoreApplication::translate("main", "Compare the per iteration time of the dipole pair scan kernels and exit."));
+    parser.addOption(benchOption);
+
     // Process the actual command line arguments given by the user
     parser.process(app);
 
@@ -223,6 +235,11 @@ int main(int argc, char *argv[])
     float tmax = (float)parser.value(tMaxOption).toFloat();
     qDebug() << "tMax" << tmax;
 
+    qint32 iClusterSize = (qint32)parser.value(clusterSizeOption).toInt();
+    qDebug() << "Cluster Size" << iClusterSize;
+
+    bool bBenchmark = parser.isSet(benchOption);
+
     QFile t_fileFwd(sFwdName);
     //
     // Load data
@@ -239,7 +256,7 @@ int main(int argc, char *argv[])
     //
     // Cluster forward solution;
     //
-    MNEForwardSolution t_clusteredFwd = t_Fwd.cluster_forward_solution(t_annotationSet, 20);//40);
+    MNEForwardSolution t_clusteredFwd = t_Fwd.cluster_forward_solution(t_annotationSet, iClusterSize);//40);
 
     QFile t_fileRaw(sRawName);
 
@@ -510,6 +527,41 @@ int main(int argc, char *argv[])
     //
     RapMusic t_rapMusic(t_clusteredFwd, false, numDipolePairs);
 
+    //
+    // Benchmark the dipole pair scan kernels on the average of all epochs
+    //
+    if(bBenchmark)
+    {
+        FiffEvoked evoked = data.average(raw.info, tmin*raw.info.sfreq, floor(tmax*raw.info.sfreq + 0.5));
+        FiffEvoked pickedEvoked = evoked.pick_channels(t_Fwd.info.ch_names);
+
+        printf("Benchmark on %d sources and %d channels\n", t_clusteredFwd.nsource, (qint32)pickedEvoked.data.rows());
+
+        QList<RapMusic::ScanMode> qListModes;
+        qListModes << RapMusic::ScanSVD << RapMusic::ScanGram << RapMusic::ScanGramFloat;
+        QStringList qListModeNames;
+        qListModeNames << "SVD" << "Gram (double)" << "Gram (float)";
+
+        QElapsedTimer timer;
+        for(qint32 i = 0; i < qListModes.size(); ++i)
+        {
+            QList< DipolePair<double> > t_RapDipoles;
+            t_rapMusic.setScanMode(qListModes[i]);
+
+            timer.start();
+            t_rapMusic.calculateInverse(pickedEvoked.data, t_RapDipoles);
+            qint64 iElapsedMs = timer.elapsed();
+
+            if(t_RapDipoles.isEmpty())
+                continue;
+
+            printf("%s: %.1f ms per iteration; first pair %d - %d; correlation %f\n", qListModeNames[i].toLatin1().constData(),
+                   (double)iElapsedMs / t_RapDipoles.size(), t_RapDipoles[0].m_iIdx1, t_RapDipoles[0].m_iIdx2, t_RapDipoles[0].m_vCorrelation);
+        }
+
+        return 0;
+    }
+
 
 
 
@@ -0,0 +1,256 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   MNE-CPP authors
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, MNE-CPP authors. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Measures the time to render one frame of the real-time multi sample array display offscreen for an
+*           increasing number of channels, once drawing every sample and once drawing from the min/max pyramid.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <scDisp/helpers/realtimemultisamplearraymodel.h>
+#include <scDisp/helpers/realtimemultisamplearraydelegate.h>
+#include <scMeas/realtimesamplearraychinfo.h>
+#include <fiff/fiff_info.h>
+
+#include <algorithm>
+#include <vector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QStyleOptionViewItem>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCDISPLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Renders all rows of the model into the image the same way the table view of the RealTimeMultiSampleArrayWidget does.
+*
+* @param [in] model         the model holding the data
+* @param [in] delegate      the delegate which draws the rows
+* @param [in] image         the image to draw into
+* @param [in] iRowHeight    height of one row in pixels
+*/
+void renderFrame(const RealTimeMultiSampleArrayModel& model, const RealTimeMultiSampleArrayDelegate& delegate, QImage& image, int iRowHeight)
+{
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+
+    for(int r = 0; r < model.rowCount(); ++r) {
+        QStyleOptionViewItem option;
+        option.rect = QRect(0, r*iRowHeight, image.width(), iRowHeight);
+        delegate.paint(&painter, option, model.index(r,1));
+    }
+}
+
+
+//*************************************************************************************************************
+/**
+* Fills a model with a full window of simulated gradiometer data and returns the median frame time of both drawing modes.
+*
+* @param [in] iNumChannels  number of channels
+* @param [in] dSFreq        sampling frequency in Hz
+* @param [in] iT            displayed time window in seconds
+* @param [in] iWidth        width of the plot in pixels
+* @param [in] iRowHeight    height of one row in pixels
+* @param [in] iNumFrames    number of frames to render per mode
+*/
+void runBenchmark(int iNumChannels, double dSFreq, int iT, int iWidth, int iRowHeight, int iNumFrames)
+{
+    FiffInfo::SPtr pFiffInfo(new FiffInfo());
+    QList<RealTimeSampleArrayChInfo> qListChInfo;
+
+    for(int i = 0; i < iNumChannels; ++i) {
+        FiffChInfo chInfo;
+        chInfo.ch_name = QString("MEG %1").arg(i, 4, 10, QChar('0'));
+        chInfo.kind = FIFFV_MEG_CH;
+        chInfo.unit = FIFF_UNIT_T_M;
+
+        pFiffInfo->chs.append(chInfo);
+        pFiffInfo->ch_names.append(chInfo.ch_name);
+
+        RealTimeSampleArrayChInfo rtChInfo;
+        rtChInfo.setChannelName(chInfo.ch_name);
+        rtChInfo.setKind(chInfo.kind);
+        rtChInfo.setUnit(chInfo.unit);
+        qListChInfo.append(rtChInfo);
+    }
+
+    pFiffInfo->nchan = iNumChannels;
+    pFiffInfo->sfreq = dSFreq;
+
+    RealTimeMultiSampleArrayModel model;
+    model.setFiffInfo(pFiffInfo);
+    model.setChannelInfo(qListChInfo);
+    model.setSamplingInfo(dSFreq, iT);
+
+    //Stream 1.5 windows of noisy 10 Hz oscillations in blocks of 100 ms
+    int iBlockSize = (int)(dSFreq / 10);
+    int iNumBlocks = (int)(1.5 * model.getMaxSamples() / iBlockSize);
+
+    for(int b = 0; b < iNumBlocks; ++b) {
+        MatrixXd matBlock = MatrixXd::Random(iNumChannels, iBlockSize) * 2e-11;
+
+        for(int j = 0; j < iBlockSize; ++j)
+            matBlock.col(j).array() += 5e-11 * sin(2 * M_PI * 10.0 * (b * iBlockSize + j) / dSFreq);
+
+        model.addData(QList<MatrixXd>() << matBlock);
+    }
+
+    RealTimeMultiSampleArrayDelegate delegate;
+    delegate.initPainterPaths(&model);
+
+    QImage image(iWidth, iNumChannels * iRowHeight, QImage::Format_ARGB32_Premultiplied);
+
+    double dMedianMs[2];
+
+    for(int iMode = 0; iMode < 2; ++iMode) {
+        delegate.setMinMaxPyramidEnabled(iMode == 1);
+
+        //Warm up
+        renderFrame(model, delegate, image, iRowHeight);
+
+        std::vector<double> vecFrameMs(iNumFrames);
+        QElapsedTimer timer;
+
+        for(int f = 0; f < iNumFrames; ++f) {
+            timer.start();
+            renderFrame(model, delegate, image, iRowHeight);
+            vecFrameMs[f] = timer.nsecsElapsed() / 1e6;
+        }
+
+        std::sort(vecFrameMs.begin(), vecFrameMs.end());
+        dMedianMs[iMode] = vecFrameMs[vecFrameMs.size()/2];
+    }
+
+    printf("%8d %10d %18.2f %18.2f %8.1fx\n", iNumChannels, model.getMaxSamples(), dMedianMs[0], dMedianMs[1], dMedianMs[0] / dMedianMs[1]);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    //Render without a display
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("Real-Time Multi Sample Array Render Benchmark");
+    QApplication::setApplicationVersion("Revision 1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Real-Time Multi Sample Array Render Benchmark");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption sFreqOption(QStringList() << "s" << "sfreq",
+            QCoreApplication::translate("main", "The sampling <frequency> in Hz."),
+            QCoreApplication::translate("main", "frequency"),
+            "1000");
+    parser.addOption(sFreqOption);
+
+    QCommandLineOption windowOption(QStringList() << "t" << "window",
+            QCoreApplication::translate("main", "The displayed time <window> in seconds."),
+            QCoreApplication::translate("main", "window"),
+            "10");
+    parser.addOption(windowOption);
+
+    QCommandLineOption widthOption(QStringList() << "w" << "width",
+            QCoreApplication::translate("main", "The plot <width> in pixels."),
+            QCoreApplication::translate("main", "width"),
+            "1200");
+    parser.addOption(widthOption);
+
+    QCommandLineOption framesOption(QStringList() << "f" << "frames",
+            QCoreApplication::translate("main", "The <number> of frames to render per measurement."),
+            QCoreApplication::translate("main", "number"),
+            "10");
+    parser.addOption(framesOption);
+
+    parser.process(app);
+
+    double dSFreq = parser.value(sFreqOption).toDouble();
+    int iT = parser.value(windowOption).toInt();
+    int iWidth = parser.value(widthOption).toInt();
+    int iNumFrames = parser.value(framesOption).toInt();
+    int iRowHeight = 20;
+
+    QList<int> lNumChannels;
+    lNumChannels << 32 << 64 << 128 << 306 << 400;
+
+    printf("%8s %10s %18s %18s %9s\n", "channels", "samples", "all samples [ms]", "min/max [ms]", "speedup");
+
+    for(int i = 0; i < lNumChannels.size(); ++i)
+        runBenchmark(lNumChannels[i], dSFreq, iT, iWidth, iRowHeight, iNumFrames);
+
+    return 0;
+}
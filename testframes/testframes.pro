@@ -41,6 +41,10 @@ SUBDIRS += \
     test_codecov \
     test_fiff_rwr \
     test_dipole_fit \
+    test_fiff_raw_seek \
+    test_matrix_buffer_bench \
+    test_rtmsa_render_bench \
+    test_rap_eval \
 #    test_mne_libs \
 #    test_mne_rt \
 #    mne_x_plugin_com \
@@ -53,7 +57,6 @@ SUBDIRS += \
 #        test_mne_cluster_eval \
 #        test_rap_cluster_eval \
 #        test_rtc_eval \
-#        test_rap_eval \
 #        test_orig_rap_cluster_eval \
 #        mne_3d_widget \
 #        test_mne_cluster \